@@ -2517,11 +2517,11 @@ void actInit(bool bSaveLoad) {
                 pXSprite->state = 0;
                 break;
             case kThingBloodChunks: {
-                SEQINST *pInst = GetInstance(3, pSprite->extra);
-                if (pInst && pInst->at13) {
-                    DICTNODE *hSeq = gSysRes.Lookup(pInst->at8, "SEQ");
+                if (seqGetStatus(3, pSprite->extra) >= 0) {
+                    int nSeq = seqGetID(3, pSprite->extra);
+                    DICTNODE *hSeq = gSysRes.Lookup(nSeq, "SEQ");
                     if (!hSeq) break;
-                    seqSpawn(pInst->at8, 3, pSprite->extra);
+                    seqSpawn(nSeq, 3, pSprite->extra);
                 }
                 break;
             }
@@ -2698,10 +2698,12 @@ void sub_2A620(int nSprite, int x, int y, int z, int nSector, int nDist, int a7,
     gAffectedSectors[0] = 0;
     gAffectedXWalls[0] = 0;
     GetClosestSpriteSectors(nSector, x, y, nDist, gAffectedSectors, va0, gAffectedXWalls);
+    SectorStatIterator itDude(kStatDude, gAffectedSectors);
+    SectorStatIterator itThing(kStatThing, gAffectedSectors);
     nDist <<= 4;
     if (a10 & 2)
     {
-        for (int i = headspritestat[kStatDude]; i >= 0; i = nextspritestat[i])
+        for (int i = itDude.NextIndex(); i >= 0; i = itDude.NextIndex())
         {
             if (i != nSprite || (a10 & 1))
             {
@@ -2735,7 +2737,7 @@ void sub_2A620(int nSprite, int x, int y, int z, int nSector, int nDist, int a7,
     }
     if (a10 & 4)
     {
-        for (int i = headspritestat[kStatThing]; i >= 0; i = nextspritestat[i])
+        for (int i = itThing.NextIndex(); i >= 0; i = itThing.NextIndex())
         {
             spritetype *pSprite2 = &sprite[i];
 
@@ -5708,6 +5710,8 @@ void actProcessSprites(void)
         #endif
         
         GetClosestSpriteSectors(nSector, x, y, radius, gAffectedSectors, v24c, gAffectedXWalls);
+        SectorStatIterator itDude(kStatDude, gAffectedSectors);
+        SectorStatIterator itThing(kStatThing, gAffectedSectors);
         
         for (int i = 0; i < kMaxXWalls; i++)
         {
@@ -5718,7 +5722,7 @@ void actProcessSprites(void)
             trTriggerWall(nWall, pXWall, kCmdWallImpact);
         }
         
-        for (int nSprite2 = headspritestat[kStatDude]; nSprite2 >= 0; nSprite2 = nextspritestat[nSprite2])
+        for (int nSprite2 = itDude.NextIndex(); nSprite2 >= 0; nSprite2 = itDude.NextIndex())
         {
             spritetype *pDude = &sprite[nSprite2];
 
@@ -5747,7 +5751,7 @@ void actProcessSprites(void)
             }
         }
         
-        for (int nSprite2 = headspritestat[kStatThing]; nSprite2 >= 0; nSprite2 = nextspritestat[nSprite2])
+        for (int nSprite2 = itThing.NextIndex(); nSprite2 >= 0; nSprite2 = itThing.NextIndex())
         {
             spritetype *pThing = &sprite[nSprite2];
 
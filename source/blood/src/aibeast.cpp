@@ -117,6 +117,8 @@ static void StompSeqCallback(int, int nXSprite)
     gAffectedSectors[0] = -1;
     gAffectedXWalls[0] = -1;
     GetClosestSpriteSectors(nSector, x, y, vc, gAffectedSectors, vb8, gAffectedXWalls);
+    SectorStatIterator itDude(kStatDude, gAffectedSectors);
+    SectorStatIterator itThing(kStatThing, gAffectedSectors);
     char v4 = 0;
     int v34 = -1;
     int hit = HitScan(pSprite, pSprite->z, dx, dy, 0, CLIPMASK1, 0);
@@ -127,7 +129,7 @@ static void StompSeqCallback(int, int nXSprite)
             v4 = 0;
     }
     vc <<= 4;
-    for (int nSprite2 = headspritestat[kStatDude]; nSprite2 >= 0; nSprite2 = nextspritestat[nSprite2])
+    for (int nSprite2 = itDude.NextIndex(); nSprite2 >= 0; nSprite2 = itDude.NextIndex())
     {
         if (nSprite != nSprite2 || v4)
         {
@@ -163,7 +165,7 @@ static void StompSeqCallback(int, int nXSprite)
             }
         }
     }
-    for (int nSprite2 = headspritestat[kStatThing]; nSprite2 >= 0; nSprite2 = nextspritestat[nSprite2])
+    for (int nSprite2 = itThing.NextIndex(); nSprite2 >= 0; nSprite2 = itThing.NextIndex())
     {
         spritetype *pSprite2 = &sprite[nSprite2];
         if (pSprite2->flags&32)
@@ -70,6 +70,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "gamecontrol.h"
 #include "m_argv.h"
 #include "statistics.h"
+#include "timedemo.h"
 #include "menu/menu.h"
 #include "sound/s_soundinternal.h"
 #include "nnexts.h"
@@ -304,7 +305,7 @@ void PreloadTiles(void)
         if (wall[i].overpicnum >= 0)
             tilePrecacheTile(wall[i].overpicnum, 0);
     }
-    for (int i = 0; i < kMaxSprites; i++)
+    for (int i = dbNextSprite(-1); i >= 0; i = dbNextSprite(i))
     {
         if (sprite[i].statnum < kMaxStatus)
         {
@@ -569,7 +570,7 @@ void StartLevel(GAMEOPTIONS *gameOptions)
     automapping = 1;
   
     int modernTypesErased = 0;
-    for (int i = 0; i < kMaxSprites; i++)
+    for (int i = dbNextSprite(-1); i >= 0; i = dbNextSprite(i))
     {
         spritetype *pSprite = &sprite[i];
         if (pSprite->statnum < kMaxStatus && pSprite->extra > 0) {
@@ -1145,7 +1146,12 @@ RESTART:
         goto RESTART;
     }
     UpdateNetworkMenus();
-    if (!gDemo.at0 && gDemo.at59ef > 0 && gGameOptions.nGameType == 0 && !bNoDemo && demo_playloop)
+    if (TimeDemo_Active())
+    {
+        if (!gDemo.SetupPlayback(*TimeDemo_File() ? TimeDemo_File() : NULL))
+            ThrowError("Unable to play demo %s", TimeDemo_File());
+    }
+    else if (!gDemo.at0 && gDemo.at59ef > 0 && gGameOptions.nGameType == 0 && !bNoDemo && demo_playloop)
         gDemo.SetupPlayback(NULL);
     gQuitGame = 0;
     gRestartGame = 0;
@@ -1153,7 +1159,7 @@ RESTART:
     {
         inputState.ClearAllInput();
     }
-    else if (gDemo.at1 && !bAddUserMap && !bNoDemo && demo_playloop)
+    else if (gDemo.at1 && ((!bAddUserMap && !bNoDemo && demo_playloop) || TimeDemo_Active()))
         gDemo.Playback();
     if (gDemo.at59ef > 0)
         M_ClearMenus();
@@ -34,7 +34,7 @@ BEGIN_BLD_NS
 
 #define BLOODWIDESCREENDEF "blood_widescreen.def"
 
-#define BYTEVERSION 103
+#define BYTEVERSION 104
 #define EXEVERSION 101
 
 void _SetErrorLoc(const char *pzFile, int nLine);
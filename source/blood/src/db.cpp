@@ -28,6 +28,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common_game.h"
 #include "m_crc32.h"
 #include "md4.h"
+#include "gamecvars.h"
+#include "i_specialpaths.h"
+#include "version.h"
 
 //#include "actor.h"
 #include "globals.h"
@@ -40,6 +43,43 @@ BEGIN_BLD_NS
 
 unsigned short gStatCount[kMaxStatus + 1];
 
+unsigned int gStatSerial[kMaxSprites];
+unsigned int nStatSerial;
+
+// One bit per sprite, set if its statnum is below kMaxStatus.
+static uint64_t nSpriteUsed[kMaxSprites / 64];
+
+static inline void SetSpriteUsed(int nSprite, bool bUsed)
+{
+    uint64_t nBit = uint64_t(1) << (nSprite & 63);
+    if (bUsed)
+        nSpriteUsed[nSprite >> 6] |= nBit;
+    else
+        nSpriteUsed[nSprite >> 6] &= ~nBit;
+}
+
+int dbNextSprite(int nSprite)
+{
+    nSprite++;
+    int nWord = nSprite >> 6;
+    if (nWord >= kMaxSprites / 64)
+        return -1;
+    uint64_t nBits = nSpriteUsed[nWord] >> (nSprite & 63);
+    while (!nBits)
+    {
+        if (++nWord >= kMaxSprites / 64)
+            return -1;
+        nBits = nSpriteUsed[nWord];
+        nSprite = nWord << 6;
+    }
+    while (!(nBits & 1))
+    {
+        nBits >>= 1;
+        nSprite++;
+    }
+    return nSprite;
+}
+
 XSPRITE xsprite[kMaxXSprites];
 XSECTOR xsector[kMaxXSectors];
 XWALL xwall[kMaxXWalls];
@@ -58,7 +98,28 @@ int gVisibility;
 
 void dbCrypt(char *pPtr, int nLength, int nKey)
 {
-    for (int i = 0; i < nLength; i++)
+    int i = 0;
+    if (nLength >= 8)
+    {
+        // Only the low byte of the key matters, and it goes up by one for each
+        // byte, so eight bytes can be done at once by adding 8 to every lane.
+        uint8_t keyBytes[8];
+        for (int j = 0; j < 8; j++)
+            keyBytes[j] = nKey + j;
+        uint64_t key;
+        memcpy(&key, keyBytes, 8);
+        const uint64_t nStep = 0x0808080808080808ull, nHigh = 0x8080808080808080ull;
+        for (; i + 8 <= nLength; i += 8)
+        {
+            uint64_t value;
+            memcpy(&value, pPtr + i, 8);
+            value ^= key;
+            memcpy(pPtr + i, &value, 8);
+            key = ((key & ~nHigh) + nStep) ^ (key & nHigh);
+        }
+        nKey += i;
+    }
+    for (; i < nLength; i++)
     {
         pPtr[i] = pPtr[i] ^ nKey;
         nKey++;
@@ -148,6 +209,8 @@ void InsertSpriteStat(int nSprite, int nStat)
         headspritestat[nStat] = nSprite;
     }
     sprite[nSprite].statnum = nStat;
+    SetSpriteUsed(nSprite, nStat < kMaxStatus);
+    gStatSerial[nSprite] = ++nStatSerial;
     gStatCount[nStat]++;
 }
 
@@ -191,10 +254,27 @@ void qinitspritelists(void) // Replace
         sprite[i].index = -1;
         InsertSpriteStat(i, kMaxStatus);
     }
+    // The sprites past the vanilla limit are left alone, statnum and all.
+    for (int i = nMaxSprites; i < kMaxSprites; i++)
+        SetSpriteUsed(i, sprite[i].statnum < kMaxStatus);
     memset(gStatCount, 0, sizeof(gStatCount));
     Numsprites = 0;
 }
 
+// The serials and the set of used sprites are not saved, so they have to be
+// set up again after the sprites were restored from a savegame.
+void dbRebuildStatInfo(void)
+{
+    for (int i = 0; i < kMaxSprites; i++)
+        SetSpriteUsed(i, sprite[i].statnum < kMaxStatus);
+    nStatSerial = 0;
+    for (int nStat = 0; nStat <= kMaxStatus; nStat++)
+    {
+        for (int nSprite = headspritestat[nStat]; nSprite >= 0; nSprite = nextspritestat[nSprite])
+            gStatSerial[nSprite] = ++nStatSerial;
+    }
+}
+
 int InsertSprite(int nSector, int nStat)
 {
     int nSprite = headspritestat[kMaxStatus];
@@ -306,6 +386,75 @@ void InsertFree(unsigned short *pList, int nIndex)
     pList[0] = nIndex;
 }
 
+// The xsprites receiving on each channel. evSend() uses this to find the
+// receivers that were spawned during play and therefore are not in rxBucket.
+// It may contain xsprites whose rxID has since changed, so users have to check.
+static short rxSpriteHead[1024];
+static short rxSpriteNext[kMaxXSprites], rxSpritePrev[kMaxXSprites];
+static short rxSpriteChannel[kMaxXSprites]; // 0 if not linked
+
+static void UnlinkXSpriteRX(int nXSprite)
+{
+    int nRX = rxSpriteChannel[nXSprite];
+    if (!nRX)
+        return;
+    int nNext = rxSpriteNext[nXSprite], nPrev = rxSpritePrev[nXSprite];
+    if (nPrev >= 0)
+        rxSpriteNext[nPrev] = nNext;
+    else
+        rxSpriteHead[nRX] = nNext;
+    if (nNext >= 0)
+        rxSpritePrev[nNext] = nPrev;
+    rxSpriteChannel[nXSprite] = 0;
+}
+
+static void LinkXSpriteRX(int nXSprite, int nRX)
+{
+    dassert(nRX > 0 && nRX < 1024);
+    rxSpriteChannel[nXSprite] = nRX;
+    rxSpritePrev[nXSprite] = -1;
+    rxSpriteNext[nXSprite] = rxSpriteHead[nRX];
+    if (rxSpriteHead[nRX] >= 0)
+        rxSpritePrev[rxSpriteHead[nRX]] = nXSprite;
+    rxSpriteHead[nRX] = nXSprite;
+}
+
+// Everything that changes an xsprite's rxID while the game is running must use this.
+void dbSetXSpriteRX(int nXSprite, int nRX)
+{
+    dassert(nXSprite > 0 && nXSprite < kMaxXSprites);
+    xsprite[nXSprite].rxID = nRX;
+    UnlinkXSpriteRX(nXSprite);
+    if (nRX > 0)
+        LinkXSpriteRX(nXSprite, nRX);
+}
+
+int dbFirstRXSprite(int nRX)
+{
+    if (nRX <= 0 || nRX >= 1024)
+        return -1;
+    return rxSpriteHead[nRX];
+}
+
+int dbNextRXSprite(int nXSprite)
+{
+    return rxSpriteNext[nXSprite];
+}
+
+// For after the xsprites were read from a map or a savegame.
+void dbRebuildRXIndex(void)
+{
+    for (int i = 0; i < 1024; i++)
+        rxSpriteHead[i] = -1;
+    memset(rxSpriteChannel, 0, sizeof(rxSpriteChannel));
+    for (int i = dbNextSprite(-1); i >= 0; i = dbNextSprite(i))
+    {
+        int nXSprite = sprite[i].extra;
+        if (sprite[i].statnum < kMaxStatus && nXSprite > 0 && nXSprite < kMaxXSprites && xsprite[nXSprite].rxID > 0)
+            LinkXSpriteRX(nXSprite, xsprite[nXSprite].rxID);
+    }
+}
+
 unsigned short dbInsertXSprite(int nSprite)
 {
     int nXSprite = nextXSprite[0];
@@ -314,6 +463,7 @@ unsigned short dbInsertXSprite(int nSprite)
     {
         ThrowError("Out of free XSprites");
     }
+    UnlinkXSpriteRX(nXSprite);
     memset(&xsprite[nXSprite], 0, sizeof(XSPRITE));
     if (!bVanilla)
         memset(&gSpriteHit[nXSprite], 0, sizeof(SPRITEHIT));
@@ -326,6 +476,7 @@ void dbDeleteXSprite(int nXSprite)
 {
     dassert(xsprite[nXSprite].reference >= 0);
     dassert(sprite[xsprite[nXSprite].reference].extra == nXSprite);
+    UnlinkXSpriteRX(nXSprite);
     InsertFree(nextXSprite, nXSprite);
     sprite[xsprite[nXSprite].reference].extra = -1;
     xsprite[nXSprite].reference = -1;
@@ -377,14 +528,15 @@ void dbDeleteXSector(int nXSector)
 
 void dbXSpriteClean(void)
 {
-    for (int i = 0; i < kMaxSprites; i++)
+    // InsertSprite() resets extra, so the free sprites can be skipped.
+    for (int i = dbNextSprite(-1); i >= 0; i = dbNextSprite(i))
     {
         int nXSprite = sprite[i].extra;
         if (nXSprite == 0)
         {
             sprite[i].extra = -1;
         }
-        if (sprite[i].statnum < kMaxStatus && nXSprite > 0)
+        if (nXSprite > 0)
         {
             dassert(nXSprite < kMaxXSprites);
             if (xsprite[nXSprite].reference != i)
@@ -408,6 +560,7 @@ void dbXSpriteClean(void)
             }
         }
     }
+    dbRebuildRXIndex();
 }
 
 void dbXWallClean(void)
@@ -536,6 +689,7 @@ void dbInit(void)
     {
         sprite[i].cstat = 128;
     }
+    dbRebuildRXIndex();
 }
 
 void PropagateMarkerReferences(void)
@@ -634,38 +788,15 @@ const int nXSectorSize = 60;
 const int nXSpriteSize = 56;
 const int nXWallSize = 24;
 
-int dbLoadMap(const char *pPath, int *pX, int *pY, int *pZ, short *pAngle, short *pSector, unsigned int *pCRC) {
-    int16_t tpskyoff[256];
-    show2dsector.Zero();
-    memset(show2dwall, 0, sizeof(show2dwall));
-    memset(show2dsprite, 0, sizeof(show2dsprite));
-    #ifdef NOONE_EXTENSIONS
-    gModernMap = false;
-    #endif
-
-#ifdef USE_OPENGL
-    Polymost_prepare_loadboard();
-#endif
-
-	DICTNODE* pNode;
-
-    pNode = gSysRes.Lookup(pPath, "MAP");
-    if (!pNode)
-    {
-        char name2[BMAX_PATH];
-        Bstrncpy(name2, pPath, BMAX_PATH);
-        ChangeExtension(name2, "");
-        pNode = gSysRes.Lookup(name2, "MAP");
-    }
+static bool bMapHeaderCrypted;
 
-    if (!pNode)
-    {
-        initprintf("Error opening map file %s", pPath);
-        return -1;
-    }
+// Reads and decrypts the map lump itself.
+static int dbReadMap(DICTNODE *pNode, int *pX, int *pY, int *pZ, short *pAngle, short *pSector, MAPSIGNATURE &header, unsigned int &nCRC)
+{
+    int16_t tpskyoff[256];
+    bMapHeaderCrypted = false;
     char *pData = (char*)gSysRes.Lock(pNode);
     int nSize = pNode->Size();
-    MAPSIGNATURE header;
     IOBuffer IOBuffer1 = IOBuffer(nSize, pData);
     IOBuffer1.Read(&header, 6);
 #if B_BIG_ENDIAN == 1
@@ -699,6 +830,7 @@ int dbLoadMap(const char *pPath, int *pX, int *pY, int *pZ, short *pAngle, short
     if (mapHeader.at16 != 0 && mapHeader.at16 != 0x7474614d && mapHeader.at16 != 0x4d617474) {
         dbCrypt((char*)&mapHeader, sizeof(mapHeader), 0x7474614d);
         byte_1A76C7 = 1;
+        bMapHeaderCrypted = true;
     }
 
 #if B_BIG_ENDIAN == 1
@@ -1109,7 +1241,6 @@ int dbLoadMap(const char *pPath, int *pX, int *pY, int *pZ, short *pAngle, short
             sprite[i].cstat &= ~0x30;
         }
     }
-    unsigned int nCRC;
     IOBuffer1.Read(&nCRC, 4);
 #if B_BIG_ENDIAN == 1
     nCRC = B_LITTLE32(nCRC);
@@ -1121,9 +1252,301 @@ int dbLoadMap(const char *pPath, int *pX, int *pY, int *pZ, short *pAngle, short
         gSysRes.Unlock(pNode);
         return -1;
     }
+    gSysRes.Unlock(pNode);
+    return 0;
+}
+
+//---------------------------------------------------------------------------
+//
+// Map cache
+//
+// Decrypting and unpacking a map is done once. Afterwards the result is kept
+// in a file named after the map, keyed by the lump's size and the CRC stored
+// at its end, and loaded from there with a single read.
+//
+//---------------------------------------------------------------------------
+
+#define MAP_CACHE_MAGIC "BMCH"
+#define MAP_CACHE_VERSION 1
+
+struct MAPCACHEHEADER
+{
+    char magic[4];
+    int version;
+    unsigned int nSize, nCRC;
+    uint8_t md4[16];
+    MAPSIGNATURE signature;
+    int x, y, z;
+    short ang, sect;
+    short lognumtiles;
+    int8_t tileofs[MAXPSKYTILES];
+    int visibility, songId, parallaxtype, mapRev;
+    int numsectors, numwalls, numsprites;
+    int numxsectors, numxwalls, numxsprites;
+    bool b6, b7, b8, modern;
+    MAPHEADER2 header2;
+};
+
+// The cached data is the engine's and the game's native structs, so a cache
+// is only good for the build that wrote it.
+static FString dbMapCacheBuildStamp(void)
+{
+    return FStringf("%s %s %s %d %d %d %d %d %d", GetGitHash(), __DATE__, __TIME__, (int)sizeof(MAPCACHEHEADER),
+        (int)sizeof(sectortype), (int)sizeof(walltype), (int)sizeof(spritetype), (int)sizeof(XSECTOR), (int)(sizeof(XWALL) + sizeof(XSPRITE)));
+}
+
+static FString dbMapCacheFileName(DICTNODE *pNode)
+{
+    FString key = pNode->FullName();
+    return FStringf("%s/bloodmap_%08x.bin", M_GetAppDataPath(true).GetChars(), Bcrc32(key.GetChars(), key.Len(), 0));
+}
+
+// Gets the CRC at the end of the map without reading all of it, if the lump allows.
+static bool dbGetMapCRC(DICTNODE *pNode, unsigned int *pCRC)
+{
+    int nSize = pNode->Size();
+    if (nSize < 4)
+        return false;
+    FileReader *pReader = pNode->GetReader();
+    if (pReader)
+    {
+        pReader->Seek(nSize - 4, FileReader::SeekCur);
+        if (pReader->Read(pCRC, 4) != 4)
+            return false;
+    }
+    else
+    {
+        char *pData = (char*)gSysRes.Lock(pNode);
+        memcpy(pCRC, pData + nSize - 4, 4);
+        gSysRes.Unlock(pNode);
+    }
+    *pCRC = B_LITTLE32(*pCRC);
+    return true;
+}
+
+static bool dbReadMapCache(DICTNODE *pNode, int *pX, int *pY, int *pZ, short *pAngle, short *pSector, MAPSIGNATURE &signature, unsigned int &nCRC)
+{
+    if (!map_cache)
+        return false;
+    unsigned int nFileCRC;
+    if (!dbGetMapCRC(pNode, &nFileCRC))
+        return false;
+    FileReader fr;
+    if (!fr.OpenFile(dbMapCacheFileName(pNode)))
+        return false;
+    TArray<uint8_t> buffer = fr.Read();
+    fr.Close();
+
+    // Check everything before touching any of the map data.
+    FString stamp = dbMapCacheBuildStamp();
+    unsigned int nPos = stamp.Len();
+    if (buffer.Size() < nPos + sizeof(MAPCACHEHEADER) + 4 || memcmp(buffer.Data(), stamp.GetChars(), nPos))
+        return false;
+    MAPCACHEHEADER header;
+    memcpy(&header, &buffer[nPos], sizeof(header));
+    nPos += sizeof(header);
+    if (memcmp(header.magic, MAP_CACHE_MAGIC, 4) || header.version != MAP_CACHE_VERSION || header.nSize != pNode->Size() || header.nCRC != nFileCRC)
+        return false;
+    if ((unsigned)header.numsectors > kMaxSectors || (unsigned)header.numwalls > kMaxWalls || (unsigned)header.numsprites > kMaxSprites)
+        return false;
+    if ((unsigned)header.numxsectors >= kMaxXSectors || (unsigned)header.numxwalls >= kMaxXWalls || (unsigned)header.numxsprites >= kMaxXSprites)
+        return false;
+    unsigned int nExpected = nPos + header.numsectors * (sizeof(sectortype) + 1) + header.numwalls * sizeof(walltype)
+        + header.numsprites * (sizeof(spritetype) + 1) + header.numxsectors * sizeof(XSECTOR) + header.numxwalls * sizeof(XWALL)
+        + header.numxsprites * sizeof(XSPRITE) + 4;
+    if (buffer.Size() != nExpected || memcmp(&buffer[nExpected - 4], MAP_CACHE_MAGIC, 4))
+        return false;
+
+    signature = header.signature;
+    nCRC = header.nCRC;
+    memcpy(g_loadedMapHack.md4, header.md4, 16);
+    byte_1A76C8 = header.b8;
+    if (header.b7)
+        byte_1A76C7 = 1;
+    byte_1A76C6 = header.b6;
+    #ifdef NOONE_EXTENSIONS
+    gModernMap = header.modern;
+    #endif
+
+    psky_t *pSky = tileSetupSky(0);
+    pSky->horizfrac = 65536;
+    *pX = header.x;
+    *pY = header.y;
+    *pZ = header.z;
+    *pAngle = header.ang;
+    *pSector = header.sect;
+    pSky->lognumtiles = header.lognumtiles;
+    gVisibility = g_visibility = header.visibility;
+    gSongId = header.songId;
+    parallaxtype = header.parallaxtype;
+    gMapRev = header.mapRev;
+    numsectors = header.numsectors;
+    numwalls = header.numwalls;
+    dbInit();
+    byte_19AE44 = header.header2;
+    gSkyCount = 1<<pSky->lognumtiles;
+    memcpy(pSky->tileofs, header.tileofs, sizeof(pSky->tileofs));
+
+    const uint8_t *pData = &buffer[nPos];
+    memcpy(sector, pData, numsectors * sizeof(sectortype));
+    pData += numsectors * sizeof(sectortype);
+    memcpy(qsector_filler, pData, numsectors);
+    pData += numsectors;
+    memcpy(wall, pData, numwalls * sizeof(walltype));
+    pData += numwalls * sizeof(walltype);
+    auto pSprites = (const spritetype*)pData;
+    pData += header.numsprites * sizeof(spritetype);
+    auto pSpriteFiller = (const char*)pData;
+    pData += header.numsprites;
+
+    // The x-structures must get the same indices as on the first load, so
+    // they are handed out in the same order.
+    for (int i = 0; i < numsectors; i++)
+    {
+        if (sector[i].extra > 0)
+        {
+            memcpy(&xsector[dbInsertXSector(i)], pData, sizeof(XSECTOR));
+            pData += sizeof(XSECTOR);
+        }
+    }
+    for (int i = 0; i < numwalls; i++)
+    {
+        if (wall[i].extra > 0)
+        {
+            memcpy(&xwall[dbInsertXWall(i)], pData, sizeof(XWALL));
+            pData += sizeof(XWALL);
+        }
+    }
+    initspritelists();
+    for (int i = 0; i < header.numsprites; i++)
+    {
+        RemoveSpriteStat(i);
+        memcpy(&sprite[i], &pSprites[i], sizeof(spritetype));
+        InsertSpriteSect(i, sprite[i].sectnum);
+        InsertSpriteStat(i, sprite[i].statnum);
+        Numsprites++;
+        qsprite_filler[i] = pSpriteFiller[i];
+        if (sprite[i].extra > 0)
+        {
+            memcpy(&xsprite[dbInsertXSprite(i)], pData, sizeof(XSPRITE));
+            pData += sizeof(XSPRITE);
+        }
+    }
+    return true;
+}
+
+static void dbWriteMapCache(DICTNODE *pNode, int x, int y, int z, short ang, short sect, const MAPSIGNATURE &signature, unsigned int nCRC)
+{
+    if (!map_cache)
+        return;
+
+    MAPCACHEHEADER header = {};
+    memcpy(header.magic, MAP_CACHE_MAGIC, 4);
+    header.version = MAP_CACHE_VERSION;
+    header.nSize = pNode->Size();
+    header.nCRC = nCRC;
+    memcpy(header.md4, g_loadedMapHack.md4, 16);
+    header.signature = signature;
+    header.x = x;
+    header.y = y;
+    header.z = z;
+    header.ang = ang;
+    header.sect = sect;
+    psky_t *pSky = tileSetupSky(0);
+    header.lognumtiles = pSky->lognumtiles;
+    memcpy(header.tileofs, pSky->tileofs, sizeof(header.tileofs));
+    header.visibility = gVisibility;
+    header.songId = gSongId;
+    header.parallaxtype = parallaxtype;
+    header.mapRev = gMapRev;
+    header.numsectors = numsectors;
+    header.numwalls = numwalls;
+    header.numsprites = Numsprites;
+    header.b6 = byte_1A76C6;
+    header.b7 = bMapHeaderCrypted;
+    header.b8 = byte_1A76C8;
+    #ifdef NOONE_EXTENSIONS
+    header.modern = gModernMap;
+    #endif
+    header.header2 = byte_19AE44;
+
+    TArray<uint8_t> xdata;
+    auto addX = [&](const void *pX, size_t nSize)
+    {
+        unsigned int nPos = xdata.Reserve(nSize);
+        memcpy(&xdata[nPos], pX, nSize);
+    };
+    for (int i = 0; i < numsectors; i++)
+    {
+        if (sector[i].extra > 0)
+            addX(&xsector[sector[i].extra], sizeof(XSECTOR)), header.numxsectors++;
+    }
+    for (int i = 0; i < numwalls; i++)
+    {
+        if (wall[i].extra > 0)
+            addX(&xwall[wall[i].extra], sizeof(XWALL)), header.numxwalls++;
+    }
+    for (int i = 0; i < Numsprites; i++)
+    {
+        if (sprite[i].extra > 0)
+            addX(&xsprite[sprite[i].extra], sizeof(XSPRITE)), header.numxsprites++;
+    }
+
+    FileWriter *fw = FileWriter::Open(dbMapCacheFileName(pNode));
+    if (!fw)
+        return;
+    FString stamp = dbMapCacheBuildStamp();
+    fw->Write(stamp.GetChars(), stamp.Len());
+    fw->Write(&header, sizeof(header));
+    fw->Write(sector, numsectors * sizeof(sectortype));
+    fw->Write(qsector_filler, numsectors);
+    fw->Write(wall, numwalls * sizeof(walltype));
+    fw->Write(sprite, Numsprites * sizeof(spritetype));
+    fw->Write(qsprite_filler, Numsprites);
+    fw->Write(xdata.Data(), xdata.Size());
+    fw->Write(MAP_CACHE_MAGIC, 4);
+    delete fw;
+}
+
+int dbLoadMap(const char *pPath, int *pX, int *pY, int *pZ, short *pAngle, short *pSector, unsigned int *pCRC) {
+    show2dsector.Zero();
+    memset(show2dwall, 0, sizeof(show2dwall));
+    memset(show2dsprite, 0, sizeof(show2dsprite));
+    #ifdef NOONE_EXTENSIONS
+    gModernMap = false;
+    #endif
+
+#ifdef USE_OPENGL
+    Polymost_prepare_loadboard();
+#endif
+
+	DICTNODE* pNode;
+
+    pNode = gSysRes.Lookup(pPath, "MAP");
+    if (!pNode)
+    {
+        char name2[BMAX_PATH];
+        Bstrncpy(name2, pPath, BMAX_PATH);
+        ChangeExtension(name2, "");
+        pNode = gSysRes.Lookup(name2, "MAP");
+    }
+
+    if (!pNode)
+    {
+        initprintf("Error opening map file %s", pPath);
+        return -1;
+    }
+    MAPSIGNATURE header;
+    unsigned int nCRC;
+    if (!dbReadMapCache(pNode, pX, pY, pZ, pAngle, pSector, header, nCRC))
+    {
+        if (dbReadMap(pNode, pX, pY, pZ, pAngle, pSector, header, nCRC) < 0)
+            return -1;
+        dbWriteMapCache(pNode, *pX, *pY, *pZ, *pAngle, *pSector, header, nCRC);
+    }
     if (pCRC)
         *pCRC = nCRC;
-    gSysRes.Unlock(pNode);
+    dbRebuildRXIndex();
     PropagateMarkerReferences();
     if (byte_1A76C8)
     {
@@ -1208,6 +1631,8 @@ int dbLoadMap(const char *pPath, int *pX, int *pY, int *pZ, short *pAngle, short
 
     g_loadedMapVersion = 7;
 
+    pvsInit(true);
+
     return 0;
 }
 
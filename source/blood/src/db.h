@@ -276,6 +276,17 @@ struct SPRITEHIT {
 
 extern unsigned short gStatCount[kMaxStatus + 1];;
 
+// Every insertion into a status list takes the next serial, so each list is
+// always in ascending serial order. This lets code that only needs part of a
+// list (see SectorStatIterator) visit it in the same order as a full walk.
+extern unsigned int gStatSerial[kMaxSprites];
+extern unsigned int nStatSerial;
+
+// Steps through the sprites in use (statnum < kMaxStatus) in index order, like
+// a loop over all of sprite[] does, but skips the free ones quickly:
+// for (int i = dbNextSprite(-1); i >= 0; i = dbNextSprite(i))
+int dbNextSprite(int nSprite);
+
 extern bool byte_1A76C6, byte_1A76C7, byte_1A76C8;
 extern MAPHEADER2 byte_19AE44;
 
@@ -347,6 +358,7 @@ void RemoveSpriteSect(int nSprite);
 void InsertSpriteStat(int nSprite, int nStat);
 void RemoveSpriteStat(int nSprite);
 void qinitspritelists(void);
+void dbRebuildStatInfo(void);
 int InsertSprite(int nSector, int nStat);
 int qinsertsprite(short nSector, short nStat);
 int DeleteSprite(int nSprite);
@@ -359,6 +371,10 @@ void InitFreeList(unsigned short *pList, int nCount);
 void InsertFree(unsigned short *pList, int nIndex);
 unsigned short dbInsertXSprite(int nSprite);
 void dbDeleteXSprite(int nXSprite);
+void dbSetXSpriteRX(int nXSprite, int nRX);
+int dbFirstRXSprite(int nRX);
+int dbNextRXSprite(int nXSprite);
+void dbRebuildRXIndex(void);
 unsigned short dbInsertXWall(int nWall);
 void dbDeleteXWall(int nXWall);
 unsigned short dbInsertXSector(int nSector);
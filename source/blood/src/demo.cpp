@@ -44,6 +44,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "screen.h"
 #include "view.h"
 #include "gamecontrol.h"
+#include "timedemo.h"
 #include "menu/menu.h"
 
 BEGIN_BLD_NS
@@ -313,10 +314,15 @@ void CDemo::Playback(void)
     int v4 = 0;
     gNetFifoClock = totalclock;
     gViewMode = 3;
+    // -timedemo runs one tic per pass without waiting for the clock, and stops at the end of the demo.
+    bool const bTimeDemo = TimeDemo_Active();
+    bool bTimeDemoDone = false;
+    if (bTimeDemo)
+        TimeDemo_Start(kTicsPerSec);
 _DEMOPLAYBACK:
     while (at1 && !gQuitGame)
     {
-        while (totalclock >= gNetFifoClock && !gQuitGame)
+        while ((bTimeDemo || totalclock >= gNetFifoClock) && !gQuitGame)
         {
             if (!v4)
             {
@@ -362,7 +368,12 @@ _DEMOPLAYBACK:
                 if (v4 >= atf.nInputCount)
                 {
                     ready2send = 0;
-                    if (at59ef != 1)
+                    if (bTimeDemo)
+                    {
+                        bTimeDemoDone = true;
+                        break;
+                    }
+                    else if (at59ef != 1)
                     {
                         v4 = 0;
                         Close();
@@ -380,10 +391,30 @@ _DEMOPLAYBACK:
             }
             gNetFifoClock += 4;
             if (!gQuitGame)
+            {
+                double const t = timerGetHiTicks();
                 ProcessFrame();
+                TimeDemo_GameTic(timerGetHiTicks() - t);
+            }
             ready2send = 0;
+            if (bTimeDemoDone)
+                TimeDemo_Finish();
+            if (bTimeDemo)
+                break;
+        }
+        if (bTimeDemo)
+        {
+            handleevents();
+            D_ProcessEvents();
+            if (!TimeDemo_NoRender())
+            {
+                double const t = timerGetHiTicks();
+                viewDrawScreen();
+                videoNextPage();
+                TimeDemo_Frame(timerGetHiTicks() - t);
+            }
         }
-        if (G_FPSLimit())
+        else if (G_FPSLimit())
         {
             handleevents();
         	D_ProcessEvents();
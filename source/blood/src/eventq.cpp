@@ -32,6 +32,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "callback.h"
 #include "db.h"
 #include "eventq.h"
+#include "gameutil.h"
 #include "globals.h"
 #include "loadsave.h"
 #include "pqueue.h"
@@ -66,16 +67,34 @@ public:
     void Kill(int, int, CALLBACK_ID);
 };
 
+// events are filed under the object they are for
+enum { kEventKeys = 8 << 14 };
+
+static inline int EventKey(int nIndex, int nType)
+{
+    return (nType << 14) | (nIndex & 0x3fff);
+}
+
+static inline int EventKey(const EVENT &event)
+{
+    return EventKey(event.index, event.type);
+}
+
+static PriorityQueue<EVENT> *NewEventQueue(void)
+{
+    return new PriorityQueue<EVENT>(VanillaMode(), kEventKeys);
+}
+
 EventQueue eventQ;
 void EventQueue::Kill(int a1, int a2)
 {
-    PQueue->Kill([=](EVENT nItem)->bool {return nItem.index == a1 && nItem.type == a2; });
+    PQueue->Kill(EventKey(a1, a2), [=](const EVENT &nItem)->bool {return nItem.index == a1 && nItem.type == a2; });
 }
 
 void EventQueue::Kill(int a1, int a2, CALLBACK_ID a3)
 {
     EVENT evn = { (unsigned int)a1, (unsigned int)a2, kCmdCallback, (unsigned int)a3 };
-    PQueue->Kill([=](EVENT nItem)->bool {return !memcmp(&nItem, &evn, sizeof(EVENT)); });
+    PQueue->Kill(EventKey(a1, a2), [=](const EVENT &nItem)->bool {return !memcmp(&nItem, &evn, sizeof(EVENT)); });
 }
 
 RXBUCKET rxBucket[kChannelMax+1];
@@ -267,11 +286,7 @@ void evInit(void)
 {
     if (eventQ.PQueue)
         delete eventQ.PQueue;
-    if (VanillaMode())
-        eventQ.PQueue = new VanillaPriorityQueue<EVENT>();
-    else
-        eventQ.PQueue = new StdPriorityQueue<EVENT>();
-    eventQ.PQueue->Clear();
+    eventQ.PQueue = NewEventQueue();
     int nCount = 0;
     for (int i = 0; i < numsectors; i++)
     {
@@ -299,7 +314,7 @@ void evInit(void)
             nCount++;
         }
     }
-    for (int i = 0; i < kMaxSprites; i++)
+    for (int i = dbNextSprite(-1); i >= 0; i = dbNextSprite(i))
     {
         if (sprite[i].statnum < kMaxStatus)
         {
@@ -405,7 +420,9 @@ void evSend(int nIndex, int nType, int rxId, COMMAND_ID command)
     case kChannelRemoteBomb5:
     case kChannelRemoteBomb6:
     case kChannelRemoteBomb7:
-        for (int nSprite = headspritestat[kStatThing]; nSprite >= 0; nSprite = nextspritestat[nSprite])
+    {
+        ChannelStatIterator it(kStatThing, rxId);
+        for (int nSprite = it.NextIndex(); nSprite >= 0; nSprite = it.NextIndex())
         {
             spritetype* pSprite = &sprite[nSprite];
             if (pSprite->flags & 32)
@@ -419,9 +436,12 @@ void evSend(int nIndex, int nType, int rxId, COMMAND_ID command)
             }
         }
         return;
+    }
     case kChannelTeamAFlagCaptured:
     case kChannelTeamBFlagCaptured:
-        for (int nSprite = headspritestat[kStatItem]; nSprite >= 0; nSprite = nextspritestat[nSprite])
+    {
+        ChannelStatIterator it(kStatItem, rxId);
+        for (int nSprite = it.NextIndex(); nSprite >= 0; nSprite = it.NextIndex())
         {
             spritetype* pSprite = &sprite[nSprite];
             if (pSprite->flags & 32)
@@ -435,6 +455,7 @@ void evSend(int nIndex, int nType, int rxId, COMMAND_ID command)
             }
         }
         return;
+    }
     default:
         break;
     }
@@ -493,7 +514,7 @@ void evPost(int nIndex, int nType, unsigned int nDelta, COMMAND_ID command) {
     evn.index = nIndex;
     evn.type = nType;
     evn.cmd = command;
-    eventQ.PQueue->Insert((int)gFrameClock+nDelta, evn);
+    eventQ.PQueue->Insert((int)gFrameClock+nDelta, evn, EventKey(evn));
 }
 
 void evPost(int nIndex, int nType, unsigned int nDelta, CALLBACK_ID callback) {
@@ -502,7 +523,7 @@ void evPost(int nIndex, int nType, unsigned int nDelta, CALLBACK_ID callback) {
     evn.type = nType;
     evn.cmd = kCmdCallback;
     evn.funcID = callback;
-    eventQ.PQueue->Insert((int)gFrameClock+nDelta, evn);
+    eventQ.PQueue->Insert((int)gFrameClock+nDelta, evn, EventKey(evn));
 }
 
 void evProcess(unsigned int nTime)
@@ -568,10 +589,7 @@ void EventQLoadSave::Load()
     if (eventQ.PQueue)
         delete eventQ.PQueue;
     Read(&eventQ, sizeof(eventQ));
-    if (VanillaMode())
-        eventQ.PQueue = new VanillaPriorityQueue<EVENT>();
-    else
-        eventQ.PQueue = new StdPriorityQueue<EVENT>();
+    eventQ.PQueue = NewEventQueue();
     int nEvents;
     Read(&nEvents, sizeof(nEvents));
     for (int i = 0; i < nEvents; i++)
@@ -580,7 +598,7 @@ void EventQLoadSave::Load()
         unsigned int eventtime;
         Read(&eventtime, sizeof(eventtime));
         Read(&event, sizeof(event));
-        eventQ.PQueue->Insert(eventtime, event);
+        eventQ.PQueue->Insert(eventtime, event, EventKey(event));
     }
     Read(rxBucket, sizeof(rxBucket));
     Read(bucketHead, sizeof(bucketHead));
@@ -588,10 +606,10 @@ void EventQLoadSave::Load()
 
 void EventQLoadSave::Save()
 {
-    EVENT events[1024];
-    unsigned int eventstime[1024];
     Write(&eventQ, sizeof(eventQ));
     int nEvents = eventQ.PQueue->Size();
+    TArray<EVENT> events(nEvents, true);
+    TArray<unsigned int> eventstime(nEvents, true);
     Write(&nEvents, sizeof(nEvents));
     for (int i = 0; i < nEvents; i++)
     {
@@ -603,7 +621,7 @@ void EventQLoadSave::Save()
     dassert(eventQ.PQueue->Size() == 0);
     for (int i = 0; i < nEvents; i++)
     {
-        eventQ.PQueue->Insert(eventstime[i], events[i]);
+        eventQ.PQueue->Insert(eventstime[i], events[i], EventKey(events[i]));
     }
     Write(rxBucket, sizeof(rxBucket));
     Write(bucketHead, sizeof(bucketHead));
@@ -33,69 +33,66 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "globals.h"
 #include "misc.h"
 #include "tile.h"
+#include "proctiles.h"
 
 BEGIN_BLD_NS
 
 int fireSize = 128;
 int gDamping = 6;
 
-char CoolTable[1024];
-
-void CellularFrame(char *pFrame, int sizeX, int sizeY);
-
 char FrameBuffer[17280];
 char SeedBuffer[16][128];
 char *gCLU;
 
-void InitSeedBuffers(void)
+// The fire runs one frame behind: each update shows the frame computed
+// since the last one and starts the next.
+class FireTile : public FProceduralTile
 {
-    for (int i = 0; i < 16; i++)
-        for (int j = 0; j < fireSize; j += 2)
-            SeedBuffer[i][j] = SeedBuffer[i][j+1] = wrand();
-}
+public:
+    int nSeed;
 
-void BuildCoolTable(void)
-{
-    for (int i = 0; i < 1024; i++)
-        CoolTable[i] = ClipLow((i-gDamping) / 4, 0);
-}
+    FireTile() : FProceduralTile(2342, fireSize, fireSize) {}
 
-void DoFireFrame(void)
-{
-    int nRand = qrand()&15;
-    for (int i = 0; i < 3; i++)
-    {
-        memcpy(FrameBuffer+16896+i*128, SeedBuffer[nRand], 128);
-    }
-    CellularFrame(FrameBuffer, 128, 132);	
-	auto pData = TileFiles.tileMakeWritable(2342);
-    char *pSource = FrameBuffer;
-    int x = fireSize;
-    do
+    void Generate(uint8_t *pData) override
     {
-        int y = fireSize;
-        auto pDataBak = pData;
-        do
+        for (int i = 0; i < 3; i++)
         {
-            *pData = gCLU[*pSource];
-            pSource++;
-            pData += fireSize;
-        } while (--y);
-        pData = pDataBak + 1;
-    } while (--x);
+            memcpy(FrameBuffer+16896+i*128, SeedBuffer[nSeed], 128);
+        }
+        CellularFireFrame((uint8_t*)FrameBuffer, 128, 132, gDamping);
+        uint8_t *pSource = (uint8_t*)FrameBuffer;
+        for (int y = 0; y < fireSize; y++)
+        {
+            for (int x = 0; x < fireSize; x++)
+                pData[x*fireSize+y] = gCLU[*pSource++];
+        }
+    }
+};
+
+static FireTile *pFireTile;
+
+void InitSeedBuffers(void)
+{
+    for (int i = 0; i < 16; i++)
+        for (int j = 0; j < fireSize; j += 2)
+            SeedBuffer[i][j] = SeedBuffer[i][j+1] = wrand();
 }
 
 void FireInit(void)
 {
     memset(FrameBuffer, 0, sizeof(FrameBuffer));
-    BuildCoolTable();
     InitSeedBuffers();
     DICTNODE *pNode = gSysRes.Lookup("RFIRE", "CLU");
     if (!pNode)
         ThrowError("RFIRE.CLU not found");
     gCLU = (char*)gSysRes.Lock(pNode);
+    if (!pFireTile)
+        pFireTile = new FireTile;
     for (int i = 0; i < 100; i++)
-        DoFireFrame();
+    {
+        pFireTile->nSeed = qrand()&15;
+        pFireTile->Run();
+    }
 }
 
 void FireProcess(void)
@@ -103,28 +100,10 @@ void FireProcess(void)
     static ClockTicks lastUpdate;
     if (totalclock < lastUpdate || lastUpdate + 2 < totalclock)
     {
-        DoFireFrame();
+        pFireTile->Finish();
+        pFireTile->nSeed = qrand()&15;
+        pFireTile->Start();
         lastUpdate = totalclock;
-        tileInvalidate(2342, -1, -1);
-    }
-}
-
-void CellularFrame(char *pFrame, int sizeX, int sizeY)
-{
-    int nSquare = sizeX * sizeY;
-    unsigned char *pPtr1 = (unsigned char*)pFrame;
-    while (nSquare--)
-    {
-        unsigned char *pPtr2 = pPtr1+sizeX;
-        int sum = *(pPtr2-1) + *pPtr2 + *(pPtr2+1) + *(pPtr2+sizeX);
-        if (*(pPtr2+sizeX) > 96)
-        {
-            pPtr2 += sizeX;
-            sum += *(pPtr2-1) + *pPtr2 + *(pPtr2+1) + *(pPtr2+sizeX);
-            sum >>= 1;
-        }
-        *pPtr1 = CoolTable[sum];
-        pPtr1++;
     }
 }
 
@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 
 #include "build.h"
 #include "common_game.h"
@@ -909,6 +910,98 @@ int GetClosestSpriteSectors(int nSector, int x, int y, int nDist, short *pSector
     return n;
 }
 
+// Candidates of all active iterators. Iterators can nest (damage may set off
+// further explosions), so each one owns the range above those of its callers.
+struct STATCANDIDATE
+{
+    int nSprite;
+    unsigned int nSerial;
+};
+
+static TArray<STATCANDIDATE> statCandidates;
+
+StatSubsetIterator::StatSubsetIterator(int nStat)
+{
+    this->nStat = nStat;
+    nStartSerial = nStatSerial;
+    nBase = nPos = nEnd = statCandidates.Size();
+    nLast = -1;
+    nLastSerial = 0;
+    bFollowList = false;
+}
+
+StatSubsetIterator::~StatSubsetIterator()
+{
+    statCandidates.Resize(nBase);
+}
+
+void StatSubsetIterator::Add(int nSprite)
+{
+    if (sprite[nSprite].statnum == nStat)
+        statCandidates.Push({ nSprite, gStatSerial[nSprite] });
+}
+
+void StatSubsetIterator::Sort()
+{
+    nEnd = statCandidates.Size();
+    std::sort(statCandidates.Data() + nBase, statCandidates.Data() + nEnd, [](const STATCANDIDATE &a, const STATCANDIDATE &b) { return a.nSerial < b.nSerial; });
+}
+
+SectorStatIterator::SectorStatIterator(int nStat, const short *pSectors) : StatSubsetIterator(nStat)
+{
+    for (; *pSectors >= 0; pSectors++)
+    {
+        for (int nSprite = headspritesect[*pSectors]; nSprite >= 0; nSprite = nextspritesect[nSprite])
+            Add(nSprite);
+    }
+    Sort();
+}
+
+ChannelStatIterator::ChannelStatIterator(int nStat, int nRX) : StatSubsetIterator(nStat)
+{
+    for (int nXSprite = dbFirstRXSprite(nRX); nXSprite >= 0; nXSprite = dbNextRXSprite(nXSprite))
+    {
+        int nSprite = xsprite[nXSprite].reference;
+        if (nSprite >= 0 && nSprite < kMaxSprites && sprite[nSprite].extra == nXSprite)
+            Add(nSprite);
+    }
+    Sort();
+}
+
+int StatSubsetIterator::NextIndex()
+{
+    // A relinked sprite has a new serial. The plain loop would carry on along
+    // its new list, so do the same from now on.
+    if (!bFollowList && nLast >= 0 && gStatSerial[nLast] != nLastSerial)
+        bFollowList = true;
+    if (bFollowList)
+    {
+        if (nLast >= 0)
+            nLast = nextspritestat[nLast];
+        return nLast;
+    }
+    while (nPos < nEnd)
+    {
+        const STATCANDIDATE &candidate = statCandidates[nPos++];
+        // An unchanged serial means the sprite is still in the list, at the same place.
+        if (gStatSerial[candidate.nSprite] == candidate.nSerial)
+        {
+            nLast = candidate.nSprite;
+            nLastSerial = candidate.nSerial;
+            return nLast;
+        }
+    }
+    // Whatever got appended to the list since the start sits at its tail.
+    bFollowList = true;
+    int nHead = headspritestat[nStat];
+    if (nHead < 0 || gStatSerial[prevspritestat[nHead]] <= nStartSerial)
+        return nLast = -1;
+    int nSprite = prevspritestat[nHead];
+    while (nSprite != nHead && gStatSerial[prevspritestat[nSprite]] > nStartSerial)
+        nSprite = prevspritestat[nSprite];
+    return nLast = nSprite;
+}
+
 int picWidth(short nPic, short repeat) {
     return ClipLow((tilesiz[nPic].y * repeat) >> 2, 0);
 }
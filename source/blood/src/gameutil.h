@@ -83,6 +83,50 @@ int GetDistToLine(int x1, int y1, int x2, int y2, int x3, int y3);
 unsigned int ClipMove(int *x, int *y, int *z, int *nSector, int xv, int yv, int wd, int cd, int fd, unsigned int nMask);
 int GetClosestSectors(int nSector, int x, int y, int nDist, short *pSectors, char *pSectBit);
 int GetClosestSpriteSectors(int nSector, int x, int y, int nDist, short *pSectors, char *pSectBit, short *a8);
+
+// Walks a subset of the sprites of status list nStat without looking at the
+// rest of the list. The sprites come in the order a plain headspritestat loop
+// would produce, so game logic using it stays in sync with old demos. Sprites
+// appended to the list while iterating are visited at the end as well, and if
+// the current sprite is moved to another list iteration continues from there,
+// just like the plain loop does.
+// Callers still have to check whatever selected the subset: a sprite may no
+// longer match by the time it is visited, and appended sprites are not checked.
+class StatSubsetIterator
+{
+public:
+    ~StatSubsetIterator();
+    int NextIndex();
+
+protected:
+    StatSubsetIterator(int nStat);
+    void Add(int nSprite);
+    void Sort();
+
+private:
+    int nStat;
+    unsigned int nStartSerial;
+    unsigned int nBase, nPos, nEnd;
+    int nLast;
+    unsigned int nLastSerial;
+    bool bFollowList;
+};
+
+// The sprites in one of the sectors of the -1 terminated list pSectors (as
+// returned by GetClosestSpriteSectors).
+class SectorStatIterator : public StatSubsetIterator
+{
+public:
+    SectorStatIterator(int nStat, const short *pSectors);
+};
+
+// The sprites receiving on channel nRX.
+class ChannelStatIterator : public StatSubsetIterator
+{
+public:
+    ChannelStatIterator(int nStat, int nRX);
+};
+
 int picWidth(short nPic, short repeat);
 int picHeight(short nPic, short repeat);
 
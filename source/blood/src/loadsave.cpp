@@ -681,11 +681,12 @@ void MyLoadSave::Load(void)
     Read(&byte_1A76C7, sizeof(byte_1A76C7));
     Read(&byte_19AE44, sizeof(byte_19AE44));
     Read(gStatCount, sizeof(gStatCount));
+    dbRebuildStatInfo();
     Read(nextXSprite, sizeof(nextXSprite));
     Read(nextXWall, sizeof(nextXWall));
     Read(nextXSector, sizeof(nextXSector));
     memset(xsprite, 0, sizeof(xsprite));
-    for (int nSprite = 0; nSprite < kMaxSprites; nSprite++)
+    for (int nSprite = dbNextSprite(-1); nSprite >= 0; nSprite = dbNextSprite(nSprite))
     {
         if (sprite[nSprite].statnum < kMaxStatus)
         {
@@ -697,6 +698,7 @@ void MyLoadSave::Load(void)
             }
         }
     }
+    dbRebuildRXIndex();
     memset(xwall, 0, sizeof(xwall));
     for (int nWall = 0; nWall < numwalls; nWall++)
     {
@@ -736,7 +738,7 @@ void MyLoadSave::Save(void)
     Write(&id, sizeof(id));
     short version = BYTEVERSION;
     Write(&version, sizeof(version));
-    for (int nSprite = 0; nSprite < kMaxSprites; nSprite++)
+    for (int nSprite = dbNextSprite(-1); nSprite >= 0; nSprite = dbNextSprite(nSprite))
     {
         if (sprite[nSprite].statnum < kMaxStatus && nSprite > nNumSprites)
             nNumSprites = nSprite;
@@ -777,7 +779,7 @@ void MyLoadSave::Save(void)
     Write(nextXSprite, sizeof(nextXSprite));
     Write(nextXWall, sizeof(nextXWall));
     Write(nextXSector, sizeof(nextXSector));
-    for (int nSprite = 0; nSprite < kMaxSprites; nSprite++)
+    for (int nSprite = dbNextSprite(-1); nSprite >= 0; nSprite = dbNextSprite(nSprite))
     {
         if (sprite[nSprite].statnum < kMaxStatus)
         {
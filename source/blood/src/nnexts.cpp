@@ -32,6 +32,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "nnexts.h"
 #ifdef NOONE_EXTENSIONS
 #include <random>
+#include <algorithm>
 #include "loadsave.h"
 #include "aiunicult.h"
 #include "triggers.h"
@@ -238,9 +239,17 @@ void nnExtInitModernStuff(bool bSaveLoad) {
     if (!gAllowTrueRandom)
         initprintf("> True randomness is not available, using in-game random function(s)");
     
-    for (int i = 0; i < kMaxXSprites; i++) {
+    // only the sprites in use can have xsprites, but these still need to be gone through in xsprite order
+    TArray<int> xsprites;
+    for (int nSprite = dbNextSprite(-1); nSprite >= 0; nSprite = dbNextSprite(nSprite)) {
+        int nXSprite = sprite[nSprite].extra;
+        if (nXSprite > 0 && nXSprite < kMaxXSprites && xsprite[nXSprite].reference == nSprite)
+            xsprites.Push(nXSprite);
+    }
+    std::sort(xsprites.begin(), xsprites.end());
+
+    for (int i : xsprites) {
 
-        if (xsprite[i].reference < 0) continue;
         XSPRITE* pXSprite = &xsprite[i];  spritetype* pSprite = &sprite[pXSprite->reference];
 
         switch (pSprite->type) {
@@ -23,6 +23,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 //-------------------------------------------------------------------------
 #include "ns.h"	// Must come before everything else!
 
+#include <set>
+
 #include "build.h"
 #include "baselayer.h"
 #include "osd.h"
@@ -32,12 +34,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "config.h"
 #include "blood.h"
 #include "demo.h"
+#include "eventq.h"
 #include "gamemenu.h"
+#include "gameutil.h"
 #include "globals.h"
 #include "levels.h"
 #include "messages.h"
 #include "network.h"
 #include "osdcmds.h"
+#include "pqueue.h"
 #include "screen.h"
 #include "sound.h"
 #include "sfx.h"
@@ -253,6 +258,303 @@ static int osdcmd_levelwarp(osdcmdptr_t parm)
     return OSDCMD_OK;
 }
 
+// Runs explosion style radius queries around every dude and thing of the
+// current level, once walking the full status lists and once through
+// SectorStatIterator, and compares the time taken. Nothing gets damaged.
+static int osdcmd_bench_radius(osdcmdptr_t parm)
+{
+    if (!gGameStarted)
+    {
+        OSD_Printf("bench_radius: No level loaded.\n");
+        return OSDCMD_OK;
+    }
+    int nQueries = parm->numparms > 0 ? atoi(parm->parms[0]) : 10000;
+    int nRadius = parm->numparms > 1 ? atoi(parm->parms[1]) : 400;
+    if (nQueries <= 0 || nRadius <= 0)
+        return OSDCMD_SHOWHELP;
+
+    TArray<int> origins;
+    for (int nSprite = headspritestat[kStatDude]; nSprite >= 0; nSprite = nextspritestat[nSprite])
+        origins.Push(nSprite);
+    for (int nSprite = headspritestat[kStatThing]; nSprite >= 0; nSprite = nextspritestat[nSprite])
+        origins.Push(nSprite);
+    if (origins.Size() == 0)
+        origins.Push(gMe->nSprite);
+
+    static short sectors[kMaxSectors+1];
+    static char sectbits[(kMaxSectors+7)>>3];
+    static const int stats[] = { kStatDude, kStatThing };
+    int nHits[2] = { 0, 0 };
+    double time[2];
+
+    for (int nPass = 0; nPass < 2; nPass++)
+    {
+        double const startTime = timerGetHiTicks();
+        for (int q = 0; q < nQueries; q++)
+        {
+            spritetype *pOrigin = &sprite[origins[q % origins.Size()]];
+            GetClosestSpriteSectors(pOrigin->sectnum, pOrigin->x, pOrigin->y, nRadius, sectors, sectbits, NULL);
+            for (int nStat : stats)
+            {
+                auto test = [&](int nSprite)
+                {
+                    spritetype *pSprite = &sprite[nSprite];
+                    if (TestBitString(sectbits, pSprite->sectnum) && CheckProximity(pSprite, pOrigin->x, pOrigin->y, pOrigin->z, pOrigin->sectnum, nRadius<<4))
+                        nHits[nPass]++;
+                };
+                if (nPass == 0)
+                {
+                    for (int nSprite = headspritestat[nStat]; nSprite >= 0; nSprite = nextspritestat[nSprite])
+                        test(nSprite);
+                }
+                else
+                {
+                    SectorStatIterator it(nStat, sectors);
+                    for (int nSprite = it.NextIndex(); nSprite >= 0; nSprite = it.NextIndex())
+                        test(nSprite);
+                }
+            }
+        }
+        time[nPass] = timerGetHiTicks() - startTime;
+    }
+
+    OSD_Printf("bench_radius: %d queries of radius %d around %u sprites\n", nQueries, nRadius, origins.Size());
+    OSD_Printf("full lists:   %.3f ms, %d hits\n", time[0], nHits[0]);
+    OSD_Printf("sector lists: %.3f ms, %d hits\n", time[1], nHits[1]);
+    return OSDCMD_OK;
+}
+
+// Starts the current level over a number of times the way a new game does and
+// reports how long that took. This is the path the whole-map sprite passes
+// run on, so it shows what they cost on a large map.
+static int osdcmd_bench_levelload(osdcmdptr_t parm)
+{
+    if (!gGameStarted)
+    {
+        OSD_Printf("bench_levelload: No level loaded.\n");
+        return OSDCMD_OK;
+    }
+    if (numplayers > 1 || gDemo.at0 || gDemo.at1)
+    {
+        OSD_Printf("bench_levelload: Only works in a single player game that is not a demo.\n");
+        return OSDCMD_OK;
+    }
+    if (gEpisodeInfo[gGameOptions.nEpisode].cutALevel == gGameOptions.nLevel && gEpisodeInfo[gGameOptions.nEpisode].at8f08[0])
+    {
+        OSD_Printf("bench_levelload: The level plays an intro scene when it starts.\n");
+        return OSDCMD_OK;
+    }
+    int nPasses = parm->numparms > 0 ? atoi(parm->parms[0]) : 10;
+    if (nPasses <= 0)
+        return OSDCMD_SHOWHELP;
+
+    double totalTime = 0, minTime = 0;
+    for (int p = 0; p < nPasses; p++)
+    {
+        double const startTime = timerGetHiTicks();
+        StartLevel(&gGameOptions);
+        double const time = timerGetHiTicks() - startTime;
+        if (gQuitGame)
+            return OSDCMD_OK;
+        totalTime += time;
+        if (p == 0 || time < minTime)
+            minTime = time;
+    }
+
+    int nSprites = 0;
+    for (int i = dbNextSprite(-1); i >= 0; i = dbNextSprite(i))
+        nSprites++;
+
+    OSD_Printf("bench_levelload: %s, %d sectors, %d walls, %d sprites in use\n", gGameOptions.zLevelName, numsectors, numwalls, nSprites);
+    OSD_Printf("%d loads: %.3f ms average, %.3f ms fastest\n", nPasses, totalTime / nPasses, minTime);
+    return OSDCMD_OK;
+}
+
+// The event queues as they were before PriorityQueue indexed events by
+// object, for test_eventqueue to compare against.
+struct OldQueueItem
+{
+    uint32_t nPriority;
+    EVENT data;
+    bool operator<(const OldQueueItem &other) const { return nPriority < other.nPriority; }
+};
+
+class OldVanillaQueue
+{
+public:
+    enum { kSize = 1024 };
+    OldQueueItem items[kSize + 1];
+    uint32_t nCount = 0;
+
+    void Upheap(void)
+    {
+        OldQueueItem item = items[nCount];
+        items[0].nPriority = 0;
+        uint32_t x = nCount;
+        while (items[x>>1].nPriority > item.nPriority)
+        {
+            items[x] = items[x>>1];
+            x >>= 1;
+        }
+        items[x] = item;
+    }
+    void Downheap(uint32_t n)
+    {
+        OldQueueItem item = items[n];
+        while (nCount/2 >= n)
+        {
+            uint32_t t = n*2;
+            if (t < nCount && items[t].nPriority > items[t+1].nPriority)
+                t++;
+            if (item.nPriority <= items[t].nPriority)
+                break;
+            items[n] = items[t];
+            n = t;
+        }
+        items[n] = item;
+    }
+    void Insert(uint32_t nPriority, EVENT data)
+    {
+        items[++nCount] = { nPriority, data };
+        Upheap();
+    }
+    EVENT Remove(void)
+    {
+        EVENT data = items[1].data;
+        items[1] = items[nCount--];
+        Downheap(1);
+        return data;
+    }
+    template<typename F> void Kill(F pMatch)
+    {
+        for (uint32_t i = 1; i <= nCount;)
+        {
+            if (pMatch(items[i].data))
+            {
+                items[i] = items[nCount--];
+                Downheap(i);
+            }
+            else
+                i++;
+        }
+    }
+};
+
+// Runs the same random inserts, removes and kills on PriorityQueue and on the
+// queue it replaced, in vanilla and in normal mode, and reports every place
+// where they disagree. Events get few distinct objects and times, so that
+// kills and ties are common. The game's own queue isn't touched.
+static int osdcmd_test_eventqueue(osdcmdptr_t parm)
+{
+    int nOperations = parm->numparms > 0 ? atoi(parm->parms[0]) : 100000;
+    uint32_t nSeed = parm->numparms > 1 ? (uint32_t)atoi(parm->parms[1]) : 1;
+    if (nOperations <= 0)
+        return OSDCMD_SHOWHELP;
+
+    auto key = [](const EVENT &event) { return (int)((event.type << 14) | event.index); };
+    auto same = [](const EVENT &a, const EVENT &b) { return !memcmp(&a, &b, sizeof(EVENT)); };
+
+    for (int nMode = 0; nMode < 2; nMode++)
+    {
+        bool const bVanilla = nMode == 0;
+        PriorityQueue<EVENT> queue(bVanilla, 8 << 14);
+        auto oldVanilla = std::make_unique<OldVanillaQueue>();
+        std::multiset<OldQueueItem> oldStd;
+        uint32_t nRandom = nSeed;
+        auto random = [&](uint32_t nRange) { nRandom = nRandom * 1103515245 + 12345; return (nRandom >> 16) % nRange; };
+
+        uint32_t nTime = 0;
+        int nMismatches = 0, nFirst = -1, nRemoved = 0, nKilled = 0;
+        auto oldSize = [&]() { return bVanilla ? oldVanilla->nCount : (uint32_t)oldStd.size(); };
+        auto check = [&](int nOp, bool bOk) { if (!bOk && nMismatches++ == 0) nFirst = nOp; };
+
+        for (int nOp = 0; nOp <= nOperations; nOp++)
+        {
+            uint32_t const nAction = nOp < nOperations ? random(100) : 100;
+            EVENT event = {};
+            event.index = random(8);
+            event.type = random(3);
+            event.cmd = random(4) == 0 ? kCmdCallback : random(4);
+            event.funcID = random(4);
+
+            if (nAction < 50 && queue.Size() < OldVanillaQueue::kSize)
+            {
+                uint32_t const nPriority = nTime + random(16);
+                queue.Insert(nPriority, event, key(event));
+                if (bVanilla)
+                    oldVanilla->Insert(nPriority, event);
+                else
+                    oldStd.insert({ nPriority, event });
+            }
+            else if (nAction < 80)
+            {
+                if (queue.Size() > 0 && oldSize() > 0)
+                {
+                    uint32_t const nPriority = bVanilla ? oldVanilla->items[1].nPriority : oldStd.begin()->nPriority;
+                    check(nOp, queue.LowestPriority() == nPriority);
+                    EVENT const removed = queue.Remove();
+                    EVENT oldRemoved;
+                    if (bVanilla)
+                        oldRemoved = oldVanilla->Remove();
+                    else
+                    {
+                        oldRemoved = oldStd.begin()->data;
+                        oldStd.erase(oldStd.begin());
+                    }
+                    check(nOp, same(removed, oldRemoved));
+                    nTime = nPriority;
+                    nRemoved++;
+                }
+            }
+            else if (nAction < 100)
+            {
+                // evKill() for an object, or for one of its callbacks
+                bool const bCallback = nAction >= 90;
+                auto match = [&](const EVENT &item)
+                {
+                    if (bCallback)
+                        return item.index == event.index && item.type == event.type && item.cmd == kCmdCallback && item.funcID == event.funcID;
+                    return item.index == event.index && item.type == event.type;
+                };
+                uint32_t const nBefore = queue.Size();
+                queue.Kill(key(event), match);
+                nKilled += nBefore - queue.Size();
+                if (bVanilla)
+                    oldVanilla->Kill(match);
+                else
+                {
+                    for (auto i = oldStd.begin(); i != oldStd.end();)
+                        i = match(i->data) ? oldStd.erase(i) : std::next(i);
+                }
+            }
+            else
+            {
+                // drain what is left at the end
+                while (queue.Size() > 0 && oldSize() > 0)
+                {
+                    EVENT oldRemoved;
+                    if (bVanilla)
+                        oldRemoved = oldVanilla->Remove();
+                    else
+                    {
+                        oldRemoved = oldStd.begin()->data;
+                        oldStd.erase(oldStd.begin());
+                    }
+                    check(nOp, same(queue.Remove(), oldRemoved));
+                }
+            }
+            check(nOp, queue.Size() == oldSize());
+        }
+
+        if (nMismatches > 0)
+            OSD_Printf(OSD_ERROR "test_eventqueue: %s mode: %d mismatches, first at operation %d\n", bVanilla ? "vanilla" : "normal", nMismatches, nFirst);
+        else
+            OSD_Printf("test_eventqueue: %s mode: %d operations (%d events removed, %d killed), same order as the old queue\n",
+                bVanilla ? "vanilla" : "normal", nOperations, nRemoved, nKilled);
+    }
+    return OSDCMD_OK;
+}
+
 int32_t registerosdcommands(void)
 {
     OSD_RegisterFunction("map","map <mapname>: loads the given map", osdcmd_map);
@@ -266,6 +568,10 @@ int32_t registerosdcommands(void)
 
     OSD_RegisterFunction("levelwarp","levelwarp <e> <m>: warp to episode 'e' and map 'm'", osdcmd_levelwarp);
 
+    OSD_RegisterFunction("bench_radius","bench_radius [queries] [radius]: times explosion radius queries on the current level", osdcmd_bench_radius);
+    OSD_RegisterFunction("bench_levelload","bench_levelload [passes]: restarts the current level a number of times and reports how long it took", osdcmd_bench_levelload);
+    OSD_RegisterFunction("test_eventqueue","test_eventqueue [operations] [seed]: compares the event queue against the one it replaced on random events", osdcmd_test_eventqueue);
+
     return 0;
 }
 
@@ -21,169 +21,160 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 //-------------------------------------------------------------------------
 #pragma once
-#include <set>
-#include <functional>
 #include "common_game.h"
 
 BEGIN_BLD_NS
 
-#define kPQueueSize 1024
-
-template <typename T> struct queueItem
-{
-    uint32_t at0; // priority
-    T at4; // data
-    bool operator>(const queueItem& other) const
-    {
-        return at0 > other.at0;
-    }
-    bool operator<(const queueItem& other) const
-    {
-        return at0 < other.at0;
-    }
-    bool operator>=(const queueItem& other) const
-    {
-        return at0 >= other.at0;
-    }
-    bool operator<=(const queueItem& other) const
-    {
-        return at0 <= other.at0;
-    }
-    bool operator!=(const queueItem& other) const
-    {
-        return at0 != other.at0;
-    }
-    bool operator==(const queueItem& other) const
-    {
-        return at0 == other.at0;
-    }
-};
-
+// Binary heap of prioritized items, which also keeps the items of each key
+// (an object the items refer to) linked together, so killing everything
+// queued for an object doesn't need to look at the rest of the queue.
+//
+// In vanilla mode items compare by priority alone and deletion only sifts
+// down, just like the original fixed size heap, so items of equal priority
+// come out in the same order and old demos stay in sync. Otherwise ties are
+// broken by insertion order, which is what the std::multiset used before did.
 template<typename T> class PriorityQueue
 {
-public:
-    virtual ~PriorityQueue() {}
-    virtual uint32_t Size(void) = 0;
-    virtual void Clear(void) = 0;
-    virtual void Insert(uint32_t, T) = 0;
-    virtual T Remove(void) = 0;
-    virtual uint32_t LowestPriority(void) = 0;
-    virtual void Kill(std::function<bool(T)> pMatch) = 0;
-};
+    struct Node
+    {
+        uint32_t nPriority;
+        uint32_t nSerial;
+        T data;
+        unsigned nHeapPos;
+        int nKey, nKeyPrev, nKeyNext;
+    };
 
-template<typename T> class VanillaPriorityQueue : public PriorityQueue<T>
-{
-public:
-    queueItem<T> queueItems[kPQueueSize + 1];
-    uint32_t fNodeCount; // at2008
-    ~VanillaPriorityQueue() {}
-    uint32_t Size(void) { return fNodeCount; };
-    void Clear(void)
+    TArray<Node> nodes;
+    TArray<int> freeNodes;
+    TArray<int> heap;       // node indices, heap[0] is unused
+    TArray<int> keyHead;    // first node of each key, -1 if there is none
+    uint32_t nSerial;
+    bool bVanilla;
+
+    bool Greater(const Node &a, const Node &b) const
+    {
+        if (a.nPriority != b.nPriority)
+            return a.nPriority > b.nPriority;
+        return !bVanilla && a.nSerial > b.nSerial;
+    }
+    void Place(unsigned nPos, int nNode)
     {
-        fNodeCount = 0;
-        memset(queueItems, 0, sizeof(queueItems));
+        heap[nPos] = nNode;
+        nodes[nNode].nHeapPos = nPos;
     }
-    void Upheap(void)
+    void Upheap(unsigned x)
     {
-        queueItem<T> item = queueItems[fNodeCount];
-        queueItems[0].at0 = 0;
-        uint32_t x = fNodeCount;
-        while (queueItems[x>>1] > item)
+        int nNode = heap[x];
+        while (x > 1 && Greater(nodes[heap[x>>1]], nodes[nNode]))
         {
-            queueItems[x] = queueItems[x>>1];
+            Place(x, heap[x>>1]);
             x >>= 1;
         }
-        queueItems[x] = item;
+        Place(x, nNode);
     }
-    void Downheap(uint32_t n)
+    void Downheap(unsigned n)
     {
-        queueItem<T> item = queueItems[n];
-        while (fNodeCount/2 >= n)
+        int nNode = heap[n];
+        unsigned nCount = Size();
+        while (nCount/2 >= n)
         {
-            uint32_t t = n*2;
-            if (t < fNodeCount && queueItems[t] > queueItems[t+1])
+            unsigned t = n*2;
+            if (t < nCount && Greater(nodes[heap[t]], nodes[heap[t+1]]))
                 t++;
-            if (item <= queueItems[t])
+            if (!Greater(nodes[nNode], nodes[heap[t]]))
                 break;
-            queueItems[n] = queueItems[t];
+            Place(n, heap[t]);
             n = t;
         }
-        queueItems[n] = item;
-    }
-    void Delete(uint32_t k)
-    {
-        dassert(k <= fNodeCount);
-        queueItems[k] = queueItems[fNodeCount--];
-        Downheap(k);
-    }
-    void Insert(uint32_t a1, T a2)
-    {
-        dassert(fNodeCount < kPQueueSize);
-        fNodeCount++;
-        queueItems[fNodeCount].at0 = a1;
-        queueItems[fNodeCount].at4 = a2;
-        Upheap();
-    }
-    T Remove(void)
-    {
-        T data = queueItems[1].at4;
-        queueItems[1] = queueItems[fNodeCount--];
-        Downheap(1);
-        return data;
+        Place(n, nNode);
     }
-    uint32_t LowestPriority(void)
+    void Delete(unsigned k)
     {
-        dassert(fNodeCount > 0);
-        return queueItems[1].at0;
-    }
-    void Kill(std::function<bool(T)> pMatch)
-    {
-        for (unsigned int i = 1; i <= fNodeCount;)
+        dassert(k >= 1 && k <= Size());
+        int nNode = heap[k];
+        int nLast = heap.Last();
+        heap.Pop();
+        if (k < heap.Size())
         {
-            if (pMatch(queueItems[i].at4))
-                Delete(i);
-            else
-                i++;
+            Place(k, nLast);
+            Downheap(k);
+            if (!bVanilla)
+                Upheap(nodes[nLast].nHeapPos);
         }
+
+        Node &node = nodes[nNode];
+        if (node.nKeyPrev >= 0)
+            nodes[node.nKeyPrev].nKeyNext = node.nKeyNext;
+        else
+            keyHead[node.nKey] = node.nKeyNext;
+        if (node.nKeyNext >= 0)
+            nodes[node.nKeyNext].nKeyPrev = node.nKeyPrev;
+        freeNodes.Push(nNode);
     }
-};
 
-template<typename T> class StdPriorityQueue : public PriorityQueue<T>
-{
 public:
-    std::multiset<queueItem<T>> stdQueue;
-    ~StdPriorityQueue()
+    PriorityQueue(bool vanilla, int nKeys) : bVanilla(vanilla)
     {
-        stdQueue.clear();
+        keyHead.Resize(nKeys);
+        Clear();
     }
-    uint32_t Size(void) { return stdQueue.size(); };
+    uint32_t Size(void) { return heap.Size() - 1; }
     void Clear(void)
     {
-        stdQueue.clear();
+        nodes.Clear();
+        freeNodes.Clear();
+        heap.Resize(1);
+        for (auto &head : keyHead)
+            head = -1;
+        nSerial = 0;
     }
-    void Insert(uint32_t nPriority, T data)
+    void Insert(uint32_t nPriority, T data, int nKey)
     {
-        stdQueue.insert({ nPriority, data });
+        int nNode;
+        if (!freeNodes.Pop(nNode))
+            nNode = nodes.Reserve(1);
+
+        Node &node = nodes[nNode];
+        node.nPriority = nPriority;
+        node.nSerial = nSerial++;
+        node.data = data;
+        node.nKey = nKey;
+        node.nKeyPrev = -1;
+        node.nKeyNext = keyHead[nKey];
+        if (node.nKeyNext >= 0)
+            nodes[node.nKeyNext].nKeyPrev = nNode;
+        keyHead[nKey] = nNode;
+
+        Upheap(heap.Push(nNode));
     }
     T Remove(void)
     {
-        dassert(stdQueue.size() > 0);
-        T data = stdQueue.begin()->at4;
-        stdQueue.erase(stdQueue.begin());
+        dassert(Size() > 0);
+        T data = nodes[heap[1]].data;
+        Delete(1);
         return data;
     }
     uint32_t LowestPriority(void)
     {
-        return stdQueue.begin()->at0;
+        dassert(Size() > 0);
+        return nodes[heap[1]].nPriority;
     }
-    void Kill(std::function<bool(T)> pMatch)
+    // Removes the key's items that pMatch accepts. The original scanned the
+    // whole heap from the top and deleted matches as it went; always taking
+    // the match nearest to the top deletes them in exactly that order.
+    template<typename F> void Kill(int nKey, F pMatch)
     {
-        for (auto i = stdQueue.begin(); i != stdQueue.end();)
+        while (true)
         {
-            if (pMatch(i->at4))
-                i = stdQueue.erase(i);
-            else
-                i++;
+            int nBest = -1;
+            for (int nNode = keyHead[nKey]; nNode >= 0; nNode = nodes[nNode].nKeyNext)
+            {
+                if ((nBest < 0 || nodes[nNode].nHeapPos < nodes[nBest].nHeapPos) && pMatch(nodes[nNode].data))
+                    nBest = nNode;
+            }
+            if (nBest < 0)
+                break;
+            Delete(nodes[nBest].nHeapPos);
         }
     }
 };
@@ -115,6 +115,9 @@ short shadeList[kMaxXSectors];
 int panCount = 0;
 short panList[kMaxXSectors];
 
+// pXSector->shade is what got added to the shades last time. Taking it off
+// and adding the new value is done in one go, with the same results as doing
+// one after the other: taking off wraps around, adding is clamped.
 void DoSectorLighting(void)
 {
     for (int i = 0; i < shadeCount; i++)
@@ -123,44 +126,9 @@ void DoSectorLighting(void)
         XSECTOR *pXSector = &xsector[nXSector];
         int nSector = pXSector->reference;
         dassert(sector[nSector].extra == nXSector);
-        if (pXSector->shade)
-        {
-            int v4 = pXSector->shade;
-            if (pXSector->shadeFloor)
-            {
-                sector[nSector].floorshade -= v4;
-                if (pXSector->color)
-                {
-                    int nTemp = pXSector->floorpal;
-                    pXSector->floorpal = sector[nSector].floorpal;
-                    sector[nSector].floorpal = nTemp;
-                }
-            }
-            if (pXSector->shadeCeiling)
-            {
-                sector[nSector].ceilingshade -= v4;
-                if (pXSector->color)
-                {
-                    int nTemp = pXSector->ceilpal;
-                    pXSector->ceilpal = sector[nSector].ceilingpal;
-                    sector[nSector].ceilingpal = nTemp;
-                }
-            }
-            if (pXSector->shadeWalls)
-            {
-                int nStartWall = sector[nSector].wallptr;
-                int nEndWall = nStartWall + sector[nSector].wallnum;
-                for (int j = nStartWall; j < nEndWall; j++)
-                {
-                    wall[j].shade -= v4;
-                    if (pXSector->color)
-                    {
-                        wall[j].pal = sector[nSector].floorpal;
-                    }
-                }
-            }
-            pXSector->shade = 0;
-        }
+        sectortype *pSector = &sector[nSector];
+        int nOld = pXSector->shade;
+        int nNew = 0;
         if (pXSector->shadeAlways || pXSector->busy)
         {
             int t1 = pXSector->wave;
@@ -169,92 +137,47 @@ void DoSectorLighting(void)
             {
                 t2 = mulscale16(t2, pXSector->busy);
             }
-            int v4 = GetWaveValue(t1, pXSector->phase*8+pXSector->freq*(int)totalclock, t2);
-            if (pXSector->shadeFloor)
-            {
-                sector[nSector].floorshade = ClipRange(sector[nSector].floorshade+v4, -128, 127);
-                if (pXSector->color && v4 != 0)
-                {
-                    int nTemp = pXSector->floorpal;
-                    pXSector->floorpal = sector[nSector].floorpal;
-                    sector[nSector].floorpal = nTemp;
-                }
-            }
-            if (pXSector->shadeCeiling)
+            nNew = GetWaveValue(t1, pXSector->phase*8+pXSector->freq*(int)totalclock, t2);
+        }
+        else if (!nOld)
+            continue;
+        // Every nonzero value swaps the palettes, so two of them cancel out.
+        bool bSwap = pXSector->color && (nOld != 0) != (nNew != 0);
+        bool bWallPal = pXSector->color && (nOld != 0 || nNew != 0);
+        if (pXSector->shadeFloor)
+        {
+            pSector->floorshade = ClipRange((int8_t)(pSector->floorshade-nOld)+nNew, -128, 127);
+            if (bSwap)
             {
-                sector[nSector].ceilingshade = ClipRange(sector[nSector].ceilingshade+v4, -128, 127);
-                if (pXSector->color && v4 != 0)
-                {
-                    int nTemp = pXSector->ceilpal;
-                    pXSector->ceilpal = sector[nSector].ceilingpal;
-                    sector[nSector].ceilingpal = nTemp;
-                }
+                int nTemp = pXSector->floorpal;
+                pXSector->floorpal = pSector->floorpal;
+                pSector->floorpal = nTemp;
             }
-            if (pXSector->shadeWalls)
+        }
+        if (pXSector->shadeCeiling)
+        {
+            pSector->ceilingshade = ClipRange((int8_t)(pSector->ceilingshade-nOld)+nNew, -128, 127);
+            if (bSwap)
             {
-                int nStartWall = sector[nSector].wallptr;
-                int nEndWall = nStartWall + sector[nSector].wallnum;
-                for (int j = nStartWall; j < nEndWall; j++)
-                {
-                    wall[j].shade = ClipRange(wall[j].shade+v4, -128, 127);
-                    if (pXSector->color && v4 != 0)
-                    {
-                        wall[j].pal = sector[nSector].floorpal;
-                    }
-                }
+                int nTemp = pXSector->ceilpal;
+                pXSector->ceilpal = pSector->ceilingpal;
+                pSector->ceilingpal = nTemp;
             }
-            pXSector->shade = v4;
         }
-    }
-}
-
-void UndoSectorLighting(void)
-{
-    for (int i = 0; i < numsectors; i++)
-    {
-        int nXSprite = sector[i].extra;
-        if (nXSprite > 0)
+        if (pXSector->shadeWalls)
         {
-            XSECTOR *pXSector = &xsector[i];
-            if (pXSector->shade)
+            int nStartWall = pSector->wallptr;
+            int nEndWall = nStartWall + pSector->wallnum;
+            for (int j = nStartWall; j < nEndWall; j++)
             {
-                int v4 = pXSector->shade;
-                if (pXSector->shadeFloor)
-                {
-                    sector[i].floorshade -= v4;
-                    if (pXSector->color)
-                    {
-                        int nTemp = pXSector->floorpal;
-                        pXSector->floorpal = sector[i].floorpal;
-                        sector[i].floorpal = nTemp;
-                    }
-                }
-                if (pXSector->shadeCeiling)
-                {
-                    sector[i].ceilingshade -= v4;
-                    if (pXSector->color)
-                    {
-                        int nTemp = pXSector->ceilpal;
-                        pXSector->ceilpal = sector[i].ceilingpal;
-                        sector[i].ceilingpal = nTemp;
-                    }
-                }
-                if (pXSector->shadeWalls)
+                wall[j].shade = ClipRange((int8_t)(wall[j].shade-nOld)+nNew, -128, 127);
+                if (bWallPal)
                 {
-                    int nStartWall = sector[i].wallptr;
-                    int nEndWall = nStartWall + sector[i].wallnum;
-                    for (int j = nStartWall; j < nEndWall; j++)
-                    {
-                        wall[j].shade -= v4;
-                        if (pXSector->color)
-                        {
-                            wall[j].pal = sector[i].floorpal;
-                        }
-                    }
+                    wall[j].pal = pSector->floorpal;
                 }
-                pXSector->shade = 0;
             }
         }
+        pXSector->shade = nNew;
     }
 }
 
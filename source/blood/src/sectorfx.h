@@ -30,7 +30,6 @@ extern int panCount;
 extern short panList[kMaxXSectors];
 
 void DoSectorLighting(void);
-void UndoSectorLighting(void);
 void DoSectorPanning(void);
 void InitSectorFX(void);
 
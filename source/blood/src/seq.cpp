@@ -46,7 +46,9 @@ BEGIN_BLD_NS
 #define kMaxClients 256
 #define kMaxSequences 1024
 
-static ACTIVE activeList[kMaxSequences];
+// Everything that is animating, packed at the front so seqProcess()
+// only has to go over what is actually running.
+static SEQINST activeList[kMaxSequences];
 static int activeCount = 0;
 static int nClients = 0;
 static void(*clientCallback[kMaxClients])(int, int);
@@ -88,11 +90,19 @@ void seqPrecacheId(int id)
     gSysRes.Unlock(hSeq);
 }
 
-SEQINST siWall[kMaxXWalls];
-SEQINST siCeiling[kMaxXSectors];
-SEQINST siFloor[kMaxXSectors];
-SEQINST siSprite[kMaxXSprites];
-SEQINST siMasked[kMaxXWalls];
+// Where each object's sequence is in activeList, plus the last sequence
+// it played, which seqGetID() still reports once that is over.
+struct SEQSLOT
+{
+    short nInst; // index + 1, 0 if not animating
+    int nSeq;
+};
+
+static SEQSLOT siWall[kMaxXWalls];
+static SEQSLOT siCeiling[kMaxXSectors];
+static SEQSLOT siFloor[kMaxXSectors];
+static SEQSLOT siSprite[kMaxXSprites];
+static SEQSLOT siMasked[kMaxXWalls];
 
 void UpdateSprite(int nXSprite, SEQFRAME *pFrame)
 {
@@ -273,39 +283,40 @@ void UpdateCeiling(int nXSector, SEQFRAME *pFrame)
         pSector->ceilingpal = pFrame->at5_0;
 }
 
-void SEQINST::Update(ACTIVE *pActive)
+void SEQINST::Update(void)
 {
     dassert(frameIndex < pSequence->nFrames);
-    switch (pActive->type)
+    SEQFRAME *pFrame = &pSequence->frames[frameIndex];
+    switch (type)
     {
     case 0:
-        UpdateWall(pActive->xindex, &pSequence->frames[frameIndex]);
+        UpdateWall(xindex, pFrame);
         break;
     case 1:
-        UpdateCeiling(pActive->xindex , &pSequence->frames[frameIndex]);
+        UpdateCeiling(xindex, pFrame);
         break;
     case 2:
-        UpdateFloor(pActive->xindex, &pSequence->frames[frameIndex]);
+        UpdateFloor(xindex, pFrame);
         break;
     case 3: 
     {
 
-        UpdateSprite(pActive->xindex, &pSequence->frames[frameIndex]);
-        if (pSequence->frames[frameIndex].at6_1) {
+        UpdateSprite(xindex, pFrame);
+        if (pFrame->at6_1) {
             
             int sound = pSequence->ata;
             
             // by NoOne: add random sound range feature
-            if (!VanillaMode() && pSequence->frames[frameIndex].soundRange > 0)
-                sound += Random(((pSequence->frames[frameIndex].soundRange == 1) ? 2 : pSequence->frames[frameIndex].soundRange));
+            if (!VanillaMode() && pFrame->soundRange > 0)
+                sound += Random(((pFrame->soundRange == 1) ? 2 : pFrame->soundRange));
             
-            sfxPlay3DSound(&sprite[xsprite[pActive->xindex].reference], sound, -1, 0);
+            sfxPlay3DSound(&sprite[xsprite[xindex].reference], sound, -1, 0);
         }
 
         
         // by NoOne: add surfaceSound trigger feature
-        spritetype* pSprite = &sprite[xsprite[pActive->xindex].reference];
-        if (!VanillaMode() && pSequence->frames[frameIndex].surfaceSound && zvel[pSprite->index] == 0 && xvel[pSprite->index] != 0) {
+        spritetype* pSprite = &sprite[xsprite[xindex].reference];
+        if (!VanillaMode() && pFrame->surfaceSound && zvel[pSprite->index] == 0 && xvel[pSprite->index] != 0) {
             
             if (gUpperLink[pSprite->sectnum] >= 0) break; // don't play surface sound for stacked sectors
             int surf = tileGetSurfType(pSprite->sectnum + 0x4000); if (!surf) break;
@@ -340,14 +351,14 @@ void SEQINST::Update(ACTIVE *pActive)
         break;
     }
     case 4:
-        UpdateMasked(pActive->xindex, &pSequence->frames[frameIndex]);
+        UpdateMasked(xindex, pFrame);
         break;
     }
-    if (pSequence->frames[frameIndex].at5_5 && atc != -1)
-        clientCallback[atc](pActive->type, pActive->xindex);
+    if (pFrame->at5_5 && atc != -1)
+        clientCallback[atc](type, xindex);
 }
 
-SEQINST * GetInstance(int a1, int a2)
+static SEQSLOT *GetSlot(int a1, int a2)
 {
     switch (a1)
     {
@@ -364,13 +375,21 @@ SEQINST * GetInstance(int a1, int a2)
         if (a2 > 0 && a2 < kMaxXSprites) return &siSprite[a2];
         break;
     case 4:
-        if (a2 > 0 && a2 < kMaxWalls) return &siMasked[a2];
+        if (a2 > 0 && a2 < kMaxXWalls) return &siMasked[a2];
         break;
     }
     return NULL;
 }
 
-void UnlockInstance(SEQINST *pInst)
+static SEQINST *GetInstance(int a1, int a2)
+{
+    SEQSLOT *pSlot = GetSlot(a1, a2);
+    if (!pSlot || !pSlot->nInst)
+        return NULL;
+    return &activeList[pSlot->nInst - 1];
+}
+
+static void UnlockInstance(SEQINST *pInst)
 {
     dassert(pInst != NULL);
     dassert(pInst->hSeq != NULL);
@@ -381,27 +400,37 @@ void UnlockInstance(SEQINST *pInst)
     pInst->at13 = 0;
 }
 
+// The last instance takes the place of the removed one, same as it always did,
+// so everything keeps getting processed in the same order.
+static void RemoveInstance(int nInst)
+{
+    dassert(nInst >= 0 && nInst < activeCount);
+    SEQINST *pInst = &activeList[nInst];
+    GetSlot(pInst->type, pInst->xindex)->nInst = 0;
+    activeCount--;
+    if (nInst < activeCount)
+    {
+        *pInst = activeList[activeCount];
+        GetSlot(pInst->type, pInst->xindex)->nInst = nInst + 1;
+    }
+}
+
 void seqSpawn(int a1, int a2, int a3, int a4)
 {
-    SEQINST *pInst = GetInstance(a2, a3);
-    if (!pInst) return;
+    SEQSLOT *pSlot = GetSlot(a2, a3);
+    if (!pSlot) return;
     
     DICTNODE *hSeq = gSysRes.Lookup(a1, "SEQ");
     if (!hSeq)
         ThrowError("Missing sequence #%d", a1);
 
-    int i = activeCount;
-    if (pInst->at13)
+    SEQINST *pInst = NULL;
+    if (pSlot->nInst)
     {
+        pInst = &activeList[pSlot->nInst - 1];
         if (hSeq == pInst->hSeq)
             return;
         UnlockInstance(pInst);
-        for (i = 0; i < activeCount; i++)
-        {
-            if (activeList[i].type == a2 && activeList[i].xindex == a3)
-                break;
-        }
-        dassert(i < activeCount);
     }
     Seq *pSeq = (Seq*)gSysRes.Lock(hSeq);
     if (memcmp(pSeq->signature, "SEQ\x1a", 4) != 0)
@@ -413,6 +442,14 @@ void seqSpawn(int a1, int a2, int a3, int a4)
         for (int i = 0; i < pSeq->nFrames; i++)
             pSeq->frames[i].tile2 = 0;
     }
+    if (!pInst)
+    {
+        dassert(activeCount < kMaxSequences);
+        pInst = &activeList[activeCount++];
+        pInst->type = a2;
+        pInst->xindex = a3;
+        pSlot->nInst = activeCount;
+    }
     pInst->at13 = 1;
     pInst->hSeq = hSeq;
     pInst->pSequence = pSeq;
@@ -420,54 +457,30 @@ void seqSpawn(int a1, int a2, int a3, int a4)
     pInst->atc = a4;
     pInst->at10 = pSeq->at8;
     pInst->frameIndex = 0;
-    if (i == activeCount)
-    {
-        dassert(activeCount < kMaxSequences);
-        activeList[activeCount].type = a2;
-        activeList[activeCount].xindex = a3;
-        activeCount++;
-    }
-    pInst->Update(&activeList[i]);
+    pSlot->nSeq = a1;
+    pInst->Update();
 }
 
 void seqKill(int a1, int a2)
 {
-    SEQINST *pInst = GetInstance(a1, a2);
-    if (!pInst || !pInst->at13)
+    SEQSLOT *pSlot = GetSlot(a1, a2);
+    if (!pSlot || !pSlot->nInst)
+        return;
+    SEQINST *pInst = &activeList[pSlot->nInst - 1];
+    if (!pInst->at13)
         return;
-    int i;
-    for (i = 0; i < activeCount; i++)
-    {
-        if (activeList[i].type == a1 && activeList[i].xindex == a2)
-            break;
-    }
-    dassert(i < activeCount);
-    activeCount--;
-    activeList[i] = activeList[activeCount];
-    pInst->at13 = 0;
     UnlockInstance(pInst);
+    RemoveInstance(pSlot->nInst - 1);
 }
 
 void seqKillAll(void)
 {
-    for (int i = 0; i < kMaxXWalls; i++)
-    {
-        if (siWall[i].at13)
-            UnlockInstance(&siWall[i]);
-        if (siMasked[i].at13)
-            UnlockInstance(&siMasked[i]);
-    }
-    for (int i = 0; i < kMaxXSectors; i++)
-    {
-        if (siCeiling[i].at13)
-            UnlockInstance(&siCeiling[i]);
-        if (siFloor[i].at13)
-            UnlockInstance(&siFloor[i]);
-    }
-    for (int i = 0; i < kMaxXSprites; i++)
+    for (int i = 0; i < activeCount; i++)
     {
-        if (siSprite[i].at13)
-            UnlockInstance(&siSprite[i]);
+        SEQINST *pInst = &activeList[i];
+        if (pInst->at13)
+            UnlockInstance(pInst);
+        GetSlot(pInst->type, pInst->xindex)->nInst = 0;
     }
     activeCount = 0;
 }
@@ -482,9 +495,9 @@ int seqGetStatus(int a1, int a2)
 
 int seqGetID(int a1, int a2)
 {
-    SEQINST *pInst = GetInstance(a1, a2);
-    if (pInst)
-        return pInst->at8;
+    SEQSLOT *pSlot = GetSlot(a1, a2);
+    if (pSlot)
+        return pSlot->nSeq;
     return -1;
 }
 
@@ -492,7 +505,7 @@ void seqProcess(int a1)
 {
     for (int i = 0; i < activeCount; i++)
     {
-        SEQINST *pInst = GetInstance(activeList[i].type, activeList[i].xindex);
+        SEQINST *pInst = &activeList[i];
         Seq *pSeq = pInst->pSequence;
         dassert(pInst->frameIndex < pSeq->nFrames);
         pInst->at10 -= a1;
@@ -506,14 +519,17 @@ void seqProcess(int a1)
                     pInst->frameIndex = 0;
                 else
                 {
+                    // Take it off the list before anything else can spawn or kill a sequence.
+                    int nType = pInst->type, nXIndex = pInst->xindex;
                     UnlockInstance(pInst);
+                    RemoveInstance(i--);
                     if (pSeq->atc & 2)
                     {
-                        switch (activeList[i].type)
+                        switch (nType)
                         {
                         case 3:
                         {
-                            int nXSprite = activeList[i].xindex;
+                            int nXSprite = nXIndex;
                             int nSprite = xsprite[nXSprite].reference;
                             dassert(nSprite >= 0 && nSprite < kMaxSprites);
                             evKill(nSprite, 3);
@@ -525,7 +541,7 @@ void seqProcess(int a1)
                         }
                         case 4:
                         {
-                            int nXWall = activeList[i].xindex;
+                            int nXWall = nXIndex;
                             int nWall = xwall[nXWall].reference;
                             dassert(nWall >= 0 && nWall < kMaxWalls);
                             wall[nWall].cstat &= ~(8 + 16 + 32);
@@ -535,11 +551,17 @@ void seqProcess(int a1)
                         }
                         }
                     }
-                    activeList[i--] = activeList[--activeCount];
                     break;
                 }
             }
-            pInst->Update(&activeList[i]);
+            int nType = pInst->type, nXIndex = pInst->xindex;
+            pInst->Update();
+            // A frame callback can kill or respawn sequences, which moves instances
+            // around in the list. Stay with this object's instance like the old
+            // per-object storage did; the one moved into slot i waits for the next tick.
+            pInst = GetInstance(nType, nXIndex);
+            if (!pInst)
+                break;
         }
     }
 }
@@ -556,30 +578,13 @@ void SeqLoadSave::Load(void)
     Read(&siCeiling, sizeof(siCeiling));
     Read(&siFloor, sizeof(siFloor));
     Read(&siSprite, sizeof(siSprite));
-    Read(&activeList, sizeof(activeList));
     Read(&activeCount, sizeof(activeCount));
-    for (int i = 0; i < kMaxXWalls; i++)
-    {
-        siWall[i].hSeq = NULL;
-        siMasked[i].hSeq = NULL;
-        siWall[i].pSequence = NULL;
-        siMasked[i].pSequence = NULL;
-    }
-    for (int i = 0; i < kMaxXSectors; i++)
-    {
-        siCeiling[i].hSeq = NULL;
-        siFloor[i].hSeq = NULL;
-        siCeiling[i].pSequence = NULL;
-        siFloor[i].pSequence = NULL;
-    }
-    for (int i = 0; i < kMaxXSprites; i++)
-    {
-        siSprite[i].hSeq = NULL;
-        siSprite[i].pSequence = NULL;
-    }
+    Read(activeList, activeCount * sizeof(activeList[0]));
     for (int i = 0; i < activeCount; i++)
     {
-        SEQINST *pInst = GetInstance(activeList[i].type, activeList[i].xindex);
+        SEQINST *pInst = &activeList[i];
+        pInst->hSeq = NULL;
+        pInst->pSequence = NULL;
         if (pInst->at13)
         {
             int nSeq = pInst->at8;
@@ -606,8 +611,8 @@ void SeqLoadSave::Save(void)
     Write(&siCeiling, sizeof(siCeiling));
     Write(&siFloor, sizeof(siFloor));
     Write(&siSprite, sizeof(siSprite));
-    Write(&activeList, sizeof(activeList));
     Write(&activeCount, sizeof(activeCount));
+    Write(activeList, activeCount * sizeof(activeList[0]));
 }
 
 static SeqLoadSave *myLoadSave;
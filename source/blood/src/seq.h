@@ -61,12 +61,6 @@ struct Seq {
     void Precache(void);
 };
 
-struct ACTIVE
-{
-    unsigned char type;
-    unsigned short xindex;
-};
-
 struct SEQINST
 {
     DICTNODE *hSeq;
@@ -76,7 +70,9 @@ struct SEQINST
     short at10;
     unsigned char frameIndex;
     char at13;
-    void Update(ACTIVE *pActive);
+    unsigned char type;
+    unsigned short xindex;
+    void Update(void);
 };
 
 inline int seqGetTile(SEQFRAME* pFrame)
@@ -86,8 +82,6 @@ inline int seqGetTile(SEQFRAME* pFrame)
 
 int seqRegisterClient(void(*pClient)(int, int));
 void seqPrecacheId(int id);
-SEQINST * GetInstance(int a1, int a2);
-void UnlockInstance(SEQINST *pInst);
 void seqSpawn(int a1, int a2, int a3, int a4 = -1);
 void seqKill(int a1, int a2);
 void seqKillAll(void);
@@ -832,6 +832,7 @@ void DragPoint(int nWall, int x, int y)
     viewInterpolateWall(nWall, &wall[nWall]);
     wall[nWall].x = x;
     wall[nWall].y = y;
+    pvsWallMoved(nWall);
 
     int vsi = numwalls;
     int vb = nWall;
@@ -843,6 +844,7 @@ void DragPoint(int nWall, int x, int y)
             viewInterpolateWall(vb, &wall[vb]);
             wall[vb].x = x;
             wall[vb].y = y;
+            pvsWallMoved(vb);
         }
         else
         {
@@ -855,6 +857,7 @@ void DragPoint(int nWall, int x, int y)
                     viewInterpolateWall(vb, &wall[vb]);
                     wall[vb].x = x;
                     wall[vb].y = y;
+                    pvsWallMoved(vb);
                 }
                 else
                     break;
@@ -2032,17 +2035,12 @@ void trInit(void)
         baseWall[i].x = wall[i].x;
         baseWall[i].y = wall[i].y;
     }
-    for (int i = 0; i < kMaxSprites; i++)
+    for (int i = dbNextSprite(-1); i >= 0; i = dbNextSprite(i))
     {
-        if (sprite[i].statnum < kStatFree)
-        {
-            sprite[i].inittype = sprite[i].type;
-            baseSprite[i].x = sprite[i].x;
-            baseSprite[i].y = sprite[i].y;
-            baseSprite[i].z = sprite[i].z;
-        }
-        else
-            sprite[i].inittype = -1;
+        sprite[i].inittype = sprite[i].type;
+        baseSprite[i].x = sprite[i].x;
+        baseSprite[i].y = sprite[i].y;
+        baseSprite[i].z = sprite[i].z;
     }
     for (int i = 0; i < numwalls; i++)
     {
@@ -2131,7 +2129,7 @@ void trInit(void)
             }
         }
     }
-    for (int i = 0; i < kMaxSprites; i++)
+    for (int i = dbNextSprite(-1); i >= 0; i = dbNextSprite(i))
     {
         int nXSprite = sprite[i].extra;
         if (sprite[i].statnum < kStatFree && nXSprite > 0)
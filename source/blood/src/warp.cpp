@@ -52,7 +52,7 @@ void warpInit(void)
     #ifdef NOONE_EXTENSIONS
     int team1 = 0; int team2 = 0; gTeamsSpawnUsed = false; // increment if team start positions specified.
     #endif
-    for (int nSprite = 0; nSprite < kMaxSprites; nSprite++)
+    for (int nSprite = dbNextSprite(-1); nSprite >= 0; nSprite = dbNextSprite(nSprite))
     {
         if (sprite[nSprite].statnum < kMaxStatus) {
             spritetype *pSprite = &sprite[nSprite];
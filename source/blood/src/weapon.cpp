@@ -1093,9 +1093,7 @@ void ThrowRemote(int, PLAYER *pPlayer)
     int nSpeed = mulscale16(pPlayer->throwPower, 0x177777)+0x66666;
     sfxPlay3DSound(pPlayer->pSprite, 455, 1, 0);
     spritetype *pSprite = playerFireThing(pPlayer, 0, -9460, kThingArmedRemoteBomb, nSpeed);
-    int nXSprite = pSprite->extra;
-    XSPRITE *pXSprite = &xsprite[nXSprite];
-    pXSprite->rxID = 90+(pPlayer->pSprite->type-kDudePlayer1);
+    dbSetXSpriteRX(pSprite->extra, 90+(pPlayer->pSprite->type-kDudePlayer1));
     UseAmmo(pPlayer, 11, 1);
     pPlayer->throwPower = 0;
 }
@@ -1103,9 +1101,7 @@ void ThrowRemote(int, PLAYER *pPlayer)
 void DropRemote(int, PLAYER *pPlayer)
 {
     spritetype *pSprite = playerFireThing(pPlayer, 0, 0, kThingArmedRemoteBomb, 0);
-    int nXSprite = pSprite->extra;
-    XSPRITE *pXSprite = &xsprite[nXSprite];
-    pXSprite->rxID = 90+(pPlayer->pSprite->type-kDudePlayer1);
+    dbSetXSpriteRX(pSprite->extra, 90+(pPlayer->pSprite->type-kDudePlayer1));
     UseAmmo(pPlayer, 11, 1);
 }
 
@@ -2476,12 +2472,14 @@ void sub_51340(spritetype *pMissile, int a2)
     gAffectedSectors[0] = -1;
     gAffectedXWalls[0] = -1;
     GetClosestSpriteSectors(nSector, x, y, nDist, gAffectedSectors, va4, gAffectedXWalls);
+    SectorStatIterator itDude(kStatDude, gAffectedSectors);
+    SectorStatIterator itThing(kStatThing, gAffectedSectors);
     char v4 = 1;
     int v24 = -1;
     actHitcodeToData(a2, &gHitInfo, &v24, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
     if (a2 == 3 && v24 >= 0 && sprite[v24].statnum == kStatDude)
         v4 = 0;
-    for (int nSprite = headspritestat[kStatDude]; nSprite >= 0; nSprite = nextspritestat[nSprite])
+    for (int nSprite = itDude.NextIndex(); nSprite >= 0; nSprite = itDude.NextIndex())
     {
         if (nSprite != nOwner || v4)
         {
@@ -2499,7 +2497,7 @@ void sub_51340(spritetype *pMissile, int a2)
             }
         }
     }
-    for (int nSprite = headspritestat[kStatThing]; nSprite >= 0; nSprite = nextspritestat[nSprite])
+    for (int nSprite = itThing.NextIndex(); nSprite >= 0; nSprite = itThing.NextIndex())
     {
         spritetype *pSprite = &sprite[nSprite];
         if (pSprite->flags&32)
@@ -452,6 +452,10 @@ static FORCE_INLINE void sprite_tracker_hook__(intptr_t const address)
 }
 #endif
 
+// Sprites that get moved for the view being drawn, see common/interpolate.cpp.
+EXTERN uint8_t interpolatedsprite[(MAXSPRITES+7)>>3];
+void InterpolateTSprite(tspriteptr_t tspr, int spritenum);
+
 static inline tspriteptr_t renderMakeTSpriteFromSprite(tspriteptr_t const tspr, uint16_t const spritenum)
 {
     auto const spr = (uspriteptr_t)&sprite[spritenum];
@@ -477,6 +481,9 @@ static inline tspriteptr_t renderMakeTSpriteFromSprite(tspriteptr_t const tspr,
     tspr->clipdist = 0;
     tspr->owner = spritenum;
 
+    if (bitmap_test(interpolatedsprite, spritenum))
+        InterpolateTSprite(tspr, spritenum);
+
     return tspr;
 }
 
@@ -901,6 +908,13 @@ void   neartag(int32_t xs, int32_t ys, int32_t zs, int16_t sectnum, int16_t ange
 int32_t   cansee(int32_t x1, int32_t y1, int32_t z1, int16_t sect1,
                  int32_t x2, int32_t y2, int32_t z2, int16_t sect2);
 int32_t   inside(int32_t x, int32_t y, int16_t sectnum);
+
+// Precomputed sector visibility, see pvs.cpp. pvsWallMoved() must be called
+// for every wall that changes its position outside of dragpoint().
+void      pvsInit(bool writecache);
+void      pvsUpdateGeometry(void);
+void      pvsWallMoved(int wallnum);
+bool      pvsMaybeVisible(int32_t x1, int32_t y1, int sect1, int32_t x2, int32_t y2, int sect2);
 void   dragpoint(int16_t pointhighlight, int32_t dax, int32_t day, uint8_t flags);
 void   setfirstwall(int16_t sectnum, int16_t newfirstwall);
 int32_t try_facespr_intersect(uspriteptr_t const spr, vec3_t const in,
@@ -3330,6 +3330,11 @@ static int32_t engineFinishLoadBoard(const vec3_t *dapos, int16_t *dacursectnum,
 
     guniqhudid = 0;
 
+#ifdef HAVE_CLIPSHAPE_FEATURE
+    if (!quickloadboard)
+#endif
+        pvsInit(true);
+
     return numremoved;
 }
 
@@ -4271,6 +4276,9 @@ int32_t cansee(int32_t x1, int32_t y1, int32_t z1, int16_t sect1, int32_t x2, in
 
     Bmemset(&pendingvec, 0, sizeof(vec3_t));  // compiler-happy
 #endif
+    if (!pvsMaybeVisible(x1, y1, sect1, x2, y2, sect2))
+        return 0;
+
     Bmemset(sectbitmap, 0, sizeof(sectbitmap));
 #ifdef YAX_ENABLE
 restart_grand:
@@ -4563,6 +4571,7 @@ void dragpoint(int16_t pointhighlight, int32_t dax, int32_t day, uint8_t flags)
             wall[w].x = dax;
             wall[w].y = day;
             walbitmap[w>>3] |= pow2char[w&7];
+            pvsWallMoved(w);
 
             for (YAX_ITER_WALLS(w, j, tmpcf))
             {
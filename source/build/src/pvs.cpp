@@ -0,0 +1,556 @@
+/*
+** pvs.cpp
+** Precomputed sector visibility for line of sight checks
+**
+**---------------------------------------------------------------------------
+** Copyright 2020 Raze developers and contributors
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** cansee() floods from the first sector through every wall the line
+** crosses, in whatever order it finds them. So the second sector can only
+** be reached if there is a chain of portals from one to the other that a
+** single straight line crosses, each one from the front. That only depends
+** on the map's walls, so it can be worked out once per map for every pair
+** of sectors. Where no such line exists, cansee() can say no right away.
+**
+** A line crosses portals a->b from the front if all the a's are on one
+** side of it and all the b's on the other, so for a chain of portals the
+** question is whether those two sets of points can be separated by a line.
+** That is tracked exactly, with integers, while walking the chains.
+**
+*/
+
+#include <atomic>
+#include <thread>
+
+#include "build.h"
+#include "baselayer.h"
+#include "gamecvars.h"
+#include "files.h"
+#include "i_specialpaths.h"
+#include "md4.h"
+
+#define PVS_CACHE_MAGIC "BPVS"
+#define PVS_CACHE_VERSION 1
+
+enum
+{
+    PVS_MAXTHREADS = 16,
+    PVS_MAXCOORD = 1 << 28,  // keeps all the products below in 64 bits
+    PVS_MAXWORK = 1 << 22,  // per sector; past this it gets seen from everywhere
+};
+
+struct PVSWall
+{
+    int32_t x, y;
+    int16_t point2, nextsector;
+};
+
+struct PVSSector
+{
+    int16_t wallptr, wallnum;
+};
+
+// Where the walls of a sector, or everything a sector might see, are, and
+// how long the longest of them is.
+struct PVSBounds
+{
+    int32_t x1, y1, x2, y2;
+    int32_t span;
+
+    void Add(const PVSBounds &other)
+    {
+        x1 = min(x1, other.x1); y1 = min(y1, other.y1);
+        x2 = max(x2, other.x2); y2 = max(y2, other.y2);
+        span = max(span, other.span);
+    }
+};
+
+struct PVSCacheHeader
+{
+    char magic[4];
+    int version;
+    int numsectors;
+    uint8_t key[16];
+};
+
+// The map as it was when the visibility got built. The builder threads only
+// ever look at this, never at the live map.
+static TArray<PVSWall> pvsWalls;
+static TArray<PVSSector> pvsSectors;
+static TArray<int16_t> pvsWallSector;
+static TArray<PVSBounds> pvsSectorBounds;
+static uint8_t pvsKey[16];
+
+static int pvsNumSectors;  // 0 if there is nothing to use
+static int pvsRowSize;  // in 64 bit words
+static TArray<uint64_t> pvsMatrix;
+static TArray<PVSBounds> pvsRowBounds;
+static const uint64_t *pvsRows;  // set once the matrix may be used
+
+// Sectors whose walls moved since the snapshot, and the ones that could see
+// one of those. Only the latter lose their early out.
+static uint8_t pvsDynamic[MAXSECTORS];
+static uint8_t pvsRowDynamic[MAXSECTORS];
+
+//==========================================================================
+//
+// The set of directions a line may have to still cross all portals so far.
+// It's either everything or runs counterclockwise from l to r, never more
+// than half a turn.
+//
+//==========================================================================
+
+struct PVSCone
+{
+    int64_t lx, ly, rx, ry;
+    bool full;
+
+    // Keeps the directions n with n.v >= 0, returns false if none are left.
+    // Where the result would be two opposite rays the cone is left alone,
+    // which only makes it let through more than it must.
+    bool Clip(int64_t vx, int64_t vy)
+    {
+        if (vx == 0 && vy == 0) return true;
+        if (full)
+        {
+            full = false;
+            lx = vy; ly = -vx;
+            rx = -vy; ry = vx;
+            return true;
+        }
+        int64_t const dl = lx * vx + ly * vy;
+        int64_t const dr = rx * vx + ry * vy;
+        if (dl >= 0 && dr >= 0) return true;
+        if (dl < 0 && dr < 0) return false;
+        if (dl >= 0) { rx = -vy; ry = vx; }
+        else { lx = vy; ly = -vx; }
+        return true;
+    }
+};
+
+//==========================================================================
+//
+// Finds everything one sector can possibly see by walking all chains of
+// portals out of it that a line can still cross. A chain never needs to
+// enter a sector twice: the part in between can be left out and the rest
+// is still crossed by the same line.
+//
+//==========================================================================
+
+struct PVSRowBuilder
+{
+    struct Frame
+    {
+        int sect, wall, end;
+        PVSCone cone;
+    };
+
+    TArray<Frame> stack;
+    TArray<vec2_t> front, back;  // the a's and b's of the portals on the way
+    TArray<uint8_t> onPath;
+
+    PVSRowBuilder()
+    {
+        stack.Resize(pvsNumSectors);
+        front.Resize(pvsNumSectors);
+        back.Resize(pvsNumSectors);
+        onPath.Resize(pvsNumSectors);
+        memset(onPath.Data(), 0, pvsNumSectors);
+    }
+
+    void Build(int src, uint64_t *row)
+    {
+        Walk(src, row);
+
+        PVSBounds &bounds = pvsRowBounds[src];
+        bounds = pvsSectorBounds[src];
+        for (int i = 0; i < pvsNumSectors; i++)
+            if (row[i >> 6] & (1ull << (i & 63))) bounds.Add(pvsSectorBounds[i]);
+    }
+
+    void Walk(int src, uint64_t *row)
+    {
+        memset(row, 0, pvsRowSize * sizeof(uint64_t));
+        row[src >> 6] |= 1ull << (src & 63);
+
+        int depth = 0, work = PVS_MAXWORK;
+        stack[0] = { src, pvsSectors[src].wallptr, pvsSectors[src].wallptr + pvsSectors[src].wallnum, {} };
+        stack[0].cone.full = true;
+        onPath[src] = 1;
+
+        while (depth >= 0)
+        {
+            Frame &f = stack[depth];
+            if (f.wall == f.end)
+            {
+                onPath[f.sect] = 0;
+                depth--;
+                continue;
+            }
+
+            auto const &wal = pvsWalls[f.wall++];
+            int const next = wal.nextsector;
+            if (next < 0 || onPath[next]) continue;
+
+            work -= depth + 1;
+            if (work < 0)
+            {
+                // Too many ways through here to follow them all.
+                for (int i = 0; i < pvsNumSectors; i++) onPath[i] = 0;
+                for (int i = 0; i < pvsNumSectors; i++) row[i >> 6] |= 1ull << (i & 63);
+                return;
+            }
+
+            vec2_t const a = { wal.x, wal.y };
+            vec2_t const b = { pvsWalls[wal.point2].x, pvsWalls[wal.point2].y };
+            PVSCone cone = f.cone;
+            bool ok = cone.Clip(int64_t(b.x) - a.x, int64_t(b.y) - a.y);
+            for (int i = 0; ok && i < depth; i++)
+            {
+                ok = cone.Clip(int64_t(back[i].x) - a.x, int64_t(back[i].y) - a.y) &&
+                    cone.Clip(int64_t(b.x) - front[i].x, int64_t(b.y) - front[i].y);
+            }
+            if (!ok) continue;
+
+            front[depth] = a;
+            back[depth] = b;
+            row[next >> 6] |= 1ull << (next & 63);
+            onPath[next] = 1;
+            depth++;
+            stack[depth] = { next, pvsSectors[next].wallptr, pvsSectors[next].wallptr + pvsSectors[next].wallnum, cone };
+        }
+    }
+};
+
+//==========================================================================
+//
+// Building happens in the background while the map gets played. Until it's
+// done, cansee() just doesn't get the early out.
+//
+//==========================================================================
+
+struct FPVSBuilder
+{
+    std::thread Threads[PVS_MAXTHREADS];
+    int NumThreads = 0;
+    std::atomic<int> NextRow, RowsDone;
+    std::atomic<bool> Abort, Ready;
+    FString CacheName;
+    double StartTime = 0, BuildTime = 0;
+
+    ~FPVSBuilder()
+    {
+        Stop();
+    }
+
+    void Start(const char *cachename)
+    {
+        CacheName = cachename;
+        NextRow = RowsDone = 0;
+        Abort = Ready = false;
+        StartTime = timerGetHiTicks();
+
+        // The game keeps one core to itself.
+        NumThreads = clamp<int>(std::thread::hardware_concurrency() - 1, 1, PVS_MAXTHREADS);
+        for (int i = 0; i < NumThreads; i++)
+            Threads[i] = std::thread([this]() { Work(); });
+    }
+
+    void Stop()
+    {
+        Abort = true;
+        for (int i = 0; i < NumThreads; i++)
+            Threads[i].join();
+        NumThreads = 0;
+    }
+
+    void Work()
+    {
+        PVSRowBuilder builder;
+        int row;
+        while (!Abort && (row = NextRow++) < pvsNumSectors)
+        {
+            builder.Build(row, &pvsMatrix[row * pvsRowSize]);
+            if (++RowsDone == pvsNumSectors)
+            {
+                BuildTime = timerGetHiTicks() - StartTime;
+                WriteCache();
+                Ready.store(true, std::memory_order_release);
+            }
+        }
+    }
+
+    void WriteCache()
+    {
+        if (CacheName.IsEmpty()) return;
+        FileWriter *fw = FileWriter::Open(CacheName);
+        if (!fw) return;
+
+        PVSCacheHeader header;
+        memcpy(header.magic, PVS_CACHE_MAGIC, 4);
+        header.version = PVS_CACHE_VERSION;
+        header.numsectors = pvsNumSectors;
+        memcpy(header.key, pvsKey, 16);
+        fw->Write(&header, sizeof(header));
+        fw->Write(pvsMatrix.Data(), pvsMatrix.Size() * sizeof(uint64_t));
+        fw->Write(pvsRowBounds.Data(), pvsRowBounds.Size() * sizeof(PVSBounds));
+        delete fw;
+    }
+};
+
+static FPVSBuilder pvsBuilder;
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static void pvsMarkRows(int sectnum)
+{
+    for (int i = 0; i < pvsNumSectors; i++)
+    {
+        if (pvsRows[i * pvsRowSize + (sectnum >> 6)] & (1ull << (sectnum & 63)))
+            pvsRowDynamic[i] = 1;
+    }
+}
+
+static void pvsFinish(void)
+{
+    pvsBuilder.Stop();
+    pvsRows = pvsMatrix.Data();
+    for (int i = 0; i < pvsNumSectors; i++)
+        if (pvsDynamic[i]) pvsMarkRows(i);
+    DPrintf(DMSG_NOTIFY, "Sector visibility for %d sectors built in %.1f ms\n", pvsNumSectors, pvsBuilder.BuildTime);
+}
+
+static void pvsClear(void)
+{
+    pvsBuilder.Stop();
+    pvsNumSectors = 0;
+    pvsRows = nullptr;
+    memset(pvsDynamic, 0, sizeof(pvsDynamic));
+    memset(pvsRowDynamic, 0, sizeof(pvsRowDynamic));
+}
+
+static FString pvsCacheFileName(void)
+{
+    return FStringf("%s/pvs_%08x%08x.bin", M_GetAppDataPath(true).GetChars(), B_BIG32(*(uint32_t*)&pvsKey[0]), B_BIG32(*(uint32_t*)&pvsKey[4]));
+}
+
+static bool pvsReadCache(const char *filename)
+{
+    FileReader fr;
+    if (!fr.OpenFile(filename)) return false;
+
+    PVSCacheHeader header;
+    size_t const size = pvsMatrix.Size() * sizeof(uint64_t);
+    size_t const boundssize = pvsRowBounds.Size() * sizeof(PVSBounds);
+    if (fr.GetLength() != (long)(sizeof(header) + size + boundssize) || fr.Read(&header, sizeof(header)) != sizeof(header))
+        return false;
+    if (memcmp(header.magic, PVS_CACHE_MAGIC, 4) || header.version != PVS_CACHE_VERSION ||
+        header.numsectors != pvsNumSectors || memcmp(header.key, pvsKey, 16))
+        return false;
+    return fr.Read(pvsMatrix.Data(), size) == (long)size && fr.Read(pvsRowBounds.Data(), boundssize) == (long)boundssize;
+}
+
+// Takes the snapshot. Returns false for maps this can't deal with.
+static bool pvsTakeSnapshot(void)
+{
+#ifdef YAX_ENABLE
+    if (numyaxbunches > 0) return false;
+#endif
+    if (numsectors <= 0 || numsectors > MAXSECTORS || numwalls <= 0 || numwalls > MAXWALLS)
+        return false;
+
+    pvsSectors.Resize(numsectors);
+    for (int i = 0; i < numsectors; i++)
+    {
+        auto const &sec = sector[i];
+        if (sec.wallptr < 0 || sec.wallnum < 0 || sec.wallptr + sec.wallnum > numwalls)
+            return false;
+        pvsSectors[i] = { sec.wallptr, sec.wallnum };
+    }
+
+    pvsWalls.Resize(numwalls);
+    pvsWallSector.Resize(numwalls);
+    for (int i = 0; i < numwalls; i++)
+    {
+        auto const &wal = wall[i];
+        if ((unsigned)wal.point2 >= (unsigned)numwalls || wal.nextsector < -1 || wal.nextsector >= numsectors ||
+            abs(wal.x) >= PVS_MAXCOORD || abs(wal.y) >= PVS_MAXCOORD)
+            return false;
+        pvsWalls[i] = { wal.x, wal.y, wal.point2, wal.nextsector };
+        pvsWallSector[i] = -1;
+    }
+
+    pvsSectorBounds.Resize(numsectors);
+    for (int i = 0; i < numsectors; i++)
+    {
+        PVSBounds &bounds = pvsSectorBounds[i];
+        bounds = { INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN, 0 };
+        for (int j = pvsSectors[i].wallptr; j < pvsSectors[i].wallptr + pvsSectors[i].wallnum; j++)
+        {
+            auto const &wal = pvsWalls[j];
+            auto const &wal2 = pvsWalls[wal.point2];
+            bounds.Add({ wal.x, wal.y, wal.x, wal.y, max(abs(wal.x - wal2.x), abs(wal.y - wal2.y)) });
+            pvsWallSector[j] = i;
+        }
+    }
+
+    TArray<uint8_t> key;
+    key.Resize(pvsSectors.Size() * sizeof(PVSSector) + pvsWalls.Size() * sizeof(PVSWall));
+    memcpy(key.Data(), pvsSectors.Data(), pvsSectors.Size() * sizeof(PVSSector));
+    memcpy(key.Data() + pvsSectors.Size() * sizeof(PVSSector), pvsWalls.Data(), pvsWalls.Size() * sizeof(PVSWall));
+    md4once(key.Data(), key.Size(), pvsKey);
+    return true;
+}
+
+// Is the map still laid out the way the snapshot says, apart from where
+// the walls are?
+static bool pvsSameLayout(void)
+{
+    if (numsectors != (int)pvsSectors.Size() || numwalls != (int)pvsWalls.Size())
+        return false;
+#ifdef YAX_ENABLE
+    if (numyaxbunches > 0) return false;
+#endif
+    for (int i = 0; i < numsectors; i++)
+        if (sector[i].wallptr != pvsSectors[i].wallptr || sector[i].wallnum != pvsSectors[i].wallnum)
+            return false;
+    return true;
+}
+
+//==========================================================================
+//
+// Called whenever a map has been loaded. Uses the cached matrix for the
+// map if there is one, otherwise starts building it.
+//
+//==========================================================================
+
+void pvsInit(bool writecache)
+{
+    pvsClear();
+    if (!pvs_enable || !pvsTakeSnapshot())
+        return;
+
+    pvsNumSectors = numsectors;
+    pvsRowSize = (numsectors + 63) >> 6;
+    pvsMatrix.Resize(pvsNumSectors * pvsRowSize);
+    pvsRowBounds.Resize(pvsNumSectors);
+
+    FString cachename = pvsCacheFileName();
+    if (pvsReadCache(cachename))
+    {
+        pvsRows = pvsMatrix.Data();
+        return;
+    }
+    pvsBuilder.Start(writecache ? cachename.GetChars() : "");
+}
+
+//==========================================================================
+//
+// For everything that changes the map other than by moving single walls,
+// like loading a savegame: walls that moved count as such, anything else
+// starts over.
+//
+//==========================================================================
+
+void pvsUpdateGeometry(void)
+{
+    if (pvsNumSectors == 0 || !pvsSameLayout())
+    {
+        pvsInit(false);
+        return;
+    }
+    for (int i = 0; i < numwalls; i++)
+    {
+        auto const &wal = wall[i];
+        auto const &snap = pvsWalls[i];
+        if (wal.x != snap.x || wal.y != snap.y || wal.point2 != snap.point2 || wal.nextsector != snap.nextsector)
+            pvsWallMoved(i);
+    }
+}
+
+//==========================================================================
+//
+// Must be called for every wall whose position or neighbor gets changed.
+// A moved wall can open up new lines only for sectors that could already
+// see the sector it belongs to: a line to anywhere new has to get to the
+// first sector with moved walls on its way through walls that didn't move.
+//
+//==========================================================================
+
+void pvsWallMoved(int wallnum)
+{
+    if (pvsNumSectors == 0)
+        return;
+    if ((unsigned)wallnum >= pvsWallSector.Size())
+    {
+        pvsClear();
+        return;
+    }
+    int const sectnum = pvsWallSector[wallnum];
+    if (sectnum < 0 || pvsDynamic[sectnum])
+        return;
+    pvsDynamic[sectnum] = 1;
+    if (pvsRows) pvsMarkRows(sectnum);
+}
+
+//==========================================================================
+//
+// Returns false only if cansee() along that line must fail.
+//
+// cansee() does its math in 32 bits and the wrapped around results can let
+// it through walls the line doesn't really cross. The matrix can't know
+// about those, so it is only trusted where nothing can overflow for any of
+// the walls the first sector can see.
+//
+//==========================================================================
+
+bool pvsMaybeVisible(int32_t x1, int32_t y1, int sect1, int32_t x2, int32_t y2, int sect2)
+{
+    if (!pvsRows)
+    {
+        if (pvsNumSectors == 0 || !pvsBuilder.Ready.load(std::memory_order_acquire))
+            return true;
+        pvsFinish();
+    }
+    if ((unsigned)sect1 >= (unsigned)pvsNumSectors || (unsigned)sect2 >= (unsigned)pvsNumSectors || !pvs_enable)
+        return true;
+    if (pvsRowDynamic[sect1] || (pvsRows[sect1 * pvsRowSize + (sect2 >> 6)] >> (sect2 & 63)) & 1)
+        return true;
+
+    auto const &bounds = pvsRowBounds[sect1];
+    int64_t const len = max(abs(int64_t(x2) - x1), abs(int64_t(y2) - y1));
+    int64_t const dist = max(max(int64_t(x1) - bounds.x1, int64_t(bounds.x2) - x1), max(int64_t(y1) - bounds.y1, int64_t(bounds.y2) - y1));
+    int64_t const span = bounds.span;
+    int64_t const limit = INT32_MAX / 2;
+    if (len > limit || dist > limit) return true;
+    return len * span > limit || len * dist > limit || dist * span > limit;
+}
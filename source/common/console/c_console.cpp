@@ -33,6 +33,8 @@
 */
 
 #include <string>
+#include <thread>
+#include <mutex>
 
 #include "templates.h"
 #include "version.h"
@@ -2125,3 +2127,60 @@ const char * OSD_StripColors(char *outBuf, const char *inBuf)
     *outBuf = '\0';
     return ptr;
 }
+
+//==========================================================================
+//
+// Standard input commands
+//
+// A dedicated server has no window to open the console in, so it reads
+// commands from standard input. Reading blocks, so it's done on a thread
+// of its own, and the lines are handed to the main thread which runs them
+// like anything typed into the console.
+//
+//==========================================================================
+
+static std::mutex StdinLock;
+static TArray<FString> StdinCommands;
+static bool StdinStarted;
+
+static void StdinProc()
+{
+	char line[1024];
+
+	while (fgets(line, sizeof(line), stdin))
+	{
+		FString command = line;
+		command.StripRight();
+
+		if (command.IsNotEmpty())
+		{
+			std::lock_guard<std::mutex> lock(StdinLock);
+			StdinCommands.Push(command);
+		}
+	}
+}
+
+void C_StartStdinCommands()
+{
+	if (StdinStarted) return;
+	StdinStarted = true;
+
+	// Nothing ever tells the thread to stop, it just goes away with the process.
+	std::thread(StdinProc).detach();
+}
+
+void C_RunStdinCommands()
+{
+	TArray<FString> commands;
+	{
+		std::lock_guard<std::mutex> lock(StdinLock);
+		if (StdinCommands.Size() == 0) return;
+		commands = std::move(StdinCommands);
+	}
+
+	for (auto& command : commands)
+	{
+		Printf(127, TEXTCOLOR_WHITE "]%s\n", command.GetChars());
+		AddCommandString(command);
+	}
+}
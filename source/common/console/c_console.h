@@ -84,6 +84,10 @@ void C_AddTabCommand (const char *name);
 void C_RemoveTabCommand (const char *name);
 void C_ClearTabCommands();		// Removes all tab commands
 
+// Console commands from standard input, for dedicated servers that have no console to type into
+void C_StartStdinCommands();
+void C_RunStdinCommands();
+
 extern const char *console_bar;
 
 #endif
@@ -37,6 +37,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "c_bind.h"
 #include "v_font.h"
 #include "c_console.h"
+#include "timedemo.h"
 #include "c_dispatch.h"
 #include "i_specialpaths.h"
 #include "z_music.h"
@@ -250,6 +251,15 @@ void UserConfig::ProcessOptions()
 	if (Args->CheckParm("-setup")) queryiwad = 1;
 	else if (Args->CheckParm("-nosetup")) queryiwad = 0;
 
+	dedicated = Args->CheckParm("-dedicated");
+	if (dedicated)
+	{
+		nologo = nomusic = nosound = true;
+
+		v = Args->CheckValue("-port");
+		if (v) netPort = strtol(v, nullptr, 0);
+	}
+
 
 	if (Args->CheckParm("-file"))
 	{
@@ -320,6 +330,7 @@ CVAR(Bool, duke_compatibility_15, false, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 void CheckFrontend(int flags)
 {
 	bool duke_compat = duke_compatibility_15;
+	bool dukefrontend = false;
 	// This point is too early to have cmdline CVAR checkers working so it must be with a switch.
 	auto c = Args->CheckValue("-duke_compatibility_15");
 	if (c)
@@ -346,6 +357,7 @@ void CheckFrontend(int flags)
 	else if ((flags & GAMEFLAG_FURY) || RazeStartupInfo.modern > 0)
 	{
 		gi = Duke::CreateInterface();
+		dukefrontend = true;
 	}
 	else if (RazeStartupInfo.modern < 0)
 	{
@@ -353,9 +365,15 @@ void CheckFrontend(int flags)
 	}
 	else
 	{
-		gi = *duke_compatibility_15 ? Redneck::CreateInterface() : Duke::CreateInterface();
+		dukefrontend = !*duke_compatibility_15;
+		gi = dukefrontend ? Duke::CreateInterface() : Redneck::CreateInterface();
 	}
 
+	// The game isn't known yet when the command line gets processed, so -dedicated is checked here.
+	if (userConfig.dedicated && !dukefrontend)
+	{
+		I_Error("-dedicated is only supported by Duke Nukem 3D and the games running on its code.");
+	}
 }
 
 void I_StartupJoysticks();
@@ -531,7 +549,7 @@ static TArray<GrpEntry> SetupGame()
 					stuff.Path = ExtractFileBase(found.FileName);
 					wads.Push(stuff);
 				}
-				pick = I_PickIWad(&wads[0], (int)wads.Size(), queryiwad, pick);
+				pick = I_PickIWad(&wads[0], (int)wads.Size(), queryiwad && !userConfig.dedicated, pick);
 				if (pick >= 0)
 				{
 					// The newly selected IWAD becomes the new default
@@ -622,6 +640,7 @@ int RunGame()
 	I_DetectOS();
 	SetClipshapes();
 	userConfig.ProcessOptions();
+	TimeDemo_Init();
 	G_LoadConfig();
 	ShutdownENet();
 	auto usedgroups = SetupGame();
@@ -701,7 +720,14 @@ int RunGame()
 		I_FatalError("app_main: There was a problem initializing the Build engine: %s\n", engineerrstr);
 	}
 
-	mouseGrabInput(true);	// the intros require the mouse to be grabbed.
+	if (userConfig.dedicated)
+	{
+		C_StartStdinCommands();
+	}
+	else
+	{
+		mouseGrabInput(true);	// the intros require the mouse to be grabbed.
+	}
 
 	auto exec = C_ParseCmdLineParams(nullptr);
 	if (exec) exec->ExecCommands();
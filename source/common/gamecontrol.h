@@ -69,6 +69,7 @@ struct UserConfig
 	bool nosound = false;
 	bool nomusic = false;
 	bool nologo = false;
+	bool dedicated = false;		// no video, sound or music, console commands from stdin
 	int setupstate = -1;
 
 	int netPort = 0;			// g_netPort = Batoi(argv[i + 1]);
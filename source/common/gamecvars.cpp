@@ -119,6 +119,7 @@ CVARD_NAMED(Bool, demorec_seeds, demorec_seeds_cvar, true, CVAR_ARCHIVE|CVAR_GLO
 CVARD_NAMED(Bool, demorec_diffs, demorec_diffs_cvar, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG, "enable/disable diff recording in demos")
 CVARD_NAMED(Bool, demorec_force, demorec_force_cvar, false, CVAR_ARCHIVE|CVAR_GLOBALCONFIG, "enable/disable forced demo recording")
 CVARD_NAMED(Int, demorec_difftics, demorec_difftics_cvar, 60, CVAR_ARCHIVE|CVAR_GLOBALCONFIG, "sets game tic interval after which a diff is recorded")
+CVARD_NAMED(Int, demorec_keyframetics, demorec_keyframetics_cvar, 900, CVAR_ARCHIVE|CVAR_GLOBALCONFIG, "sets game tic interval after which a seekable keyframe is recorded (0 disables)")
 CVARD(Bool, demoplay_diffs, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG, "enable/disable application of diffs in demo playback")
 CVARD(Bool, demoplay_showsync, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG, "enable/disable display of sync status")
 
@@ -445,6 +446,11 @@ bool G_AllowAutoload()
 	return true;
 }
 
+CVARD(Bool, con_cache, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG | CVAR_FRONTEND_DUKELIKE, "enable/disable caching of compiled CON scripts")
+CVARD(Bool, con_optimize, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG | CVAR_FRONTEND_DUKELIKE, "enable/disable fusing of common CON instruction sequences; applies when the CON scripts are compiled, so set it on the command line with +con_optimize")
+CVARD(Bool, map_cache, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG | CVAR_FRONTEND_BLOOD, "enable/disable caching of unpacked maps")
+CVARD(Bool, pvs_enable, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG, "enable/disable precomputed sector visibility for line of sight checks")
+
 CVAR(Bool, adult_lockout, false, CVAR_ARCHIVE)
 CUSTOM_CVAR(String, playername, "Player", CVAR_ARCHIVE | CVAR_USERINFO)
 {
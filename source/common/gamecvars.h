@@ -31,6 +31,7 @@ EXTERN_CVAR(Bool, demoplay_showsync)
 EXTERN_CVAR(Bool, demorec_diffs_cvar)
 EXTERN_CVAR(Bool, demorec_force_cvar)
 EXTERN_CVAR(Int, demorec_difftics_cvar)
+EXTERN_CVAR(Int, demorec_keyframetics_cvar)
 
 EXTERN_CVAR(Bool, snd_ambience)
 EXTERN_CVAR(Bool, snd_enabled)
@@ -98,6 +99,10 @@ EXTERN_CVAR(String, wchoice)
 
 EXTERN_CVAR(Bool, displaysetup)
 EXTERN_CVAR(Bool, noautoload)
+EXTERN_CVAR(Bool, con_cache)
+EXTERN_CVAR(Bool, con_optimize)
+EXTERN_CVAR(Bool, map_cache)
+EXTERN_CVAR(Bool, pvs_enable)
 
 EXTERN_CVAR(Bool, adult_lockout)
 EXTERN_CVAR(String, playername)
@@ -0,0 +1,500 @@
+/*
+** interpolate.cpp
+** Smooth movement of map geometry between game tics
+**
+**---------------------------------------------------------------------------
+** Copyright 2020 Raze developers and contributors
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "compat.h"
+#include "build.h"
+#include "pragmas.h"
+#include "tarray.h"
+#include "interpolate.h"
+
+enum
+{
+	Kind_Sector,
+	Kind_Wall,
+	Kind_Sprite,
+	Kind_Count
+};
+
+struct FInterpolationField
+{
+	uint8_t kind;
+	uint8_t size;		// in bytes
+	uint16_t offset;
+};
+
+static const FInterpolationField InterpFields[Interp_Count] =
+{
+	{ Kind_Sector, 4, offsetof(sectortype, floorz) },
+	{ Kind_Sector, 4, offsetof(sectortype, ceilingz) },
+	{ Kind_Sector, 2, offsetof(sectortype, floorheinum) },
+	{ Kind_Sector, 2, offsetof(sectortype, ceilingheinum) },
+	{ Kind_Sector, 1, offsetof(sectortype, floorxpanning) },
+	{ Kind_Sector, 1, offsetof(sectortype, floorypanning) },
+	{ Kind_Sector, 1, offsetof(sectortype, ceilingxpanning) },
+	{ Kind_Sector, 1, offsetof(sectortype, ceilingypanning) },
+
+	{ Kind_Wall, 4, offsetof(walltype, x) },
+	{ Kind_Wall, 4, offsetof(walltype, y) },
+	{ Kind_Wall, 1, offsetof(walltype, xpanning) },
+	{ Kind_Wall, 1, offsetof(walltype, ypanning) },
+
+	{ Kind_Sprite, 4, offsetof(spritetype, x) },
+	{ Kind_Sprite, 4, offsetof(spritetype, y) },
+	{ Kind_Sprite, 4, offsetof(spritetype, z) },
+	{ Kind_Sprite, 2, offsetof(spritetype, ang) },
+};
+
+static const size_t KindSize[Kind_Count] = { sizeof(sectortype), sizeof(walltype), sizeof(spritetype) };
+static const int KindLimit[Kind_Count] = { MAXSECTORS, MAXWALLS, MAXSPRITES };
+
+struct FInterpolation
+{
+	int index;
+	int type;
+	int old;	// value at the start of the current tic
+};
+
+static TArray<FInterpolation> Interpolations;
+static TMap<unsigned, unsigned> InterpolationSlots;	// index * Interp_Count + type -> position in Interpolations
+static int KindCount[Kind_Count];
+
+// The view being drawn
+static int ViewDepth;
+static int SuspendDepth;
+static int ViewSmoothRatio;
+static sectortype *GameSectors;
+static walltype *GameWalls;
+static TArray<sectortype> ViewSectors;
+static TArray<walltype> ViewWalls;
+static TArray<int> ViewValues;		// same order as Interpolations
+static TArray<int> ViewLive;		// the live values ViewValues were computed from
+static bool ViewSprites;
+static bool ViewCopiesSectors, ViewCopiesWalls;
+static bool ViewStale;				// interpolations were added or removed while the view was up
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static inline unsigned InterpolationKey(int index, int type)
+{
+	return unsigned(index) * Interp_Count + type;
+}
+
+// The game's own arrays, even while the engine looks at the view's copies.
+static inline sectortype *LiveSectors()
+{
+	return ViewDepth > 0 ? GameSectors : sector;
+}
+
+static inline walltype *LiveWalls()
+{
+	return ViewDepth > 0 ? GameWalls : wall;
+}
+
+static uint8_t *FieldAddress(const FInterpolation &interp, sectortype *sect, walltype *wal)
+{
+	auto &field = InterpFields[interp.type];
+	uint8_t *base;
+	switch (field.kind)
+	{
+	case Kind_Sector: base = (uint8_t *)&sect[interp.index]; break;
+	case Kind_Wall: base = (uint8_t *)&wal[interp.index]; break;
+	default: base = (uint8_t *)&sprite[interp.index]; break;
+	}
+	return base + field.offset;
+}
+
+static int GetField(const uint8_t *p, int size)
+{
+	switch (size)
+	{
+	case 4: return *(const int32_t *)p;
+	case 2: return *(const int16_t *)p;
+	default: return *p;
+	}
+}
+
+static void SetField(uint8_t *p, int size, int value)
+{
+	switch (size)
+	{
+	case 4: *(int32_t *)p = value; break;
+	case 2: *(int16_t *)p = (int16_t)value; break;
+	default: *p = (uint8_t)value; break;
+	}
+}
+
+static int LiveValue(const FInterpolation &interp)
+{
+	return GetField(FieldAddress(interp, LiveSectors(), LiveWalls()), InterpFields[interp.type].size);
+}
+
+static int InterpolatedValue(int old, int cur, int smoothratio)
+{
+	return old + mulscale16(cur - old, smoothratio);
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+bool StartInterpolation(int index, int type)
+{
+	if ((unsigned)type >= Interp_Count)
+		return false;
+	int const kind = InterpFields[type].kind;
+	if ((unsigned)index >= (unsigned)KindLimit[kind])
+		return false;
+
+	unsigned const key = InterpolationKey(index, type);
+	if (InterpolationSlots.CheckKey(key))
+		return true;
+
+	FInterpolation interp = { index, type, 0 };
+	interp.old = LiveValue(interp);
+	InterpolationSlots.Insert(key, Interpolations.Push(interp));
+	KindCount[kind]++;
+	if (ViewDepth > 0) ViewStale = true;
+	return true;
+}
+
+void StopInterpolation(int index, int type)
+{
+	if ((unsigned)type >= Interp_Count)
+		return;
+
+	unsigned const key = InterpolationKey(index, type);
+	auto slot = InterpolationSlots.CheckKey(key);
+	if (slot == nullptr)
+		return;
+
+	unsigned const pos = *slot;
+	InterpolationSlots.Remove(key);
+	KindCount[InterpFields[type].kind]--;
+
+	unsigned const last = Interpolations.Size() - 1;
+	if (pos != last)
+	{
+		Interpolations[pos] = Interpolations[last];
+		InterpolationSlots[InterpolationKey(Interpolations[pos].index, Interpolations[pos].type)] = pos;
+		if (last < ViewValues.Size())
+		{
+			ViewValues[pos] = ViewValues[last];
+			ViewLive[pos] = ViewLive[last];
+		}
+	}
+	Interpolations.Pop();
+	if (ViewDepth > 0) ViewStale = true;
+}
+
+//==========================================================================
+//
+// Works out which field of which sector, wall or sprite a pointer is for.
+//
+//==========================================================================
+
+static bool FindField(const void *field, int *index, int *type)
+{
+	uintptr_t const bases[Kind_Count] = { (uintptr_t)LiveSectors(), (uintptr_t)LiveWalls(), (uintptr_t)sprite };
+	uintptr_t const addr = (uintptr_t)field;
+
+	for (int kind = 0; kind < Kind_Count; kind++)
+	{
+		if (addr < bases[kind] || addr - bases[kind] >= KindSize[kind] * KindLimit[kind])
+			continue;
+
+		size_t const ofs = addr - bases[kind];
+		for (int t = 0; t < Interp_Count; t++)
+		{
+			if (InterpFields[t].kind == kind && InterpFields[t].offset == ofs % KindSize[kind])
+			{
+				*index = int(ofs / KindSize[kind]);
+				*type = t;
+				return true;
+			}
+		}
+		break;
+	}
+	return false;
+}
+
+bool StartInterpolation(const void *field)
+{
+	int index, type;
+	return FindField(field, &index, &type) && StartInterpolation(index, type);
+}
+
+void StopInterpolation(const void *field)
+{
+	int index, type;
+	if (FindField(field, &index, &type))
+		StopInterpolation(index, type);
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void UpdateInterpolations()
+{
+	for (auto &interp : Interpolations)
+		interp.old = LiveValue(interp);
+}
+
+void ClearInterpolations()
+{
+	Interpolations.Clear();
+	InterpolationSlots.Clear();
+	ViewValues.Clear();
+	ViewLive.Clear();
+	memset(KindCount, 0, sizeof(KindCount));
+}
+
+//==========================================================================
+//
+// Only what actually moves gets copied, so there is no cost at all as long
+// as nothing does.
+//
+//==========================================================================
+
+static void BuildView()
+{
+	sector = GameSectors;
+	wall = GameWalls;
+	ViewCopiesSectors = ViewCopiesWalls = false;
+	ViewStale = false;
+	if (ViewSprites)
+	{
+		memset(interpolatedsprite, 0, sizeof(interpolatedsprite));
+		ViewSprites = false;
+	}
+	if (Interpolations.Size() == 0)
+		return;
+
+	ViewValues.Resize(Interpolations.Size());
+	ViewLive.Resize(Interpolations.Size());
+	for (unsigned i = 0; i < Interpolations.Size(); i++)
+	{
+		auto &interp = Interpolations[i];
+		ViewLive[i] = LiveValue(interp);
+		ViewValues[i] = InterpolatedValue(interp.old, ViewLive[i], ViewSmoothRatio);
+	}
+
+	if (KindCount[Kind_Sector] > 0)
+	{
+		if (ViewSectors.Size() == 0) ViewSectors.Resize(MAXSECTORS + M32_FIXME_SECTORS);
+		memcpy(ViewSectors.Data(), GameSectors, sizeof(sectortype) * numsectors);
+		sector = ViewSectors.Data();
+		ViewCopiesSectors = true;
+	}
+	if (KindCount[Kind_Wall] > 0)
+	{
+		if (ViewWalls.Size() == 0) ViewWalls.Resize(MAXWALLS + M32_FIXME_WALLS);
+		memcpy(ViewWalls.Data(), GameWalls, sizeof(walltype) * numwalls);
+		wall = ViewWalls.Data();
+		ViewCopiesWalls = true;
+	}
+
+	for (unsigned i = 0; i < Interpolations.Size(); i++)
+	{
+		auto &interp = Interpolations[i];
+		auto &field = InterpFields[interp.type];
+		if (field.kind != Kind_Sprite)
+		{
+			SetField(FieldAddress(interp, sector, wall), field.size, ViewValues[i]);
+		}
+		else
+		{
+			bitmap_set(interpolatedsprite, interp.index);
+			ViewSprites = true;
+		}
+	}
+}
+
+void BeginInterpolatedView(int smoothratio)
+{
+	if (ViewDepth++ > 0)
+		return;
+
+	GameSectors = sector;
+	GameWalls = wall;
+	ViewSmoothRatio = smoothratio;
+	SuspendDepth = 0;
+	BuildView();
+}
+
+void EndInterpolatedView()
+{
+	if (ViewDepth == 0 || --ViewDepth > 0)
+		return;
+
+	sector = GameSectors;
+	wall = GameWalls;
+	if (ViewSprites)
+	{
+		memset(interpolatedsprite, 0, sizeof(interpolatedsprite));
+		ViewSprites = false;
+	}
+	ViewValues.Clear();
+	ViewLive.Clear();
+	SuspendDepth = 0;
+}
+
+//==========================================================================
+//
+// Script code run in the middle of drawing is game logic: whatever it
+// writes, including a complete map state restore, has to land in the
+// game's arrays. Events run many times per frame, so resuming does not
+// copy the map again. It only redoes the interpolated fields whose live
+// value changed; anything else the script changed in sectors and walls
+// shows up from the next frame on. Only adding or removing interpolations
+// while the view is up makes it rebuild the copies.
+//
+//==========================================================================
+
+static void RefreshView()
+{
+	if (ViewStale)
+	{
+		BuildView();
+		return;
+	}
+
+	if (ViewCopiesSectors) sector = ViewSectors.Data();
+	if (ViewCopiesWalls) wall = ViewWalls.Data();
+
+	for (unsigned i = 0; i < Interpolations.Size(); i++)
+	{
+		auto &interp = Interpolations[i];
+		int const live = LiveValue(interp);
+		if (live == ViewLive[i])
+			continue;
+
+		auto &field = InterpFields[interp.type];
+		ViewLive[i] = live;
+		ViewValues[i] = InterpolatedValue(interp.old, live, ViewSmoothRatio);
+		if (field.kind != Kind_Sprite)
+			SetField(FieldAddress(interp, sector, wall), field.size, ViewValues[i]);
+	}
+}
+
+void SuspendInterpolatedView()
+{
+	if (ViewDepth == 0 || SuspendDepth++ > 0)
+		return;
+
+	sector = GameSectors;
+	wall = GameWalls;
+}
+
+bool DrawingInterpolatedView()
+{
+	return ViewDepth > 0 && SuspendDepth == 0 && (sector != GameSectors || wall != GameWalls);
+}
+
+void ResumeInterpolatedView()
+{
+	if (ViewDepth == 0 || SuspendDepth == 0 || --SuspendDepth > 0)
+		return;
+
+	RefreshView();
+}
+
+//==========================================================================
+//
+// Called by the engine for the sprites marked in interpolatedsprite.
+//
+//==========================================================================
+
+void InterpolateTSprite(tspriteptr_t tspr, int spritenum)
+{
+	for (int type = Interp_Sprite_X; type <= Interp_Sprite_Ang; type++)
+	{
+		auto slot = InterpolationSlots.CheckKey(InterpolationKey(spritenum, type));
+		if (slot == nullptr || *slot >= ViewValues.Size())
+			continue;
+
+		int const value = ViewValues[*slot];
+		switch (type)
+		{
+		case Interp_Sprite_X: tspr->x = value; break;
+		case Interp_Sprite_Y: tspr->y = value; break;
+		case Interp_Sprite_Z: tspr->z = value; break;
+		default: tspr->ang = value; break;
+		}
+	}
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void WriteInterpolations(FileWriter *fw)
+{
+	uint32_t const count = Interpolations.Size();
+	fw->Write(&count, sizeof(count));
+	for (auto &interp : Interpolations)
+	{
+		int32_t const data[3] = { interp.index, interp.type, interp.old };
+		fw->Write(data, sizeof(data));
+	}
+}
+
+void ReadInterpolations(FileReader *fr)
+{
+	ClearInterpolations();
+
+	uint32_t count = 0;
+	fr->Read(&count, sizeof(count));
+	for (uint32_t i = 0; i < count; i++)
+	{
+		int32_t data[3];
+		if (fr->Read(data, sizeof(data)) != sizeof(data))
+			break;
+		if (StartInterpolation(data[0], data[1]))
+			Interpolations[InterpolationSlots[InterpolationKey(data[0], data[1])]].old = data[2];
+	}
+}
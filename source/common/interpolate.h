@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include "files.h"
+
+//==========================================================================
+//
+// Smooth movement of map geometry between game tics.
+//
+// The games register the fields that move and call UpdateInterpolations()
+// at the start of every tic. BeginInterpolatedView() builds copies of the
+// sectors and walls with the values in between the last two tics and points
+// the engine at them, so drawing neither sees nor changes the game's own
+// arrays. Sprites get their values when the engine makes tsprites out of
+// them. EndInterpolatedView() switches back; the calls may be nested.
+//
+// Game code that runs while a view is active, like script events, must be
+// wrapped in SuspendInterpolatedView() and ResumeInterpolatedView() so that
+// it works on the live map. Resuming only updates the interpolated fields
+// the code changed, so it is cheap enough to do around every event.
+//
+//==========================================================================
+
+enum EInterpolationType
+{
+	Interp_Sect_Floorz,
+	Interp_Sect_Ceilingz,
+	Interp_Sect_Floorheinum,
+	Interp_Sect_Ceilingheinum,
+	Interp_Sect_FloorPanX,
+	Interp_Sect_FloorPanY,
+	Interp_Sect_CeilingPanX,
+	Interp_Sect_CeilingPanY,
+
+	Interp_Wall_X,
+	Interp_Wall_Y,
+	Interp_Wall_PanX,
+	Interp_Wall_PanY,
+
+	Interp_Sprite_X,
+	Interp_Sprite_Y,
+	Interp_Sprite_Z,
+	Interp_Sprite_Ang,
+
+	Interp_Count
+};
+
+bool StartInterpolation(int index, int type);
+void StopInterpolation(int index, int type);
+
+// The same for a pointer to one of the fields above, which is what the games
+// keep around. Returns false for anything else.
+bool StartInterpolation(const void *field);
+void StopInterpolation(const void *field);
+
+void UpdateInterpolations();	// at the start of every game tic
+void ClearInterpolations();
+
+void BeginInterpolatedView(int smoothratio);
+void EndInterpolatedView();
+void SuspendInterpolatedView();
+void ResumeInterpolatedView();
+bool DrawingInterpolatedView();	// true while sector and wall point at the copies
+
+// For games that write their own savegames.
+void WriteInterpolations(FileWriter *fw);
+void ReadInterpolations(FileReader *fr);
@@ -53,6 +53,7 @@
 #include "printf.h"
 #include "timer.h"
 #include "backend/i_sound.h"
+#include "gamecontrol.h"
 #include <zmusic.h>
 
 
@@ -212,6 +213,14 @@ static void mus_sfclose(void* handle)
 void Mus_Init(void)
 {
 	I_InitSound();
+
+	// A dedicated server never plays music, so it doesn't need any soundfonts or MIDI devices.
+	if (userConfig.dedicated)
+	{
+		S_ParseSndInfo();
+		return;
+	}
+
     I_InitSoundFonts();
 	S_ParseSndInfo();
 
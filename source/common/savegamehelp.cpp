@@ -565,5 +565,6 @@ void LoadEngineState()
 	CheckMagic(fr);
 
 		fr.Close();
+		pvsUpdateGeometry();
 	}
 }
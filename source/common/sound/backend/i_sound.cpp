@@ -34,8 +34,10 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <mutex>
 
 #include "oalsound.h"
+#include "softsound.h"
 #include "printf.h"
 #include "i_module.h"
 #include "cmdlib.h"
@@ -51,6 +53,7 @@
 #include "z_music.h"
 #include "gamecvars.h"
 #include "gamecontrol.h"
+#include "timedemo.h"
 #include <zmusic.h>
 
 EXTERN_CVAR (Float, snd_sfxvolume)
@@ -255,8 +258,17 @@ void I_InitSound ()
 		return;
 	}
 
+	if (*TimeDemo_WavFile())
+	{
+		// the timedemo drives the mixer itself, whatever backend is set
+		GSnd = new SoftSoundRenderer(TimeDemo_WavFile());
+	}
+	else if (!stricmp(snd_backend, "software"))
+	{
+		GSnd = new SoftSoundRenderer;
+	}
 #ifndef NO_OPENAL
-	if (IsOpenALPresent())
+	else if (IsOpenALPresent())
 	{
 		GSnd = new OpenALSoundRenderer;
 	}
@@ -325,11 +337,82 @@ FString SoundStream::GetStats()
 
 //==========================================================================
 //
-// SoundRenderer :: LoadSoundVoc
+// GetEncodedLength
+//
+// ZMusic's decoders can neither report a sound's length nor seek, so the
+// formats that store the length in their headers get it read from there.
+// Returns false if the length can't be found out without decoding.
 //
 //==========================================================================
 
-SoundHandle SoundRenderer::LoadSoundVoc(uint8_t *sfxdata, int length)
+static uint32_t ReadLE32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+static bool GetEncodedLength(const uint8_t *data, int length, uint32_t &frames)
+{
+	if (length >= 12 && !memcmp(data, "RIFF", 4) && !memcmp(data + 8, "WAVE", 4))
+	{
+		unsigned blockalign = 0, format = 0;
+		uint32_t factframes = 0;
+		for (int pos = 12; pos + 8 <= length; )
+		{
+			const uint32_t size = ReadLE32(data + pos + 4);
+			if (!memcmp(data + pos, "fmt ", 4) && size >= 16 && pos + 8 + 16 <= length)
+			{
+				format = data[pos + 8] | (data[pos + 9] << 8);
+				blockalign = data[pos + 20] | (data[pos + 21] << 8);
+			}
+			else if (!memcmp(data + pos, "fact", 4) && size >= 4 && pos + 12 <= length)
+			{
+				factframes = ReadLE32(data + pos + 8);
+			}
+			else if (!memcmp(data + pos, "data", 4))
+			{
+				// Compressed wave formats need the fact chunk, which comes before the data.
+				if (format == 1 || format == 3 || format == 0xfffe) frames = blockalign ? std::min<uint32_t>(size, length - pos - 8) / blockalign : 0;
+				else frames = factframes;
+				return frames > 0;
+			}
+			pos += 8 + ((size + 1) & ~1u);
+		}
+		return false;
+	}
+	if (length >= 42 && !memcmp(data, "fLaC", 4) && (data[4] & 0x7f) == 0)
+	{
+		// STREAMINFO is always the first block. The sample count is 36 bits, 0 if unknown.
+		const uint8_t *info = data + 8;
+		if (info[13] & 0x0f)
+			return false;
+		frames = (uint32_t(info[14]) << 24) | (info[15] << 16) | (info[16] << 8) | info[17];
+		return frames > 0;
+	}
+	if (length >= 64 && !memcmp(data, "OggS", 4) && !memcmp(data + 28, "\x01vorbis", 7))
+	{
+		// For Vorbis, the granule position of the last page is the total number of frames.
+		for (int pos = length - 27; pos >= 0; pos--)
+		{
+			if (!memcmp(data + pos, "OggS", 4) && (data[pos + 5] & 4))
+			{
+				if (ReadLE32(data + pos + 10) != 0)
+					return false;
+				frames = ReadLE32(data + pos + 6);
+				return frames > 0;
+			}
+		}
+		return false;
+	}
+	return false;
+}
+
+//==========================================================================
+//
+// SoundRenderer :: DecodeSoundVoc
+//
+//==========================================================================
+
+bool SoundRenderer::DecodeSoundVoc(uint8_t *sfxdata, int length, DecodedSound &snd)
 {
 	uint8_t * data = NULL;
 	int len, frequency, channels, bits, loopstart, loopend;
@@ -437,7 +520,8 @@ SoundHandle SoundRenderer::LoadSoundVoc(uint8_t *sfxdata, int length)
 		// Second pass to write the data
 		if (okay)
 		{
-			data = new uint8_t[len];
+			snd.data.Resize(len);
+			data = snd.data.Data();
 			i = 26;
 			int j = 0;
 			while (i < length)
@@ -474,7 +558,168 @@ SoundHandle SoundRenderer::LoadSoundVoc(uint8_t *sfxdata, int length)
 		}
 
 	} while (false);
-	SoundHandle retval = LoadSoundRaw(data, len, frequency, channels, bits, loopstart, loopend);
-	if (data) delete[] data;
-	return retval;
+	if (data == NULL)
+		return false;
+
+	snd.frequency = frequency;
+	snd.channels = channels;
+	snd.bits = bits;
+	snd.loopstart = loopstart;
+	snd.loopend = loopend;
+	return true;
+}
+
+//==========================================================================
+//
+// SoundRenderer :: LoadSoundVoc
+//
+//==========================================================================
+
+SoundHandle SoundRenderer::LoadSoundVoc(uint8_t *sfxdata, int length)
+{
+	DecodedSound snd;
+	DecodeSoundVoc(sfxdata, length, snd);
+	return LoadSoundDecoded(snd);
+}
+
+//==========================================================================
+//
+// SoundRenderer :: OpenDecoder
+//
+// ZMusic sets up its mpg123 and libsndfile backends the first time they
+// are needed, without any locking, so decoders must not be created on two
+// threads at once. Reading from a decoder once it exists is safe, so only
+// the creation is serialized and the decoding itself still runs in parallel.
+//
+//==========================================================================
+
+SoundDecoder *SoundRenderer::OpenDecoder(const uint8_t *data, size_t size)
+{
+	static std::mutex DecoderLock;
+	std::lock_guard<std::mutex> lock(DecoderLock);
+	return CreateDecoder(data, size, true);
+}
+
+//==========================================================================
+//
+// SoundRenderer :: DecodeSound
+//
+// Decodes anything ZMusic can read to 8 or 16 bit PCM. Pass quiet when
+// calling this off the main thread.
+//
+// If the sound decodes to more than streamthreshold bytes, only its length
+// is determined and the encoded data gets copied to snd.encoded instead.
+// That only requires decoding if the length isn't in the file's header.
+//
+//==========================================================================
+
+bool SoundRenderer::DecodeSound(uint8_t *sfxdata, int length, DecodedSound &snd, bool quiet, int streamthreshold)
+{
+	ChannelConfig chans;
+	SampleType type;
+	int srate;
+	uint32_t loop_start = 0, loop_end = ~0u;
+	zmusic_bool startass = false, endass = false;
+
+	FindLoopTags(sfxdata, length, &loop_start, &startass, &loop_end, &endass);
+	auto decoder = OpenDecoder(sfxdata, length);
+	if (!decoder)
+		return false;
+
+	SoundDecoder_GetInfo(decoder, &srate, &chans, &type);
+	int channels = chans == ChannelConfig_Mono ? 1 : chans == ChannelConfig_Stereo ? 2 : 0;
+	int bits = type == SampleType_UInt8 ? 8 : type == SampleType_Int16 ? 16 : 0;
+
+	if (channels == 0 || bits == 0)
+	{
+		SoundDecoder_Close(decoder);
+		if (!quiet) Printf("Unsupported audio format: %s, %s\n", GetChannelConfigName(chans),
+			GetSampleTypeName(type));
+		return false;
+	}
+
+	const unsigned limit = streamthreshold > 0 ? unsigned(streamthreshold) : ~0u;
+	const unsigned framesize = channels * bits / 8;
+	uint32_t samples = 0;
+	const bool known = GetEncodedLength(sfxdata, length, samples);
+
+	if (known && limit != ~0u && uint64_t(samples) * framesize > limit)
+	{
+		// Too long to keep decoded, and there's no need to decode it to find out.
+		snd.encoded.Resize(length);
+		memcpy(snd.encoded.Data(), sfxdata, length);
+	}
+	else
+	{
+		unsigned total = 0;
+		unsigned got;
+
+		// Without a length from the header, start with the encoded size, which
+		// is about right for PCM wave files, and grow from there.
+		snd.data.Resize(std::min(known ? samples * framesize + 1 : std::max(unsigned(length), 32768u), limit));
+		for (;;)
+		{
+			if (total == snd.data.Size())
+			{
+				if (total >= limit)
+					break;
+				snd.data.Resize(std::min(total * 2, limit));
+			}
+			got = (unsigned)SoundDecoder_Read(decoder, (char*)&snd.data[total], snd.data.Size() - total);
+			if (got == 0)
+				break;
+			total += got;
+		}
+
+		if (total >= limit)
+		{
+			// Too long to keep decoded. This format doesn't say how long it is, so count.
+			uint8_t scratch[16384];
+			while ((got = (unsigned)SoundDecoder_Read(decoder, scratch, sizeof(scratch))) > 0)
+			{
+				total += got;
+			}
+			if (total > limit)
+			{
+				snd.data.Reset();
+				snd.encoded.Resize(length);
+				memcpy(snd.encoded.Data(), sfxdata, length);
+			}
+		}
+		if (snd.encoded.Size() == 0)
+		{
+			snd.data.Resize(total);
+		}
+		samples = total / framesize;
+	}
+	SoundDecoder_Close(decoder);
+
+	if (!startass) loop_start = Scale(loop_start, srate, 1000);
+	if (!endass && loop_end != ~0u) loop_end = Scale(loop_end, srate, 1000);
+	if (loop_start > samples) loop_start = 0;
+	if (loop_end > samples) loop_end = samples;
+
+	snd.frequency = srate;
+	snd.channels = channels;
+	snd.bits = bits;
+	snd.length = samples;
+	if ((loop_start > 0 || loop_end > 0) && loop_end > loop_start)
+	{
+		snd.loopstart = loop_start;
+		snd.loopend = loop_end;
+	}
+	return true;
+}
+
+//==========================================================================
+//
+// SoundRenderer :: LoadSoundDecoded
+//
+//==========================================================================
+
+SoundHandle SoundRenderer::LoadSoundDecoded(DecodedSound &snd)
+{
+	if (snd.encoded.Size() > 0)
+		return LoadSoundStreamed(snd);
+	return LoadSoundRaw(snd.data.Data(), snd.data.Size(), snd.frequency, snd.channels, snd.bits, snd.loopstart, snd.loopend);
 }
@@ -87,6 +87,24 @@ typedef bool (*SoundStreamCallback)(SoundStream *stream, void *buff, int len, vo
 struct SoundDecoder;
 class MIDIDevice;
 
+// PCM data as produced by the SoundRenderer::Decode* functions. Decoding does not
+// touch the renderer, so it may run on any thread. Only LoadSoundDecoded needs to
+// be called from the thread owning the renderer.
+struct DecodedSound
+{
+	TArray<uint8_t> data;
+	int frequency = 0;
+	int channels = 0;
+	int bits = 0;
+	int loopstart = -1;
+	int loopend = -1;
+
+	// Sounds that would decode to more than the renderer's stream threshold keep
+	// their encoded data here instead of 'data', to be decoded while playing.
+	TArray<uint8_t> encoded;
+	uint32_t length = 0;	// in frames
+};
+
 class SoundRenderer
 {
 public:
@@ -99,6 +117,14 @@ public:
 	virtual SoundHandle LoadSound(uint8_t *sfxdata, int length) = 0;
 	SoundHandle LoadSoundVoc(uint8_t *sfxdata, int length);
 	virtual SoundHandle LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend = -1) = 0;
+	SoundHandle LoadSoundDecoded(DecodedSound &snd);
+	virtual SoundHandle LoadSoundStreamed(DecodedSound &snd) { return { NULL }; }
+	// Decoded size in bytes above which sounds should be streamed, or 0 if the renderer can't do that.
+	virtual int GetStreamThreshold() { return 0; }
+	static bool DecodeSound(uint8_t *sfxdata, int length, DecodedSound &snd, bool quiet = false, int streamthreshold = 0);
+	static bool DecodeSoundVoc(uint8_t *sfxdata, int length, DecodedSound &snd);
+	// ZMusic's CreateDecoder for use off the main thread. See i_sound.cpp.
+	static SoundDecoder *OpenDecoder(const uint8_t *data, size_t size);
 	virtual void UnloadSound (SoundHandle sfx) = 0;	// unloads a sound from memory
 	virtual unsigned int GetMSLength(SoundHandle sfx) = 0;	// Gets the length of a sound at its default frequency
 	virtual unsigned int GetSampleLength(SoundHandle sfx) = 0;	// Gets the length of a sound at its default frequency
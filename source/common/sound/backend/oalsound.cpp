@@ -46,9 +46,6 @@
 #include <zmusic.h>
 #include "filereadermusicinterface.h"
 
-const char *GetSampleTypeName(SampleType type);
-const char *GetChannelConfigName(ChannelConfig chan);
-
 FModule OpenALModule{"OpenAL"};
 
 #include "oalload.h"
@@ -61,6 +58,7 @@ CVAR(Bool, snd_waterreverb, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 CVAR (String, snd_aldevice, "Default", CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 CVAR (Bool, snd_efx, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 CVAR (String, snd_alresampler, "Default", CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+CVAR (Int, snd_streamthreshold, 1024, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)	// in KB of decoded data, 0 to never stream sound effects
 
 #ifdef _WIN32
 #define OPENALLIB "openal32.dll"
@@ -477,6 +475,253 @@ public:
 };
 
 
+// A sound effect too long to be worth keeping around decoded. Only the encoded
+// data stays in memory, and every channel playing it decodes its own copy on
+// the stream thread.
+struct OpenALStreamedSound
+{
+	TArray<uint8_t> Encoded;
+	ALenum Format;
+	ALsizei SampleRate;
+	ALsizei FrameSize;
+	uint32_t Length;	// in frames
+	uint32_t LoopStart;
+	uint32_t LoopEnd;
+};
+
+class OpenALSfxStream
+{
+public:
+	static const int BufferCount = 4;
+
+	OpenALStreamedSound *Sound;
+	ALuint Source;
+	std::atomic<bool> Ended;	// set once everything has been played
+
+private:
+	ALuint Buffers[BufferCount];
+	ALsizei BufferFrames[BufferCount];
+	SoundDecoder *Decoder;
+	TArray<uint8_t> Data;
+	uint32_t DecodePos;	// frame the decoder is at
+	uint32_t PlayPos;	// frame the oldest queued buffer starts at
+	uint32_t SeekPos;	// frame still to be reached before the first buffers get queued
+	bool Seeking;
+	bool Looping;
+
+	uint32_t WrapPos(uint32_t pos) const
+	{
+		if(Looping && pos >= Sound->LoopEnd)
+			pos = Sound->LoopStart + (pos - Sound->LoopStart) % (Sound->LoopEnd - Sound->LoopStart);
+		return pos;
+	}
+
+	bool Rewind()
+	{
+		if(Decoder) SoundDecoder_Close(Decoder);
+		Decoder = SoundRenderer::OpenDecoder(Sound->Encoded.Data(), Sound->Encoded.Size());
+		DecodePos = 0;
+		return Decoder != nullptr;
+	}
+
+	// The decoders can't seek, so this decodes and drops everything up to the
+	// given frame. With a time limit it may stop early; returns true once
+	// the frame or the end of the sound has been reached.
+	bool SkipTo(uint32_t frame, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max())
+	{
+		while(DecodePos < frame)
+		{
+			size_t want = std::min<size_t>(Data.Size(), size_t(frame - DecodePos) * Sound->FrameSize);
+			size_t got = SoundDecoder_Read(Decoder, Data.Data(), want);
+			if(got == 0)
+				break;
+			DecodePos += uint32_t(got / Sound->FrameSize);
+			if(std::chrono::steady_clock::now() >= deadline)
+				return DecodePos >= frame;
+		}
+		return true;
+	}
+
+	bool Seek(uint32_t frame)
+	{
+		return Rewind() && SkipTo(frame);
+	}
+
+	bool Fill()
+	{
+		int queued = 0;
+		for(int i = 0;i < BufferCount;i++)
+		{
+			ALsizei bytes = Decode();
+			if(bytes == 0)
+				break;
+			alBufferData(Buffers[i], Sound->Format, Data.Data(), bytes, Sound->SampleRate);
+			alSourceQueueBuffers(Source, 1, &Buffers[i]);
+			BufferFrames[i] = bytes / Sound->FrameSize;
+			queued++;
+		}
+		return queued > 0 && getALError() == AL_NO_ERROR;
+	}
+
+	// Fills Data with the next chunk of the sound, going back to the loop start as needed.
+	ALsizei Decode()
+	{
+		size_t total = 0;
+		bool rewound = false;
+		while(total < Data.Size())
+		{
+			size_t want = Data.Size() - total;
+			if(Looping)
+				want = DecodePos < Sound->LoopEnd ? std::min<size_t>(want, size_t(Sound->LoopEnd - DecodePos) * Sound->FrameSize) : 0;
+
+			size_t got = want > 0 ? SoundDecoder_Read(Decoder, &Data[total], want) : 0;
+			if(got > 0)
+			{
+				total += got;
+				DecodePos += uint32_t(got / Sound->FrameSize);
+				rewound = false;
+				continue;
+			}
+			if(!Looping || rewound || !Seek(Sound->LoopStart))
+				break;
+			rewound = true;
+		}
+		return ALsizei(total - total % Sound->FrameSize);
+	}
+
+public:
+	OpenALSfxStream(OpenALStreamedSound *sound, ALuint source, bool looping)
+	  : Sound(sound), Source(source), Ended(false), Decoder(nullptr), DecodePos(0), PlayPos(0), SeekPos(0), Seeking(false), Looping(looping)
+	{
+		memset(Buffers, 0, sizeof(Buffers));
+		memset(BufferFrames, 0, sizeof(BufferFrames));
+		if(Looping && Sound->LoopEnd <= Sound->LoopStart)
+			Looping = false;
+	}
+
+	~OpenALSfxStream()
+	{
+		alSourceStop(Source);
+		alSourcei(Source, AL_BUFFER, 0);
+		if(Buffers[0])
+			alDeleteBuffers(BufferCount, Buffers);
+		getALError();
+		if(Decoder) SoundDecoder_Close(Decoder);
+	}
+
+	// Decodes the first buffers and queues them on the source, starting 'offset' frames in.
+	// Starting anywhere but the beginning is left to the stream thread, since it
+	// means decoding everything before the offset.
+	bool Start(uint32_t offset)
+	{
+		// 1/4 second per buffer, so a full queue lasts well past the stream thread's 100ms wakeups.
+		Data.Resize(((Sound->SampleRate + 3) / 4) * Sound->FrameSize);
+
+		offset = WrapPos(offset);
+		if(offset >= Sound->Length || !Rewind())
+			return false;
+
+		alGenBuffers(BufferCount, Buffers);
+		if(getALError() != AL_NO_ERROR)
+		{
+			memset(Buffers, 0, sizeof(Buffers));
+			return false;
+		}
+
+		if(offset > 0)
+		{
+			PlayPos = SeekPos = offset;
+			Seeking = true;
+			return true;
+		}
+		return Fill();
+	}
+
+	// Called on the stream thread with the stream lock held. Returns true if it
+	// has more work to do right away.
+	bool Process()
+	{
+		if(Ended.load())
+			return false;
+
+		if(Seeking)
+		{
+			// Skip ahead a little at a time so the stream lock doesn't stay held for long.
+			if(!SkipTo(SeekPos, std::chrono::steady_clock::now() + std::chrono::milliseconds(5)))
+				return true;
+			Seeking = false;
+			PlayPos = DecodePos;
+			if(!Fill())
+			{
+				Ended.store(true);
+				return false;
+			}
+			// The game has already told the source to play, which an empty source can't.
+			ALint state = AL_INITIAL;
+			alGetSourcei(Source, AL_SOURCE_STATE, &state);
+			if(state == AL_STOPPED)
+				alSourcePlay(Source);
+			if(getALError() != AL_NO_ERROR)
+				Ended.store(true);
+			return false;
+		}
+
+		ALint state = AL_INITIAL, processed = 0, queued = 0;
+		alGetSourcei(Source, AL_SOURCE_STATE, &state);
+		alGetSourcei(Source, AL_BUFFERS_PROCESSED, &processed);
+		if(getALError() != AL_NO_ERROR)
+		{
+			Ended.store(true);
+			return false;
+		}
+
+		while(processed-- > 0)
+		{
+			ALuint bufid;
+			alSourceUnqueueBuffers(Source, 1, &bufid);
+
+			int i = 0;
+			while(i < BufferCount-1 && Buffers[i] != bufid)
+				i++;
+			PlayPos = WrapPos(PlayPos + BufferFrames[i]);
+
+			ALsizei bytes = Decode();
+			if(bytes > 0)
+			{
+				alBufferData(bufid, Sound->Format, Data.Data(), bytes, Sound->SampleRate);
+				alSourceQueueBuffers(Source, 1, &bufid);
+				BufferFrames[i] = bytes / Sound->FrameSize;
+			}
+		}
+
+		// A stopped source has either underrun or played everything there is.
+		alGetSourcei(Source, AL_BUFFERS_QUEUED, &queued);
+		if(state == AL_STOPPED)
+		{
+			if(queued > 0)
+				alSourcePlay(Source);
+			else
+				Ended.store(true);
+		}
+		if(getALError() != AL_NO_ERROR)
+			Ended.store(true);
+		return false;
+	}
+
+	// Called with the stream lock held.
+	uint32_t GetPosition()
+	{
+		if(Seeking)
+			return SeekPos;
+		ALint offset = 0;
+		alGetSourcei(Source, AL_SAMPLE_OFFSET, &offset);
+		if(getALError() != AL_NO_ERROR)
+			offset = 0;
+		return WrapPos(PlayPos + offset);
+	}
+};
+
+
 #define AREA_SOUND_RADIUS  (32.f)
 
 #define PITCH_MULT (0.7937005f) /* Approx. 4 semitones lower; what Nash suggested */
@@ -838,6 +1083,12 @@ OpenALSoundRenderer::~OpenALSoundRenderer()
 
 	while(Streams.Size() > 0)
 		delete Streams[0];
+	for(auto stream : SfxStreams)
+		delete stream;
+	SfxStreams.Clear();
+	for(auto sound : StreamedSounds)
+		delete sound;
+	StreamedSounds.Clear();
 
 	alDeleteSources(Sources.Size(), &Sources[0]);
 	Sources.Clear();
@@ -875,21 +1126,31 @@ void OpenALSoundRenderer::BackgroundProc()
 	std::unique_lock<std::mutex> lock(StreamLock);
 	while(!QuitThread.load())
 	{
-		if(Streams.Size() == 0)
+		if(Streams.Size() == 0 && SfxStreams.Size() == 0)
 		{
 			// If there's nothing to play, wait indefinitely.
 			StreamWake.wait(lock);
 		}
 		else
 		{
-			// Else, process all active streams and sleep for 100ms
+			// Else, process all active streams and sleep for 100ms, or only
+			// briefly if a sound effect is still skipping to where it starts.
+			bool busy = false;
 			for(size_t i = 0;i < Streams.Size();i++)
 				Streams[i]->Process();
-			StreamWake.wait_for(lock, std::chrono::milliseconds(100));
+			for(size_t i = 0;i < SfxStreams.Size();i++)
+				busy |= SfxStreams[i]->Process();
+			StreamWake.wait_for(lock, std::chrono::milliseconds(busy ? 1 : 100));
 		}
 	}
 }
 
+void OpenALSoundRenderer::StartStreamThread()
+{
+	if(StreamThread.get_id() == std::thread::id())
+		StreamThread = std::thread(std::mem_fn(&OpenALSoundRenderer::BackgroundProc), this);
+}
+
 void OpenALSoundRenderer::AddStream(OpenALSoundStream *stream)
 {
 	std::unique_lock<std::mutex> lock(StreamLock);
@@ -941,6 +1202,8 @@ void OpenALSoundRenderer::SetMusicVolume(float volume)
 
 unsigned int OpenALSoundRenderer::GetMSLength(SoundHandle sfx)
 {
+	if(OpenALStreamedSound *sound = FindStreamedSound(sfx))
+		return (unsigned int)(sound->Length * 1000. / sound->SampleRate);
 	if(sfx.data)
 	{
 		ALuint buffer = GET_PTRID(sfx.data);
@@ -960,6 +1223,8 @@ unsigned int OpenALSoundRenderer::GetMSLength(SoundHandle sfx)
 
 unsigned int OpenALSoundRenderer::GetSampleLength(SoundHandle sfx)
 {
+	if(OpenALStreamedSound *sound = FindStreamedSound(sfx))
+		return sound->Length;
 	if(sfx.data)
 	{
 		ALuint buffer = GET_PTRID(sfx.data);
@@ -1051,82 +1316,114 @@ SoundHandle OpenALSoundRenderer::LoadSoundRaw(uint8_t *sfxdata, int length, int
 }
 
 SoundHandle OpenALSoundRenderer::LoadSound(uint8_t *sfxdata, int length)
+{
+	DecodedSound snd;
+	if (!DecodeSound(sfxdata, length, snd, false, GetStreamThreshold()))
+		return { NULL };
+	return LoadSoundDecoded(snd);
+}
+
+int OpenALSoundRenderer::GetStreamThreshold()
+{
+	return snd_streamthreshold > 0 ? snd_streamthreshold * 1024 : 0;
+}
+
+SoundHandle OpenALSoundRenderer::LoadSoundStreamed(DecodedSound &snd)
 {
 	SoundHandle retval = { NULL };
-	ALenum format = AL_NONE;
-	ChannelConfig chans;
-	SampleType type;
-	int srate;
-	uint32_t loop_start = 0, loop_end = ~0u;
-	zmusic_bool startass = false, endass = false;
-
-	FindLoopTags(sfxdata, length, &loop_start, &startass, &loop_end, &endass);
-	auto decoder = CreateDecoder(sfxdata, length, true);
-	if (!decoder)
-		return retval;
 
-	SoundDecoder_GetInfo(decoder, &srate, &chans, &type);
-	int samplesize = 1;
-	if (chans == ChannelConfig_Mono)
+	ALenum format = AL_NONE;
+	if(snd.bits == 16)
 	{
-		if (type == SampleType_UInt8) format = AL_FORMAT_MONO8, samplesize = 1;
-		if (type == SampleType_Int16) format = AL_FORMAT_MONO16, samplesize = 2;
+		if(snd.channels == 1) format = AL_FORMAT_MONO16;
+		if(snd.channels == 2) format = AL_FORMAT_STEREO16;
 	}
-	else if (chans == ChannelConfig_Stereo)
+	else if(snd.bits == 8)
 	{
-		if (type == SampleType_UInt8) format = AL_FORMAT_STEREO8, samplesize = 2;
-		if (type == SampleType_Int16) format = AL_FORMAT_STEREO16, samplesize = 4;
+		if(snd.channels == 1) format = AL_FORMAT_MONO8;
+		if(snd.channels == 2) format = AL_FORMAT_STEREO8;
 	}
 
-	if (format == AL_NONE)
+	if(format == AL_NONE || snd.frequency <= 0 || snd.length == 0)
 	{
-		SoundDecoder_Close(decoder);
-		Printf("Unsupported audio format: %s, %s\n", GetChannelConfigName(chans),
-			GetSampleTypeName(type));
+		Printf("Unhandled format: %d bit, %d channel, %d hz\n", snd.bits, snd.channels, snd.frequency);
 		return retval;
 	}
 
-	std::vector<uint8_t> data;
-	unsigned total = 0;
-	unsigned got;
+	OpenALStreamedSound *sound = new OpenALStreamedSound;
+	sound->Encoded = std::move(snd.encoded);
+	sound->Format = format;
+	sound->SampleRate = snd.frequency;
+	sound->FrameSize = snd.channels * snd.bits / 8;
+	sound->Length = snd.length;
+	sound->LoopStart = snd.loopstart > 0 ? snd.loopstart : 0;
+	sound->LoopEnd = (snd.loopend > 0 && uint32_t(snd.loopend) <= snd.length) ? snd.loopend : snd.length;
+	StreamedSounds.Push(sound);
+
+	retval.data = sound;
+	return retval;
+}
+
+OpenALStreamedSound *OpenALSoundRenderer::FindStreamedSound(SoundHandle sfx)
+{
+	if(!sfx.data)
+		return NULL;
+	unsigned int i = StreamedSounds.Find((OpenALStreamedSound*)sfx.data);
+	return i < StreamedSounds.Size() ? StreamedSounds[i] : NULL;
+}
 
-	data.resize(total + 32768);
-	while ((got = (unsigned)SoundDecoder_Read(decoder, (char*)&data[total], data.size() - total)) > 0)
+OpenALSfxStream *OpenALSoundRenderer::FindSfxStream(ALuint source)
+{
+	for(auto stream : SfxStreams)
 	{
-		total += got;
-		data.resize(total * 2);
+		if(stream->Source == source)
+			return stream;
 	}
-	data.resize(total);
-	SoundDecoder_Close(decoder);
+	return NULL;
+}
 
-	ALenum err;
-	ALuint buffer = 0;
-	alGenBuffers(1, &buffer);
-	alBufferData(buffer, format, &data[0], (ALsizei)data.size(), srate);
-	if((err=getALError()) != AL_NO_ERROR)
+bool OpenALSoundRenderer::StartSfxStream(OpenALStreamedSound *sound, ALuint source, int chanflags, FISoundChannel *reuse_chan)
+{
+	// Restarted channels continue where they left off, like buffered ones do through AL_SEC_OFFSET.
+	uint32_t offset = 0;
+	if(reuse_chan && reuse_chan->StartTime != 0)
 	{
-		Printf("Failed to buffer data: %s\n", alGetString(err));
-		alDeleteBuffers(1, &buffer);
-		getALError();
-		return retval;
+		if((chanflags&SNDF_ABSTIME))
+			offset = uint32_t(reuse_chan->StartTime);
+		else
+		{
+			float secs = std::chrono::duration_cast<std::chrono::duration<float>>(
+				std::chrono::steady_clock::now().time_since_epoch() -
+				std::chrono::steady_clock::time_point::duration(reuse_chan->StartTime)
+			).count();
+			if(secs > 0.f) offset = uint32_t(secs * sound->SampleRate);
+		}
 	}
 
-	if (!startass) loop_start = Scale(loop_start, srate, 1000);
-	if (!endass && loop_end != ~0u) loop_end = Scale(loop_end, srate, 1000);
-	const uint32_t samples = (uint32_t)data.size() / samplesize;
-	if (loop_start > samples) loop_start = 0;
-	if (loop_end > samples) loop_end = samples;
-
-	if ((loop_start > 0 || loop_end > 0) && loop_end > loop_start && AL.SOFT_loop_points)
+	OpenALSfxStream *stream = new OpenALSfxStream(sound, source, !!(chanflags&SNDF_LOOP));
+	if(!stream->Start(offset))
 	{
-		ALint loops[2] = { static_cast<ALint>(loop_start), static_cast<ALint>(loop_end) };
-		DPrintf(DMSG_NOTIFY, "Setting loop points %d -> %d\n", loops[0], loops[1]);
-		alBufferiv(buffer, AL_LOOP_POINTS_SOFT, loops);
-		// no console messages here, please!
+		delete stream;
+		return false;
 	}
 
-	retval.data = MAKE_PTRID(buffer);
-	return retval;
+	StartStreamThread();
+	std::unique_lock<std::mutex> lock(StreamLock);
+	SfxStreams.Push(stream);
+	lock.unlock();
+	StreamWake.notify_all();
+	return true;
+}
+
+void OpenALSoundRenderer::StopSfxStream(ALuint source)
+{
+	std::unique_lock<std::mutex> lock(StreamLock);
+	OpenALSfxStream *stream = FindSfxStream(source);
+	if(stream)
+	{
+		SfxStreams.Delete(SfxStreams.Find(stream));
+		delete stream;
+	}
 }
 
 void OpenALSoundRenderer::UnloadSound(SoundHandle sfx)
@@ -1134,6 +1431,25 @@ void OpenALSoundRenderer::UnloadSound(SoundHandle sfx)
 	if(!sfx.data)
 		return;
 
+	if(OpenALStreamedSound *sound = FindStreamedSound(sfx))
+	{
+		FSoundChan *schan = soundEngine->GetChannels();
+		while(schan)
+		{
+			FSoundChan *next = schan->NextChan;
+			if(schan->SysChannel)
+			{
+				OpenALSfxStream *stream = FindSfxStream(GET_PTRID(schan->SysChannel));
+				if(stream && stream->Sound == sound)
+					StopChannel(schan);
+			}
+			schan = next;
+		}
+		StreamedSounds.Delete(StreamedSounds.Find(sound));
+		delete sound;
+		return;
+	}
+
 	ALuint buffer = GET_PTRID(sfx.data);
 	FSoundChan *schan = soundEngine->GetChannels();
 	while(schan)
@@ -1160,8 +1476,7 @@ void OpenALSoundRenderer::UnloadSound(SoundHandle sfx)
 
 SoundStream *OpenALSoundRenderer::CreateStream(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata)
 {
-	if(StreamThread.get_id() == std::thread::id())
-		StreamThread = std::thread(std::mem_fn(&OpenALSoundRenderer::BackgroundProc), this);
+	StartStreamThread();
 	OpenALSoundStream *stream = new OpenALSoundStream(this);
 	if (!stream->Init(callback, buffbytes, flags, samplerate, userdata))
 	{
@@ -1182,14 +1497,16 @@ FISoundChannel *OpenALSoundRenderer::StartSound(SoundHandle sfx, float vol, int
 			return NULL;
 	}
 
-	ALuint buffer = GET_PTRID(sfx.data);
+	OpenALStreamedSound *streamed = FindStreamedSound(sfx);
+	ALuint buffer = streamed ? 0 : GET_PTRID(sfx.data);
 	ALuint source = FreeSfx.Last();
 	alSource3f(source, AL_POSITION, 0.f, 0.f, 0.f);
 	alSource3f(source, AL_VELOCITY, 0.f, 0.f, 0.f);
 	alSource3f(source, AL_DIRECTION, 0.f, 0.f, 0.f);
 	alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
 
-	alSourcei(source, AL_LOOPING, (chanflags&SNDF_LOOP) ? AL_TRUE : AL_FALSE);
+	// Streamed sounds loop by decoding the loop again.
+	alSourcei(source, AL_LOOPING, ((chanflags&SNDF_LOOP) && !streamed) ? AL_TRUE : AL_FALSE);
 
 	alSourcef(source, AL_REFERENCE_DISTANCE, 1.f);
 	alSourcef(source, AL_MAX_DISTANCE, 1000.f);
@@ -1221,7 +1538,7 @@ FISoundChannel *OpenALSoundRenderer::StartSound(SoundHandle sfx, float vol, int
 	else
 		alSourcef(source, AL_PITCH, PITCH(pitch));
 
-	if(!reuse_chan || reuse_chan->StartTime == 0)
+	if(streamed || !reuse_chan || reuse_chan->StartTime == 0)
 		alSourcef(source, AL_SEC_OFFSET, 0.f);
 	else
 	{
@@ -1239,11 +1556,19 @@ FISoundChannel *OpenALSoundRenderer::StartSound(SoundHandle sfx, float vol, int
 	if(getALError() != AL_NO_ERROR)
 		return NULL;
 
-	alSourcei(source, AL_BUFFER, buffer);
+	if(streamed)
+	{
+		if(!StartSfxStream(streamed, source, chanflags, reuse_chan))
+			return NULL;
+	}
+	else
+		alSourcei(source, AL_BUFFER, buffer);
 	if((chanflags&SNDF_NOPAUSE) || !SFXPaused)
 		alSourcePlay(source);
 	if(getALError() != AL_NO_ERROR)
 	{
+		if(streamed)
+			StopSfxStream(source);
 		alSourcei(source, AL_BUFFER, 0);
 		getALError();
 		return NULL;
@@ -1289,7 +1614,8 @@ FISoundChannel *OpenALSoundRenderer::StartSound3D(SoundHandle sfx, SoundListener
 	}
 
 	bool manualRolloff = true;
-	ALuint buffer = GET_PTRID(sfx.data);
+	OpenALStreamedSound *streamed = FindStreamedSound(sfx);
+	ALuint buffer = streamed ? 0 : GET_PTRID(sfx.data);
 	ALuint source = FreeSfx.Last();
 	if(rolloff->RolloffType == ROLLOFF_Log)
 	{
@@ -1388,7 +1714,8 @@ FISoundChannel *OpenALSoundRenderer::StartSound3D(SoundHandle sfx, SoundListener
 	alSource3f(source, AL_DIRECTION, 0.f, 0.f, 0.f);
 	alSourcef(source, AL_DOPPLER_FACTOR, 0.f);
 
-	alSourcei(source, AL_LOOPING, (chanflags&SNDF_LOOP) ? AL_TRUE : AL_FALSE);
+	// Streamed sounds loop by decoding the loop again.
+	alSourcei(source, AL_LOOPING, ((chanflags&SNDF_LOOP) && !streamed) ? AL_TRUE : AL_FALSE);
 
 	alSourcef(source, AL_MAX_GAIN, SfxVolume);
 	alSourcef(source, AL_GAIN, SfxVolume*vol);
@@ -1414,7 +1741,7 @@ FISoundChannel *OpenALSoundRenderer::StartSound3D(SoundHandle sfx, SoundListener
 	else
 		alSourcef(source, AL_PITCH, PITCH(pitch));
 
-	if(!reuse_chan || reuse_chan->StartTime == 0)
+	if(streamed || !reuse_chan || reuse_chan->StartTime == 0)
 		alSourcef(source, AL_SEC_OFFSET, 0.f);
 	else
 	{
@@ -1432,11 +1759,19 @@ FISoundChannel *OpenALSoundRenderer::StartSound3D(SoundHandle sfx, SoundListener
 	if(getALError() != AL_NO_ERROR)
 		return NULL;
 
-	alSourcei(source, AL_BUFFER, buffer);
+	if(streamed)
+	{
+		if(!StartSfxStream(streamed, source, chanflags, reuse_chan))
+			return NULL;
+	}
+	else
+		alSourcei(source, AL_BUFFER, buffer);
 	if((chanflags&SNDF_NOPAUSE) || !SFXPaused)
 		alSourcePlay(source);
 	if(getALError() != AL_NO_ERROR)
 	{
+		if(streamed)
+			StopSfxStream(source);
 		alSourcei(source, AL_BUFFER, 0);
 		getALError();
 		return NULL;
@@ -1494,6 +1829,7 @@ void OpenALSoundRenderer::StopChannel(FISoundChannel *chan)
 	// Release first, so it can be properly marked as evicted if it's being killed
 	soundEngine->ChannelEnded(chan);
 
+	StopSfxStream(source);
 	alSourceRewind(source);
 	alSourcei(source, AL_BUFFER, 0);
 	getALError();
@@ -1515,8 +1851,14 @@ unsigned int OpenALSoundRenderer::GetPosition(FISoundChannel *chan)
 	if(chan == NULL || chan->SysChannel == NULL)
 		return 0;
 
+	ALuint source = GET_PTRID(chan->SysChannel);
+	std::unique_lock<std::mutex> lock(StreamLock);
+	if(OpenALSfxStream *stream = FindSfxStream(source))
+		return stream->GetPosition();
+	lock.unlock();
+
 	ALint pos;
-	alGetSourcei(GET_PTRID(chan->SysChannel), AL_SAMPLE_OFFSET, &pos);
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &pos);
 	if(getALError() == AL_NO_ERROR)
 		return pos;
 	return 0;
@@ -1917,6 +2259,11 @@ void OpenALSoundRenderer::PurgeStoppedSources()
 		alGetSourcei(src, AL_SOURCE_STATE, &state);
 		if(state == AL_INITIAL || state == AL_PLAYING || state == AL_PAUSED)
 			continue;
+		// Streamed sounds also stop when they run out of data in time. The
+		// stream thread restarts them then, so only release them once it's done.
+		OpenALSfxStream *stream = FindSfxStream(src);
+		if(stream && !stream->Ended.load())
+			continue;
 
 		FSoundChan *schan = soundEngine->GetChannels();
 		while(schan)
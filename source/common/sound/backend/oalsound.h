@@ -116,6 +116,8 @@ AL_API const ALchar* AL_APIENTRY alGetStringiSOFT(ALenum pname, ALsizei index);
 
 
 class OpenALSoundStream;
+class OpenALSfxStream;
+struct OpenALStreamedSound;
 
 class OpenALSoundRenderer : public SoundRenderer
 {
@@ -127,6 +129,8 @@ public:
 	virtual void SetMusicVolume(float volume);
 	virtual SoundHandle LoadSound(uint8_t *sfxdata, int length);
 	virtual SoundHandle LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend = -1);
+	virtual SoundHandle LoadSoundStreamed(DecodedSound &snd);
+	virtual int GetStreamThreshold();
 	virtual void UnloadSound(SoundHandle sfx);
 	virtual unsigned int GetMSLength(SoundHandle sfx);
 	virtual unsigned int GetSampleLength(SoundHandle sfx);
@@ -240,9 +244,15 @@ private:
     void (ALC_APIENTRY*alcDeviceResumeSOFT)(ALCdevice *device);
 
     void BackgroundProc();
+    void StartStreamThread();
     void AddStream(OpenALSoundStream *stream);
     void RemoveStream(OpenALSoundStream *stream);
 
+	OpenALStreamedSound *FindStreamedSound(SoundHandle sfx);
+	OpenALSfxStream *FindSfxStream(ALuint source);
+	bool StartSfxStream(OpenALStreamedSound *sound, ALuint source, int chanflags, FISoundChannel *reuse_chan);
+	void StopSfxStream(ALuint source);
+
 	void LoadReverb(const ReverbContainer *env);
 	void PurgeStoppedSources();
 	static FSoundChan *FindLowestChannel();
@@ -279,6 +289,9 @@ private:
     TArray<OpenALSoundStream*> Streams;
     friend class OpenALSoundStream;
 
+	TArray<OpenALStreamedSound*> StreamedSounds;
+	TArray<OpenALSfxStream*> SfxStreams;	// channels playing streamed sounds, guarded by StreamLock
+
 	ALCdevice *InitDevice();
 };
 
@@ -0,0 +1,1237 @@
+/*
+** softsound.cpp
+** System interface for sound; mixes everything in software
+**
+**---------------------------------------------------------------------------
+** Copyright 2020 Raze developers and contributors
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** This backend does not need an audio device. It renders either into a WAV
+** file or into nothing at all, which makes it possible to measure and
+** regression test the cost of mixing on headless machines.
+**
+*/
+
+#include <chrono>
+#include <math.h>
+
+#include "templates.h"
+#include "softsound.h"
+#include "c_dispatch.h"
+#include "c_cvars.h"
+#include "files.h"
+#include "m_swap.h"
+#include "printf.h"
+#include "v_text.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SOFTSOUND_SSE
+#endif
+
+CVAR(String, snd_softoutput, "", CVAR_GLOBALCONFIG)	// WAV file to render to, or nothing for the null sink
+
+EXTERN_CVAR(Int, snd_channels)
+EXTERN_CVAR(Int, snd_samplerate)
+EXTERN_CVAR(Bool, snd_pitched)
+EXTERN_CVAR(Bool, snd_waterreverb)
+
+extern ReverbContainer *ForcedEnvironment;
+
+#define MAKE_VOICEID(x)  ((void*)(uintptr_t)((x) + 1))
+#define GET_VOICEID(x)  (int((uintptr_t)(x)) - 1)
+
+#define AREA_SOUND_RADIUS  (32.f)
+
+#define PITCH_MULT (0.7937005f) /* Approx. 4 semitones lower; what Nash suggested */
+
+#define PITCH(pitch) (snd_pitched ? (pitch)/128.f : 1.f)
+
+static inline float mB2Gain(float mB) { return powf(10.f, mB / 2000.f); }
+
+//==========================================================================
+//
+// Mixing kernels
+//
+// Everything that runs once per voice and sample goes through these, so
+// they are the only part that gets hand vectorized.
+//
+//==========================================================================
+
+static void MixMono(float *out, const float *in, int frames, float gl, float gr)
+{
+	int i = 0;
+#ifdef SOFTSOUND_SSE
+	const __m128 gain = _mm_setr_ps(gl, gr, gl, gr);
+	for (; i + 4 <= frames; i += 4)
+	{
+		__m128 s = _mm_loadu_ps(in + i);
+		__m128 lo = _mm_unpacklo_ps(s, s);
+		__m128 hi = _mm_unpackhi_ps(s, s);
+		_mm_storeu_ps(out + i * 2, _mm_add_ps(_mm_loadu_ps(out + i * 2), _mm_mul_ps(lo, gain)));
+		_mm_storeu_ps(out + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(out + i * 2 + 4), _mm_mul_ps(hi, gain)));
+	}
+#endif
+	for (; i < frames; i++)
+	{
+		out[i * 2] += in[i] * gl;
+		out[i * 2 + 1] += in[i] * gr;
+	}
+}
+
+static void MixStereo(float *out, const float *in, int frames, float gl, float gr)
+{
+	int i = 0;
+#ifdef SOFTSOUND_SSE
+	const __m128 gain = _mm_setr_ps(gl, gr, gl, gr);
+	for (; i + 2 <= frames; i += 2)
+	{
+		_mm_storeu_ps(out + i * 2, _mm_add_ps(_mm_loadu_ps(out + i * 2), _mm_mul_ps(_mm_loadu_ps(in + i * 2), gain)));
+	}
+#endif
+	for (; i < frames; i++)
+	{
+		out[i * 2] += in[i * 2] * gl;
+		out[i * 2 + 1] += in[i * 2 + 1] * gr;
+	}
+}
+
+static void MixSend(float *send, const float *in, int frames, int channels, float gain)
+{
+	int i = 0;
+	if (channels == 1)
+	{
+#ifdef SOFTSOUND_SSE
+		const __m128 g = _mm_set1_ps(gain);
+		for (; i + 4 <= frames; i += 4)
+		{
+			_mm_storeu_ps(send + i, _mm_add_ps(_mm_loadu_ps(send + i), _mm_mul_ps(_mm_loadu_ps(in + i), g)));
+		}
+#endif
+		for (; i < frames; i++)
+			send[i] += in[i] * gain;
+	}
+	else
+	{
+		gain *= 0.5f;
+		for (; i < frames; i++)
+			send[i] += (in[i * 2] + in[i * 2 + 1]) * gain;
+	}
+}
+
+static void ConvertOutput(int16_t *out, const float *in, int samples, float gain)
+{
+	int i = 0;
+#ifdef SOFTSOUND_SSE
+	const __m128 g = _mm_set1_ps(gain * 32767.f);
+	const __m128 lo = _mm_set1_ps(-32768.f);
+	const __m128 hi = _mm_set1_ps(32767.f);
+	for (; i + 4 <= samples; i += 4)
+	{
+		__m128 s = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), g), lo), hi);
+		// truncate like the plain loop below, so that the output doesn't depend on the build
+		out[i] = (int16_t)_mm_cvttss_si32(s);
+		out[i + 1] = (int16_t)_mm_cvttss_si32(_mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)));
+		out[i + 2] = (int16_t)_mm_cvttss_si32(_mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 2, 2, 2)));
+		out[i + 3] = (int16_t)_mm_cvttss_si32(_mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 3, 3)));
+	}
+#endif
+	for (; i < samples; i++)
+	{
+		out[i] = (int16_t)clamp(in[i] * gain * 32767.f, -32768.f, 32767.f);
+	}
+}
+
+//==========================================================================
+//
+// SoftSoundStream
+//
+// Streams are pulled by the mixer thread, with the renderer's MixLock held.
+//
+//==========================================================================
+
+class SoftSoundStream : public SoundStream
+{
+	SoftSoundRenderer *Renderer;
+
+	SoundStreamCallback Callback;
+	void *UserData;
+
+	TArray<uint8_t> Data;
+	TArray<float> Buffer;	// converted, interleaved stereo frames not mixed yet
+
+	int SampleRate;
+	int Flags;
+	int FrameSize;
+	uint64_t Pos;
+	uint64_t Step;
+
+	std::atomic<bool> Playing;
+	bool Paused;
+	float Volume;
+
+	bool Fill(unsigned frames)
+	{
+		const int chans = (Flags & Mono) ? 1 : 2;
+		while (Buffer.Size() < frames * 2)
+		{
+			if (!Callback(this, Data.Data(), Data.Size(), UserData))
+				return false;
+
+			const unsigned count = Data.Size() / FrameSize * chans;
+			const unsigned base = Buffer.Reserve(count * 2 / chans);
+			float *dst = &Buffer[base];
+			for (unsigned i = 0; i < count; i++)
+			{
+				float s;
+				if (Flags & Bits8) s = (Data[i] - 128) / 128.f;
+				else if (Flags & Float) s = ((float*)Data.Data())[i];
+				else if (Flags & Bits32) s = ((int32_t*)Data.Data())[i] / 2147483648.f;
+				else s = ((int16_t*)Data.Data())[i] / 32768.f;
+
+				if (chans == 1) dst[i * 2] = dst[i * 2 + 1] = s;
+				else dst[i] = s;
+			}
+		}
+		return true;
+	}
+
+public:
+	SoftSoundStream(SoftSoundRenderer *renderer)
+		: Renderer(renderer), Callback(nullptr), UserData(nullptr), SampleRate(0), Flags(0), FrameSize(0),
+		Pos(0), Step(0), Playing(false), Paused(false), Volume(1.f)
+	{
+	}
+
+	virtual ~SoftSoundStream()
+	{
+		Stop();
+	}
+
+	bool Init(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata)
+	{
+		Callback = callback;
+		UserData = userdata;
+		SampleRate = samplerate;
+		Flags = flags;
+
+		FrameSize = (flags & Bits8) ? 1 : (flags & (Bits32 | Float)) ? 4 : 2;
+		if (!(flags & Mono)) FrameSize *= 2;
+
+		buffbytes += FrameSize - 1;
+		buffbytes -= buffbytes % FrameSize;
+		Data.Resize(buffbytes);
+
+		Step = (uint64_t(SampleRate) << 32) / Renderer->OutputRate;
+		return SampleRate > 0 && buffbytes > 0;
+	}
+
+	virtual bool Play(bool loop, float vol)
+	{
+		std::lock_guard<std::mutex> lock(Renderer->MixLock);
+		Volume = vol;
+		Paused = false;
+		Pos = 0;
+		Buffer.Clear();
+		if (Renderer->Streams.Find(this) == Renderer->Streams.Size())
+			Renderer->Streams.Push(this);
+		Playing = true;
+		return true;
+	}
+
+	virtual void Stop()
+	{
+		std::lock_guard<std::mutex> lock(Renderer->MixLock);
+		unsigned index = Renderer->Streams.Find(this);
+		if (index < Renderer->Streams.Size())
+			Renderer->Streams.Delete(index);
+		Playing = false;
+	}
+
+	virtual void SetVolume(float vol)
+	{
+		Volume = vol;
+	}
+
+	virtual bool SetPaused(bool paused)
+	{
+		Paused = paused;
+		return true;
+	}
+
+	virtual bool IsEnded()
+	{
+		return !Playing.load();
+	}
+
+	virtual FString GetStats()
+	{
+		FString stats;
+		stats.Format("Software stream, %dHz, %u frames buffered", SampleRate, Buffer.Size() / 2);
+		return stats;
+	}
+
+	void Mix(float *out, int frames, float gain)
+	{
+		if (!Playing.load() || Paused)
+			return;
+
+		const unsigned needed = unsigned(((Pos + Step * (frames - 1)) >> 32) + 2);
+		if (!Fill(needed))
+		{
+			// Play out what is left, then report the stream as ended.
+			while (Buffer.Size() < needed * 2)
+				Buffer.Push(0.f);
+			Playing = false;
+		}
+
+		const float *src = Buffer.Data();
+		gain *= Volume;
+		uint64_t pos = Pos;
+		for (int i = 0; i < frames; i++)
+		{
+			const unsigned idx = unsigned(pos >> 32) * 2;
+			const float frac = float(uint32_t(pos)) * (1.f / 4294967296.f);
+			out[i * 2] += (src[idx] + (src[idx + 2] - src[idx]) * frac) * gain;
+			out[i * 2 + 1] += (src[idx + 1] + (src[idx + 3] - src[idx + 1]) * frac) * gain;
+			pos += Step;
+		}
+		Buffer.Delete(0, unsigned(pos >> 32) * 2);
+		Pos = pos & 0xffffffffu;
+	}
+};
+
+//==========================================================================
+//
+// SoftSoundRenderer
+//
+//==========================================================================
+
+SoftSoundRenderer::SoftSoundRenderer(const char *ticoutput)
+	: QuitThread(false), Output(nullptr), OutputBytes(0), Realtime(ticoutput == nullptr), TicsMixed(0),
+	ReverbLevel(0), LowpassGain(1.f), PrevEnvironment(nullptr),
+	SfxVolume(1.f), MusicVolume(1.f), MasterGain(1.f), SFXPaused(0), Synced(false), WasInWater(false),
+	FramesMixed(0), MixTime(0), PeakVoices(0)
+{
+	Printf("I_InitSound: Initializing software mixer\n");
+
+	OutputRate = *snd_samplerate > 0 ? *snd_samplerate : 44100;
+	LowpassState[0] = LowpassState[1] = 0;
+	Listener = {};
+
+	Voices.Resize(std::max<int>(snd_channels, 2));
+	memset(Voices.Data(), 0, Voices.Size() * sizeof(SoftVoice));
+	for (int i = Voices.Size() - 1; i >= 0; i--)
+		FreeVoices.Push(i);
+
+	MixBuffer.Resize(BlockSize * 2);
+	VoiceBuffer.Resize(BlockSize * 2);
+	SendBuffer.Resize(BlockSize);
+	OutBuffer.Resize(BlockSize * 2);
+
+	// Two slightly detuned banks, one per output channel, so the tail isn't mono.
+	static const int combdelays[NumCombs] = { 1116, 1188, 1277, 1356 };
+	static const int allpassdelays[NumAllpasses] = { 556, 441 };
+	for (int side = 0; side < 2; side++)
+	{
+		for (int i = 0; i < NumCombs; i++)
+		{
+			Combs[side][i].Buffer.Resize((combdelays[i] + side * 23) * OutputRate / 44100);
+			Combs[side][i].Index = 0;
+		}
+		for (int i = 0; i < NumAllpasses; i++)
+		{
+			Allpasses[side][i].Buffer.Resize((allpassdelays[i] + side * 23) * OutputRate / 44100);
+			Allpasses[side][i].Index = 0;
+		}
+	}
+	LoadReverb(DefaultEnvironments[0]);
+
+	const char *outputname = Realtime ? *snd_softoutput : ticoutput;
+	if (*outputname)
+	{
+		Output = FileWriter::Open(outputname);
+		if (Output == nullptr)
+		{
+			Printf("Unable to open %s. Using the null sink.\n", outputname);
+		}
+		else
+		{
+			// The sizes get filled in on close.
+			uint8_t header[44] = { 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 2, 0 };
+			uint32_t rate = LittleLong(OutputRate), byterate = LittleLong(OutputRate * 4);
+			memcpy(header + 24, &rate, 4);
+			memcpy(header + 28, &byterate, 4);
+			header[32] = 4;
+			header[34] = 16;
+			memcpy(header + 36, "data", 4);
+			Output->Write(header, 44);
+		}
+	}
+
+	if (Realtime)
+		MixerThread = std::thread(std::mem_fn(&SoftSoundRenderer::MixerProc), this);
+}
+
+SoftSoundRenderer::~SoftSoundRenderer()
+{
+	QuitThread = true;
+	if (MixerThread.joinable())
+		MixerThread.join();
+
+	if (Output != nullptr)
+	{
+		uint32_t size = LittleLong(OutputBytes + 36);
+		Output->Seek(4, SEEK_SET);
+		Output->Write(&size, 4);
+		size = LittleLong(OutputBytes);
+		Output->Seek(40, SEEK_SET);
+		Output->Write(&size, 4);
+		delete Output;
+	}
+}
+
+//==========================================================================
+//
+// The mixer
+//
+//==========================================================================
+
+void SoftSoundRenderer::MixerProc()
+{
+	using namespace std::chrono;
+
+	auto start = steady_clock::now();
+	uint64_t frames = 0;
+
+	while (!QuitThread.load())
+	{
+		{
+			std::lock_guard<std::mutex> lock(MixLock);
+			MixBlock(BlockSize);
+			WriteOutput(BlockSize);
+		}
+		frames += BlockSize;
+
+		// Stay in step with real time so that sounds end when the game expects
+		// them to, but don't try to catch up after having been held up.
+		auto due = start + microseconds(frames * 1000000 / OutputRate);
+		auto now = steady_clock::now();
+		if (now > due + milliseconds(100))
+			start = now - microseconds(frames * 1000000 / OutputRate);
+		else
+			std::this_thread::sleep_until(due);
+	}
+}
+
+void SoftSoundRenderer::MixTic(int ticrate)
+{
+	if (Realtime || ticrate <= 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(MixLock);
+	const uint64_t due = ++TicsMixed * OutputRate / ticrate;
+	while (FramesMixed < due)
+	{
+		int frames = int(std::min<uint64_t>(BlockSize, due - FramesMixed));
+		MixBlock(frames);
+		WriteOutput(frames);
+	}
+}
+
+void SoftSoundRenderer::MixBlock(int frames)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	memset(MixBuffer.Data(), 0, frames * 2 * sizeof(float));
+	memset(SendBuffer.Data(), 0, frames * sizeof(float));
+
+	int active = 0;
+	if (!Synced)
+	{
+		for (auto &voice : Voices)
+		{
+			if (!voice.Active || voice.Ended || (voice.Pausable && SFXPaused))
+				continue;
+			MixVoice(voice, frames);
+			active++;
+		}
+	}
+	PeakVoices = std::max(PeakVoices, active);
+
+	if (WasInWater)
+	{
+		float *mix = MixBuffer.Data();
+		for (int i = 0; i < frames; i++)
+		{
+			LowpassState[0] += (mix[i * 2] - LowpassState[0]) * LowpassGain;
+			LowpassState[1] += (mix[i * 2 + 1] - LowpassState[1]) * LowpassGain;
+			mix[i * 2] = LowpassState[0];
+			mix[i * 2 + 1] = LowpassState[1];
+		}
+	}
+
+	if (ReverbLevel > 0)
+		MixReverb(frames);
+
+	for (auto stream : Streams)
+		stream->Mix(MixBuffer.Data(), frames, MusicVolume);
+
+	FramesMixed += frames;
+	MixTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SoftSoundRenderer::MixVoice(SoftVoice &voice, int frames)
+{
+	const SoftSample *sample = voice.Sample;
+	const float *src = sample->Data.Data();
+	const int chans = sample->Channels;
+	const uint32_t loopstart = voice.Looping ? sample->LoopStart : 0;
+	const uint32_t end = voice.Looping ? sample->LoopEnd : sample->Length;
+	float *dst = VoiceBuffer.Data();
+	uint64_t pos = voice.Pos;
+	const uint64_t step = voice.Step;
+	int i = 0;
+
+	// Unpitched sounds at the output rate need no resampling.
+	if (step == (uint64_t(1) << 32) && uint32_t(pos) == 0 && (pos >> 32) + frames <= end)
+	{
+		memcpy(dst, src + (pos >> 32) * chans, frames * chans * sizeof(float));
+		pos += uint64_t(frames) << 32;
+		i = frames;
+	}
+	for (; i < frames; i++)
+	{
+		uint32_t idx = uint32_t(pos >> 32);
+		if (idx >= end)
+		{
+			if (!voice.Looping || end <= loopstart)
+			{
+				voice.Ended = true;
+				break;
+			}
+			while (idx >= end)
+			{
+				pos -= uint64_t(end - loopstart) << 32;
+				idx = uint32_t(pos >> 32);
+			}
+		}
+		const uint32_t next = idx + 1 < end ? idx + 1 : voice.Looping ? loopstart : idx;
+		const float frac = float(uint32_t(pos)) * (1.f / 4294967296.f);
+		for (int c = 0; c < chans; c++)
+		{
+			const float s0 = src[idx * chans + c];
+			dst[i * chans + c] = s0 + (src[next * chans + c] - s0) * frac;
+		}
+		pos += step;
+	}
+	voice.Pos = pos;
+
+	if (i == 0)
+		return;
+
+	if (chans == 1)
+		MixMono(MixBuffer.Data(), dst, i, voice.Gain[0], voice.Gain[1]);
+	else
+		MixStereo(MixBuffer.Data(), dst, i, voice.Gain[0], voice.Gain[1]);
+
+	if (voice.Reverb)
+		MixSend(SendBuffer.Data(), dst, i, chans, (voice.Gain[0] + voice.Gain[1]) * 0.5f);
+}
+
+void SoftSoundRenderer::MixReverb(int frames)
+{
+	const float *send = SendBuffer.Data();
+	float *mix = MixBuffer.Data();
+
+	for (int side = 0; side < 2; side++)
+	{
+		for (int i = 0; i < frames; i++)
+		{
+			const float in = send[i] * ReverbLevel;
+			float out = 0;
+			for (auto &comb : Combs[side])
+			{
+				float y = comb.Buffer[comb.Index];
+				comb.Buffer[comb.Index] = in + y * comb.Feedback;
+				if (++comb.Index == comb.Buffer.Size()) comb.Index = 0;
+				out += y;
+			}
+			out *= 1.f / NumCombs;
+			for (auto &ap : Allpasses[side])
+			{
+				float b = ap.Buffer[ap.Index];
+				ap.Buffer[ap.Index] = out + b * 0.5f;
+				if (++ap.Index == ap.Buffer.Size()) ap.Index = 0;
+				out = b - out;
+			}
+			mix[i * 2 + side] += out;
+		}
+	}
+}
+
+void SoftSoundRenderer::WriteOutput(int frames)
+{
+	if (Output == nullptr)
+		return;
+
+	ConvertOutput(OutBuffer.Data(), MixBuffer.Data(), frames * 2, MasterGain);
+#ifdef __BIG_ENDIAN__
+	for (int i = 0; i < frames * 2; i++)
+		OutBuffer[i] = LittleShort(OutBuffer[i]);
+#endif
+	Output->Write(OutBuffer.Data(), frames * 4);
+	OutputBytes += frames * 4;
+}
+
+void SoftSoundRenderer::LoadReverb(const ReverbContainer *env)
+{
+	const float decay = clamp(env->Properties.DecayTime, 0.1f, 20.f);
+	ReverbLevel = clamp(mB2Gain(float(env->Properties.Room + env->Properties.Reverb)), 0.f, 1.f);
+
+	for (auto &side : Combs)
+	{
+		for (auto &comb : side)
+		{
+			// Feedback for a 60dB decay over the environment's decay time
+			float delay = comb.Buffer.Size() / float(OutputRate);
+			comb.Feedback = powf(10.f, -3.f * delay / decay);
+		}
+	}
+}
+
+//==========================================================================
+//
+// Voice handling
+//
+//==========================================================================
+
+void SoftSoundRenderer::CalcGain(SoftVoice &voice)
+{
+	float gain = SfxVolume * voice.Volume;
+	float pan = 0;
+
+	if (voice.Is3D)
+	{
+		FVector3 dir = voice.Position - Listener.position;
+		float dist = dir.Length();
+		gain *= soundEngine->GetRolloff(&voice.Rolloff, dist * voice.DistScale);
+
+		// Like OpenAL, only mono sounds get positioned.
+		if (dist >= 0.0004f && voice.Sample->Channels == 1)
+		{
+			// dot product with the listener's right vector
+			pan = (dir.X * sinf(Listener.angle) - dir.Z * cosf(Listener.angle)) / dist;
+			if (voice.Area && dist < AREA_SOUND_RADIUS)
+				pan *= dist / AREA_SOUND_RADIUS;
+		}
+	}
+	voice.Gain[0] = gain * std::min(1.f, 1.f - pan);
+	voice.Gain[1] = gain * std::min(1.f, 1.f + pan);
+}
+
+void SoftSoundRenderer::CalcStep(SoftVoice &voice)
+{
+	double pitch = voice.Pitch;
+	if (WasInWater && voice.Reverb)
+		pitch *= PITCH_MULT;
+	voice.Step = uint64_t(double(voice.Sample->Frequency) / OutputRate * pitch * 4294967296.);
+}
+
+FSoundChan *SoftSoundRenderer::FindLowestChannel()
+{
+	FSoundChan *schan = soundEngine->GetChannels();
+	FSoundChan *lowest = NULL;
+	while (schan)
+	{
+		if (schan->SysChannel != NULL)
+		{
+			if (!lowest || schan->Priority < lowest->Priority ||
+				(schan->Priority == lowest->Priority &&
+				schan->DistanceSqr > lowest->DistanceSqr))
+				lowest = schan;
+		}
+		schan = schan->NextChan;
+	}
+	return lowest;
+}
+
+// FreeVoices is only ever touched by the game thread, so this needs no locking.
+int SoftSoundRenderer::AllocVoice(int priority, float dist_sqr, bool force)
+{
+	if (FreeVoices.Size() == 0)
+	{
+		FSoundChan *lowest = FindLowestChannel();
+		if (lowest && (force || lowest->Priority < priority ||
+			(lowest->Priority == priority && lowest->DistanceSqr > dist_sqr)))
+			StopChannel(lowest);
+
+		if (FreeVoices.Size() == 0)
+			return -1;
+	}
+	int voice;
+	FreeVoices.Pop(voice);
+	return voice;
+}
+
+void SoftSoundRenderer::StartVoice(SoftVoice &voice, SoftSample *sample, float vol, int pitch, int chanflags, FISoundChannel *reuse_chan)
+{
+	voice.Sample = sample;
+	voice.Chan = nullptr;
+	voice.Volume = vol;
+	voice.Pitch = PITCH(pitch);
+	voice.Looping = !!(chanflags & SNDF_LOOP);
+	voice.Pausable = !(chanflags & SNDF_NOPAUSE);
+	voice.Reverb = !(chanflags & SNDF_NOREVERB);
+	voice.Ended = false;
+	voice.Pos = 0;
+
+	if (reuse_chan && reuse_chan->StartTime != 0)
+	{
+		if (chanflags & SNDF_ABSTIME)
+			voice.Pos = uint64_t(reuse_chan->StartTime) << 32;
+		else
+		{
+			float offset = std::chrono::duration_cast<std::chrono::duration<float>>(
+				std::chrono::steady_clock::now().time_since_epoch() -
+				std::chrono::steady_clock::time_point::duration(reuse_chan->StartTime)
+			).count();
+			if (offset > 0.f) voice.Pos = uint64_t(offset * sample->Frequency) << 32;
+		}
+	}
+	CalcStep(voice);
+	CalcGain(voice);
+	voice.Active = true;
+}
+
+FISoundChannel *SoftSoundRenderer::BindChannel(int voice, FISoundChannel *reuse_chan)
+{
+	FISoundChannel *chan = reuse_chan;
+	if (!chan) chan = soundEngine->GetChannel(MAKE_VOICEID(voice));
+	else chan->SysChannel = MAKE_VOICEID(voice);
+	Voices[voice].Chan = chan;
+	return chan;
+}
+
+FISoundChannel *SoftSoundRenderer::StartSound(SoundHandle sfx, float vol, int pitch, int chanflags, FISoundChannel *reuse_chan)
+{
+	SoftSample *sample = (SoftSample*)sfx.data;
+	if (sample == nullptr)
+		return NULL;
+
+	int v = AllocVoice(0, 0, true);
+	if (v < 0)
+		return NULL;
+
+	FISoundChannel *chan;
+	{
+		std::lock_guard<std::mutex> lock(MixLock);
+		SoftVoice &voice = Voices[v];
+		voice.Is3D = false;
+		voice.Area = false;
+		StartVoice(voice, sample, vol, pitch, chanflags, reuse_chan);
+		chan = BindChannel(v, reuse_chan);
+	}
+
+	chan->Rolloff.RolloffType = ROLLOFF_Log;
+	chan->Rolloff.RolloffFactor = 0.f;
+	chan->Rolloff.MinDistance = 1.f;
+	chan->DistanceSqr = 0.f;
+	chan->ManualRolloff = false;
+
+	return chan;
+}
+
+FISoundChannel *SoftSoundRenderer::StartSound3D(SoundHandle sfx, SoundListener *listener, float vol,
+	FRolloffInfo *rolloff, float distscale, int pitch, int priority, const FVector3 &pos, const FVector3 &vel,
+	int channum, int chanflags, FISoundChannel *reuse_chan)
+{
+	SoftSample *sample = (SoftSample*)sfx.data;
+	if (sample == nullptr)
+		return NULL;
+
+	float dist_sqr = (float)(pos - listener->position).LengthSquared();
+	int v = AllocVoice(priority, dist_sqr, false);
+	if (v < 0)
+		return NULL;
+
+	FISoundChannel *chan;
+	{
+		std::lock_guard<std::mutex> lock(MixLock);
+		SoftVoice &voice = Voices[v];
+		if (listener->valid) Listener = *listener;
+		voice.Is3D = true;
+		voice.Area = !!(chanflags & SNDF_AREA);
+		voice.Position = pos;
+		voice.Rolloff = *rolloff;
+		voice.DistScale = distscale;
+		StartVoice(voice, sample, vol, pitch, chanflags, reuse_chan);
+		chan = BindChannel(v, reuse_chan);
+	}
+
+	chan->Rolloff = *rolloff;
+	chan->DistanceSqr = dist_sqr;
+	chan->ManualRolloff = false;
+
+	return chan;
+}
+
+void SoftSoundRenderer::ChannelVolume(FISoundChannel *chan, float volume)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return;
+
+	std::lock_guard<std::mutex> lock(MixLock);
+	SoftVoice &voice = Voices[GET_VOICEID(chan->SysChannel)];
+	voice.Volume = volume;
+	CalcGain(voice);
+}
+
+void SoftSoundRenderer::ChannelPitch(FISoundChannel *chan, float pitch)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return;
+
+	std::lock_guard<std::mutex> lock(MixLock);
+	SoftVoice &voice = Voices[GET_VOICEID(chan->SysChannel)];
+	voice.Pitch = std::max(pitch, 0.0001f);
+	CalcStep(voice);
+}
+
+void SoftSoundRenderer::StopChannel(FISoundChannel *chan)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return;
+
+	int v = GET_VOICEID(chan->SysChannel);
+	// Release first, so it can be properly marked as evicted if it's being killed
+	soundEngine->ChannelEnded(chan);
+
+	std::lock_guard<std::mutex> lock(MixLock);
+	if (Voices[v].Active)
+	{
+		Voices[v].Active = false;
+		Voices[v].Chan = nullptr;
+		FreeVoices.Push(v);
+	}
+}
+
+unsigned int SoftSoundRenderer::GetPosition(FISoundChannel *chan)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return 0;
+
+	std::lock_guard<std::mutex> lock(MixLock);
+	return unsigned(Voices[GET_VOICEID(chan->SysChannel)].Pos >> 32);
+}
+
+void SoftSoundRenderer::SetSfxPaused(bool paused, int slot)
+{
+	std::lock_guard<std::mutex> lock(MixLock);
+	if (paused) SFXPaused |= 1 << slot;
+	else SFXPaused &= ~(1 << slot);
+}
+
+void SoftSoundRenderer::SetInactive(SoundRenderer::EInactiveState state)
+{
+	std::lock_guard<std::mutex> lock(MixLock);
+	MasterGain = state == SoundRenderer::INACTIVE_Active ? 1.f : 0.f;
+}
+
+void SoftSoundRenderer::Sync(bool sync)
+{
+	std::lock_guard<std::mutex> lock(MixLock);
+	Synced = sync;
+}
+
+void SoftSoundRenderer::UpdateSoundParams3D(SoundListener *listener, FISoundChannel *chan, bool areasound, const FVector3 &pos, const FVector3 &vel)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return;
+
+	chan->DistanceSqr = (float)(pos - listener->position).LengthSquared();
+
+	std::lock_guard<std::mutex> lock(MixLock);
+	SoftVoice &voice = Voices[GET_VOICEID(chan->SysChannel)];
+	voice.Position = pos;
+	voice.Area = areasound;
+	CalcGain(voice);
+}
+
+void SoftSoundRenderer::UpdateListener(SoundListener *listener)
+{
+	if (!listener->valid)
+		return;
+
+	std::lock_guard<std::mutex> lock(MixLock);
+	Listener = *listener;
+
+	const ReverbContainer *env = ForcedEnvironment;
+	if (!env)
+	{
+		env = listener->Environment;
+		if (!env)
+			env = DefaultEnvironments[0];
+	}
+	if (env != PrevEnvironment || env->Modified)
+	{
+		PrevEnvironment = env;
+		DPrintf(DMSG_NOTIFY, "Reverb Environment %s\n", env->Name);
+		LoadReverb(env);
+		const_cast<ReverbContainer*>(env)->Modified = false;
+	}
+
+	bool inwater = listener->underwater || env->SoftwareWater;
+	if (inwater != WasInWater)
+	{
+		WasInWater = inwater;
+		if (inwater && *snd_waterreverb)
+		{
+			// Find the "Underwater" reverb environment
+			env = S_FindEnvironment(0x1600);
+			LoadReverb(env ? env : DefaultEnvironments[0]);
+		}
+		else if (!inwater)
+		{
+			LoadReverb(env);
+		}
+		// Roughly what the OpenAL backend's low pass filter does.
+		LowpassGain = inwater ? 0.125f : 1.f;
+
+		for (auto &voice : Voices)
+		{
+			if (voice.Active) CalcStep(voice);
+		}
+	}
+
+	for (auto &voice : Voices)
+	{
+		if (voice.Active && voice.Is3D) CalcGain(voice);
+	}
+}
+
+void SoftSoundRenderer::UpdateSounds()
+{
+	// Release channels the mixer has played to the end. This must happen on
+	// the game thread, since it calls back into the sound engine.
+	TArray<FISoundChannel*> ended;
+	{
+		std::lock_guard<std::mutex> lock(MixLock);
+		for (auto &voice : Voices)
+		{
+			if (voice.Active && voice.Ended && voice.Chan)
+				ended.Push(voice.Chan);
+		}
+	}
+	for (auto chan : ended)
+		StopChannel(chan);
+}
+
+void SoftSoundRenderer::MarkStartTime(FISoundChannel *chan)
+{
+	chan->StartTime = std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+float SoftSoundRenderer::GetAudibility(FISoundChannel *chan)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return 0.f;
+
+	float volume;
+	{
+		std::lock_guard<std::mutex> lock(MixLock);
+		volume = SfxVolume * Voices[GET_VOICEID(chan->SysChannel)].Volume;
+	}
+	volume *= soundEngine->GetRolloff(&chan->Rolloff, sqrtf(chan->DistanceSqr) * chan->DistanceScale);
+	return volume;
+}
+
+//==========================================================================
+//
+// Sound data
+//
+//==========================================================================
+
+void SoftSoundRenderer::SetSfxVolume(float volume)
+{
+	std::lock_guard<std::mutex> lock(MixLock);
+	SfxVolume = volume;
+	for (auto &voice : Voices)
+	{
+		if (voice.Active) CalcGain(voice);
+	}
+}
+
+void SoftSoundRenderer::SetMusicVolume(float volume)
+{
+	std::lock_guard<std::mutex> lock(MixLock);
+	MusicVolume = volume;
+}
+
+SoundHandle SoftSoundRenderer::LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend)
+{
+	SoundHandle retval = { NULL };
+
+	if (length == 0) return retval;
+
+	if ((channels != 1 && channels != 2) || (bits != 8 && bits != -8 && bits != 16) || frequency <= 0)
+	{
+		Printf("Unhandled format: %d bit, %d channel, %d hz\n", bits, channels, frequency);
+		return retval;
+	}
+
+	const int frames = length / (channels * abs(bits) / 8);
+	const int count = frames * channels;
+	SoftSample *sample = new SoftSample;
+	sample->Data.Resize(count);
+	float *dst = sample->Data.Data();
+
+	if (bits == 16)
+	{
+		for (int i = 0; i < count; i++)
+			dst[i] = LittleShort(((int16_t*)sfxdata)[i]) / 32768.f;
+	}
+	else
+	{
+		const int bias = bits == 8 ? 128 : 0;
+		for (int i = 0; i < count; i++)
+			dst[i] = (bits == 8 ? sfxdata[i] - bias : (int8_t)sfxdata[i]) / 128.f;
+	}
+
+	sample->Channels = channels;
+	sample->Frequency = frequency;
+	sample->Length = frames;
+	sample->LoopStart = loopstart > 0 ? std::min(loopstart, frames) : 0;
+	sample->LoopEnd = loopend > int(sample->LoopStart) ? std::min(loopend, frames) : frames;
+
+	retval.data = sample;
+	return retval;
+}
+
+SoundHandle SoftSoundRenderer::LoadSound(uint8_t *sfxdata, int length)
+{
+	DecodedSound snd;
+	if (!DecodeSound(sfxdata, length, snd))
+		return { NULL };
+	return LoadSoundDecoded(snd);
+}
+
+void SoftSoundRenderer::UnloadSound(SoundHandle sfx)
+{
+	if (!sfx.data)
+		return;
+
+	FSoundChan *schan = soundEngine->GetChannels();
+	while (schan)
+	{
+		if (schan->SysChannel && Voices[GET_VOICEID(schan->SysChannel)].Sample == sfx.data)
+		{
+			FSoundChan *next = schan->NextChan;
+			StopChannel(schan);
+			schan = next;
+			continue;
+		}
+		schan = schan->NextChan;
+	}
+
+	delete (SoftSample*)sfx.data;
+}
+
+unsigned int SoftSoundRenderer::GetMSLength(SoundHandle sfx)
+{
+	SoftSample *sample = (SoftSample*)sfx.data;
+	return sample ? (unsigned int)(sample->Length * 1000. / sample->Frequency) : 0;
+}
+
+unsigned int SoftSoundRenderer::GetSampleLength(SoundHandle sfx)
+{
+	SoftSample *sample = (SoftSample*)sfx.data;
+	return sample ? sample->Length : 0;
+}
+
+float SoftSoundRenderer::GetOutputRate()
+{
+	return (float)OutputRate;
+}
+
+SoundStream *SoftSoundRenderer::CreateStream(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata)
+{
+	SoftSoundStream *stream = new SoftSoundStream(this);
+	if (!stream->Init(callback, buffbytes, flags, samplerate, userdata))
+	{
+		delete stream;
+		return NULL;
+	}
+	return stream;
+}
+
+//==========================================================================
+//
+// Status
+//
+//==========================================================================
+
+bool SoftSoundRenderer::IsValid()
+{
+	return true;
+}
+
+void SoftSoundRenderer::PrintStatus()
+{
+	Printf("Output: " TEXTCOLOR_ORANGE "%s\n", Output ? *snd_softoutput : "null sink");
+	Printf("Sample rate: " TEXTCOLOR_BLUE "%d" TEXTCOLOR_NORMAL "hz\n", OutputRate);
+	Printf("Voices: " TEXTCOLOR_BLUE "%u" TEXTCOLOR_NORMAL "\n", Voices.Size());
+#ifdef SOFTSOUND_SSE
+	Printf("Mixing with SSE\n");
+#endif
+}
+
+void SoftSoundRenderer::PrintDriversList()
+{
+	Printf("The software mixer uses no drivers.\n");
+}
+
+FString SoftSoundRenderer::GatherStats()
+{
+	FString out;
+	double seconds = FramesMixed / double(OutputRate);
+	out.Format("%u voices, %d peak, %.2f%% CPU spent mixing", Voices.Size() - FreeVoices.Size(), PeakVoices,
+		seconds > 0 ? MixTime / (seconds * 10000.) : 0.);
+	return out;
+}
+
+//==========================================================================
+//
+// Benchmark
+//
+//==========================================================================
+
+void SoftSoundRenderer::Benchmark(float seconds, int voices)
+{
+	voices = std::max(voices, 0);
+
+	TArray<SoftSample*> samples;
+	for (auto &sfx : soundEngine->GetSounds())
+	{
+		if (sfx.data.isValid() && samples.Find((SoftSample*)sfx.data.data) == samples.Size())
+			samples.Push((SoftSample*)sfx.data.data);
+	}
+	if (samples.Size() == 0 && voices > 0)
+	{
+		Printf("No sounds are loaded, mixing only what is already playing.\n");
+		voices = 0;
+	}
+
+	std::lock_guard<std::mutex> lock(MixLock);
+
+	// Everything is mixed into scratch buffers and never reaches the output
+	// file. What was already playing, the reverb and low pass state and the
+	// statistics are put back afterwards, so the benchmark neither advances
+	// the game's sounds nor eats into the music, and leaves no tail behind.
+	TArray<SoftVoice> savedVoices = Voices;
+	TArray<SoftSoundStream*> savedStreams;
+	TArray<float> scratch(BlockSize * 2, true);
+	TArray<int16_t> scratchOut(BlockSize * 2, true);
+	Comb savedCombs[2][NumCombs];
+	Allpass savedAllpasses[2][NumAllpasses];
+	for (int side = 0; side < 2; side++)
+	{
+		for (int i = 0; i < NumCombs; i++) savedCombs[side][i] = Combs[side][i];
+		for (int i = 0; i < NumAllpasses; i++) savedAllpasses[side][i] = Allpasses[side][i];
+	}
+	const float savedLowpass[2] = { LowpassState[0], LowpassState[1] };
+	const uint64_t savedFramesMixed = FramesMixed, savedMixTime = MixTime;
+	const int savedPeakVoices = PeakVoices;
+	Streams.Swap(savedStreams);
+	MixBuffer.Swap(scratch);
+
+	// The extra voices are appended and never handed to the sound engine, so
+	// they can simply be dropped again afterwards.
+	const unsigned first = Voices.Size();
+	Voices.Resize(first + voices);
+	uint32_t seed = 1;
+	for (int i = 0; i < voices; i++)
+	{
+		SoftVoice &voice = Voices[first + i];
+		memset(&voice, 0, sizeof(voice));
+		seed = seed * 1103515245 + 12345;
+		voice.Is3D = true;
+		voice.Position = Listener.position + FVector3(float(int(seed >> 16) % 1024 - 512), 0.f, float(int(seed >> 4) % 1024 - 512));
+		voice.Rolloff = soundEngine->GlobalRolloff();
+		voice.DistScale = 1.f;
+		StartVoice(voice, samples[i % samples.Size()], 1.f, 128, SNDF_LOOP, nullptr);
+	}
+
+	const uint64_t total = uint64_t(seconds * OutputRate);
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t done = 0; done < total; done += BlockSize)
+	{
+		int frames = int(std::min<uint64_t>(BlockSize, total - done));
+		MixBlock(frames);
+		ConvertOutput(scratchOut.Data(), MixBuffer.Data(), frames * 2, MasterGain);
+	}
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	int active = 0;
+	for (auto &voice : Voices)
+		if (voice.Active && !voice.Ended) active++;
+
+	const uint64_t benchmixtime = MixTime - savedMixTime;
+
+	Voices.Swap(savedVoices);
+	Streams.Swap(savedStreams);
+	MixBuffer.Swap(scratch);
+	for (int side = 0; side < 2; side++)
+	{
+		for (int i = 0; i < NumCombs; i++) Combs[side][i] = std::move(savedCombs[side][i]);
+		for (int i = 0; i < NumAllpasses; i++) Allpasses[side][i] = std::move(savedAllpasses[side][i]);
+	}
+	LowpassState[0] = savedLowpass[0];
+	LowpassState[1] = savedLowpass[1];
+	FramesMixed = savedFramesMixed;
+	MixTime = savedMixTime;
+	PeakVoices = savedPeakVoices;
+
+	Printf("Mixed %.1f seconds with %d voices in %.1f ms (%.1f ms mixing), %.1fx realtime\n",
+		seconds, active, elapsed * 1000., benchmixtime / 1000., elapsed > 0 ? seconds / elapsed : 0.);
+}
+
+CCMD(snd_softbench)
+{
+	auto renderer = dynamic_cast<SoftSoundRenderer*>(GSnd);
+	if (renderer == nullptr)
+	{
+		Printf("snd_softbench needs snd_backend \"software\"\n");
+		return;
+	}
+	if (argv.argc() < 2)
+	{
+		Printf("Usage: snd_softbench <seconds> [extra voices]\n");
+		return;
+	}
+	renderer->Benchmark((float)atof(argv[1]), argv.argc() > 2 ? std::max(atoi(argv[2]), 0) : 0);
+}
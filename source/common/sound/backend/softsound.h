@@ -0,0 +1,193 @@
+#ifndef SOFTSOUND_H
+#define SOFTSOUND_H
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "i_sound.h"
+#include "s_soundinternal.h"
+
+class FileWriter;
+class SoftSoundStream;
+
+// A loaded sound, converted to float at load time so the mixer never has to
+// care about the source format.
+struct SoftSample
+{
+	TArray<float> Data;
+	int Channels;
+	int Frequency;
+	uint32_t Length;		// in frames
+	uint32_t LoopStart;
+	uint32_t LoopEnd;
+};
+
+struct SoftVoice
+{
+	SoftSample *Sample;
+	FISoundChannel *Chan;	// null for the benchmark's voices
+
+	uint64_t Pos;			// 32.32 fixed point frame position
+	uint64_t Step;
+	float Pitch;
+	float Volume;
+	float Gain[2];			// final left/right gain, recalculated whenever anything affecting it changes
+
+	FRolloffInfo Rolloff;
+	float DistScale;
+	FVector3 Position;
+
+	bool Active;
+	bool Ended;				// set by the mixer, picked up by UpdateSounds
+	bool Looping;
+	bool Pausable;
+	bool Reverb;
+	bool Is3D;
+	bool Area;
+};
+
+class SoftSoundRenderer : public SoundRenderer
+{
+public:
+	// With a file name, the renderer writes to that file and has no mixer
+	// thread; MixTic() drives it instead. Otherwise it follows snd_softoutput.
+	SoftSoundRenderer(const char *ticoutput = nullptr);
+	virtual ~SoftSoundRenderer();
+
+	virtual void SetSfxVolume(float volume);
+	virtual void SetMusicVolume(float volume);
+	virtual SoundHandle LoadSound(uint8_t *sfxdata, int length);
+	virtual SoundHandle LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend = -1);
+	virtual void UnloadSound(SoundHandle sfx);
+	virtual unsigned int GetMSLength(SoundHandle sfx);
+	virtual unsigned int GetSampleLength(SoundHandle sfx);
+	virtual float GetOutputRate();
+
+	// Streaming sounds.
+	virtual SoundStream *CreateStream(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata);
+
+	// Starts a sound.
+	virtual FISoundChannel *StartSound(SoundHandle sfx, float vol, int pitch, int chanflags, FISoundChannel *reuse_chan);
+	virtual FISoundChannel *StartSound3D(SoundHandle sfx, SoundListener *listener, float vol, FRolloffInfo *rolloff, float distscale, int pitch, int priority, const FVector3 &pos, const FVector3 &vel, int channum, int chanflags, FISoundChannel *reuse_chan);
+
+	// Changes a channel's volume.
+	virtual void ChannelVolume(FISoundChannel *chan, float volume);
+
+	// Changes a channel's pitch.
+	virtual void ChannelPitch(FISoundChannel *chan, float pitch);
+
+	// Stops a sound channel.
+	virtual void StopChannel(FISoundChannel *chan);
+
+	// Returns position of sound on this channel, in samples.
+	virtual unsigned int GetPosition(FISoundChannel *chan);
+
+	// Synchronizes following sound startups.
+	virtual void Sync(bool sync);
+
+	// Pauses or resumes all sound effect channels.
+	virtual void SetSfxPaused(bool paused, int slot);
+
+	// Pauses or resumes *every* channel, including environmental reverb.
+	virtual void SetInactive(SoundRenderer::EInactiveState inactive);
+
+	// Updates the volume, separation, and pitch of a sound channel.
+	virtual void UpdateSoundParams3D(SoundListener *listener, FISoundChannel *chan, bool areasound, const FVector3 &pos, const FVector3 &vel);
+
+	virtual void UpdateListener(SoundListener *);
+	virtual void UpdateSounds();
+
+	virtual void MarkStartTime(FISoundChannel*);
+	virtual float GetAudibility(FISoundChannel*);
+
+	virtual bool IsValid();
+	virtual void PrintStatus();
+	virtual void PrintDriversList();
+	virtual FString GatherStats();
+
+	// Mixes the given amount of audio as fast as possible, with 'voices' extra
+	// looping sounds on top of whatever is playing, and reports how long it took.
+	void Benchmark(float seconds, int voices);
+
+	// Mixes one game tic's worth of audio right away. Only does something for
+	// a renderer created with a tic output file, whose output then depends on
+	// nothing but the game, so it is the same on every run.
+	void MixTic(int ticrate);
+
+private:
+	friend class SoftSoundStream;
+
+	enum
+	{
+		BlockSize = 512,	// frames mixed per pass
+		NumCombs = 4,
+		NumAllpasses = 2,
+	};
+
+	struct Comb
+	{
+		TArray<float> Buffer;
+		unsigned Index;
+		float Feedback;
+	};
+	struct Allpass
+	{
+		TArray<float> Buffer;
+		unsigned Index;
+	};
+
+	void MixerProc();
+	void MixBlock(int frames);
+	void MixVoice(SoftVoice &voice, int frames);
+	void MixReverb(int frames);
+	void WriteOutput(int frames);
+	void LoadReverb(const ReverbContainer *env);
+	void CalcGain(SoftVoice &voice);
+	void CalcStep(SoftVoice &voice);
+	int AllocVoice(int priority, float dist_sqr, bool force);
+	void StartVoice(SoftVoice &voice, SoftSample *sample, float vol, int pitch, int chanflags, FISoundChannel *reuse_chan);
+	FISoundChannel *BindChannel(int voice, FISoundChannel *reuse_chan);
+	static FSoundChan *FindLowestChannel();
+
+	std::thread MixerThread;
+	std::mutex MixLock;
+	std::atomic<bool> QuitThread;
+
+	FileWriter *Output;
+	uint32_t OutputBytes;
+	int OutputRate;
+	bool Realtime;				// mixed by MixerProc, as opposed to MixTic
+	uint64_t TicsMixed;
+
+	TArray<SoftVoice> Voices;
+	TArray<int> FreeVoices;
+	TArray<SoftSoundStream*> Streams;
+
+	// Mixing buffers, all BlockSize frames long
+	TArray<float> MixBuffer;	// interleaved stereo
+	TArray<float> VoiceBuffer;	// resampled voice, mono or interleaved stereo
+	TArray<float> SendBuffer;	// mono reverb send
+	TArray<int16_t> OutBuffer;
+
+	Comb Combs[2][NumCombs];
+	Allpass Allpasses[2][NumAllpasses];
+	float ReverbLevel;
+	float LowpassGain;			// one-pole low pass on the dry mix, for underwater
+	float LowpassState[2];
+
+	SoundListener Listener;
+	const ReverbContainer *PrevEnvironment;
+	float SfxVolume;
+	float MusicVolume;
+	float MasterGain;
+	int SFXPaused;
+	bool Synced;
+	bool WasInWater;
+
+	uint64_t FramesMixed;
+	uint64_t MixTime;			// in microseconds
+	int PeakVoices;
+};
+
+#endif
@@ -35,11 +35,17 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "s_soundinternal.h"
 #include "m_swap.h"
 #include "superfasthash.h"
 #include "c_cvars.h"
+#include "c_dispatch.h"
 #include "name.h"
 #include "filesystem.h"
 #include "cmdlib.h"
@@ -85,6 +91,7 @@ void SoundEngine::Clear()
 	StopAllChannels();
 	UnloadAllSounds();
 	GetSounds().Clear();
+	LoadedLumps.Clear();
 	ClearRandoms();
 }
 
@@ -136,13 +143,16 @@ void SoundEngine::CacheMarkedSounds()
 		MarkUsed(chan->SoundID);
 	}
 
+	TArray<sfxinfo_t*> list;
 	for (unsigned i = 1; i < S_sfx.Size(); ++i)
 	{
 		if (S_sfx[i].bUsed)
 		{
-			CacheSound(&S_sfx[i]);
+			GatherSound(&S_sfx[i], list);
 		}
 	}
+	LoadSounds(list);
+
 	for (unsigned i = 1; i < S_sfx.Size(); ++i)
 	{
 		if (!S_sfx[i].bUsed && S_sfx[i].link == sfxinfo_t::NO_LINK)
@@ -152,6 +162,55 @@ void SoundEngine::CacheMarkedSounds()
 	}
 }
 
+//==========================================================================
+//
+// Cache all defined sounds
+//
+//==========================================================================
+
+void SoundEngine::CacheAllSounds(void (*progress)())
+{
+	TArray<sfxinfo_t*> list;
+	for (unsigned i = 1; i < S_sfx.Size(); ++i)
+	{
+		GatherSound(&S_sfx[i], list);
+	}
+	LoadSounds(list, progress);
+}
+
+//==========================================================================
+//
+// GatherSound
+//
+// Collects what CacheSound would load for this sound, for LoadSounds.
+//
+//==========================================================================
+
+void SoundEngine::GatherSound(sfxinfo_t* sfx, TArray<sfxinfo_t*>& list)
+{
+	if (GSnd && !sfx->bTentative)
+	{
+		while (!sfx->bRandomHeader && sfx->link != sfxinfo_t::NO_LINK)
+		{
+			sfx = &S_sfx[sfx->link];
+		}
+		if (sfx->bRandomHeader)
+		{
+			const FRandomSoundList* rlist = &S_rnd[sfx->link];
+			for (unsigned i = 0; i < rlist->Choices.Size(); ++i)
+			{
+				S_sfx[rlist->Choices[i]].bUsed = true;
+				GatherSound(&S_sfx[rlist->Choices[i]], list);
+			}
+		}
+		else
+		{
+			list.Push(sfx);
+			sfx->bUsed = true;
+		}
+	}
+}
+
 //==========================================================================
 //
 // S_CacheSound
@@ -189,7 +248,12 @@ void SoundEngine::CacheSound (sfxinfo_t *sfx)
 void SoundEngine::UnloadSound (sfxinfo_t *sfx)
 {
 	if (sfx->data.isValid())
+	{
+		unsigned* owner = LoadedLumps.CheckKey(sfx->lumpnum);
+		if (owner && *owner == unsigned(sfx - S_sfx.Data()))
+			LoadedLumps.Remove(sfx->lumpnum);
 		GSnd->UnloadSound(sfx->data);
+	}
 	sfx->data.Clear();
 }
 
@@ -216,6 +280,7 @@ FSoundChan *SoundEngine::GetChannel(void *syschan)
 		memset(chan, 0, sizeof(*chan));
 	}
 	LinkChannel(chan, &Channels);
+	IndexChannel(chan);
 	chan->SysChannel = syschan;
 	return chan;
 }
@@ -231,6 +296,7 @@ FSoundChan *SoundEngine::GetChannel(void *syschan)
 void SoundEngine::ReturnChannel(FSoundChan *chan)
 {
 	UnlinkChannel(chan);
+	UnindexChannel(chan);
 	memset(chan, 0, sizeof(*chan));
 	LinkChannel(chan, &FreeChannels);
 }
@@ -267,6 +333,66 @@ void SoundEngine::LinkChannel(FSoundChan *chan, FSoundChan **head)
 	chan->PrevChan = head;
 }
 
+//==========================================================================
+//
+// IndexChannel
+//
+// Adds a channel to the lookup buckets for its OrgID, SoundID and Source.
+//
+//==========================================================================
+
+void SoundEngine::IndexChannel(FSoundChan *chan)
+{
+	unsigned buckets[NUM_CHANINDEX] = { SoundBucket(chan->OrgID), SoundBucket(chan->SoundID), SourceBucket(chan->Source) };
+
+	for (int i = 0; i < NUM_CHANINDEX; i++)
+	{
+		FSoundChan **head = &ChannelIndex[i][buckets[i]];
+		chan->NextIndexed[i] = *head;
+		if (*head != NULL)
+		{
+			(*head)->PrevIndexed[i] = &chan->NextIndexed[i];
+		}
+		*head = chan;
+		chan->PrevIndexed[i] = head;
+	}
+}
+
+//==========================================================================
+//
+// UnindexChannel
+//
+//==========================================================================
+
+void SoundEngine::UnindexChannel(FSoundChan *chan)
+{
+	for (int i = 0; i < NUM_CHANINDEX; i++)
+	{
+		if (chan->PrevIndexed[i] == NULL)
+			continue;
+
+		*(chan->PrevIndexed[i]) = chan->NextIndexed[i];
+		if (chan->NextIndexed[i] != NULL)
+		{
+			chan->NextIndexed[i]->PrevIndexed[i] = chan->PrevIndexed[i];
+		}
+		chan->NextIndexed[i] = NULL;
+		chan->PrevIndexed[i] = NULL;
+	}
+}
+
+//==========================================================================
+//
+// ReindexChannel
+//
+//==========================================================================
+
+void SoundEngine::ReindexChannel(FSoundChan *chan)
+{
+	UnindexChannel(chan);
+	IndexChannel(chan);
+}
+
 //==========================================================================
 //
 //
@@ -527,8 +653,12 @@ FSoundChan *SoundEngine::StartSound(int type, const void *source,
 	// If this actor is already playing something on the selected channel, stop it.
 	if (!(chanflags & CHANF_OVERLAP) && type != SOURCE_None && ((source == NULL && channel != CHAN_AUTO) || (source != NULL && IsChannelUsed(type, source, channel, &seen))))
 	{
-		for (chan = Channels; chan != NULL; chan = chan->NextChan)
+		// Unattached sounds are matched by position, so they can't use the source index.
+		const bool bysource = type != SOURCE_Unattached;
+		FSoundChan *next;
+		for (chan = bysource ? ChannelIndex[CHANINDEX_Source][SourceBucket(source)] : Channels; chan != NULL; chan = next)
 		{
+			next = bysource ? chan->NextIndexed[CHANINDEX_Source] : chan->NextChan;
 			if (chan->SourceType == type && chan->EntChannel == channel)
 			{
 				const bool foundit = (type == SOURCE_Unattached)
@@ -616,6 +746,7 @@ FSoundChan *SoundEngine::StartSound(int type, const void *source,
 		{
 			chan->Source = source;
 		}
+		ReindexChannel(chan);
 
 		if (spitch > 0.0)
 			SetPitch(chan, spitch);
@@ -693,6 +824,107 @@ void SoundEngine::RestartChannel(FSoundChan *chan)
 	}
 }
 
+//==========================================================================
+//
+// SoundEngine :: FindLoadedLump
+//
+// Returns the index of a loaded sound this one can share its buffer with,
+// or -1 if there is none. LoadedLumps is only a hint, since the games can
+// modify S_sfx directly, so the entry gets validated before being used.
+//
+//==========================================================================
+
+static bool CanShareLump(const sfxinfo_t* owner, const sfxinfo_t* sfx)
+{
+	// Raw sounds with different sample rates may not share buffers, even if they use the same source data.
+	return owner->data.isValid() && owner->link == sfxinfo_t::NO_LINK && owner->lumpnum == sfx->lumpnum &&
+		(!sfx->bLoadRAW || (sfx->RawRate == owner->RawRate));
+}
+
+int SoundEngine::FindLoadedLump(sfxinfo_t* sfx)
+{
+	unsigned* owner = LoadedLumps.CheckKey(sfx->lumpnum);
+	if (owner == nullptr)
+		return -1;
+
+	if (*owner < S_sfx.Size() && CanShareLump(&S_sfx[*owner], sfx))
+		return *owner;
+
+	// Either the index is stale or this is a raw sound with a different
+	// sample rate. Both are rare enough for the old linear search.
+	for (unsigned i = 0; i < S_sfx.Size(); i++)
+	{
+		if (CanShareLump(&S_sfx[i], sfx))
+		{
+			AddLoadedLump(&S_sfx[i]);
+			return i;
+		}
+	}
+	return -1;
+}
+
+void SoundEngine::AddLoadedLump(sfxinfo_t* sfx)
+{
+	unsigned index = unsigned(sfx - S_sfx.Data());
+	unsigned* owner = LoadedLumps.CheckKey(sfx->lumpnum);
+
+	if (owner == nullptr || *owner >= S_sfx.Size() || !S_sfx[*owner].data.isValid() || S_sfx[*owner].lumpnum != sfx->lumpnum)
+		LoadedLumps[sfx->lumpnum] = index;
+}
+
+//==========================================================================
+//
+// SoundEngine :: DecodeSfx
+//
+// Turns a sound lump into PCM data. This does not touch the sound renderer
+// or the engine's state, so it is safe to call from worker threads.
+//
+//==========================================================================
+
+bool SoundEngine::DecodeSfx(sfxinfo_t* sfx, TArray<uint8_t>& sfxdata, DecodedSound& snd, bool quiet, int streamthreshold)
+{
+	int size = sfxdata.Size();
+	if (size <= 8)
+		return false;
+
+	int32_t dmxlen = LittleLong(((int32_t *)sfxdata.Data())[1]);
+
+	// If the sound is voc, use the custom loader.
+	if (strncmp ((const char *)sfxdata.Data(), "Creative Voice File", 19) == 0)
+	{
+		return SoundRenderer::DecodeSoundVoc(sfxdata.Data(), size, snd);
+	}
+	// If the sound is raw, just load it as such.
+	else if (sfx->bLoadRAW)
+	{
+		snd.data = std::move(sfxdata);
+		snd.frequency = sfx->RawRate;
+		snd.channels = 1;
+		snd.bits = 8;
+		snd.loopstart = sfx->LoopStart;
+		return true;
+	}
+	// Otherwise, try the sound as DMX format.
+	else if (((uint8_t *)sfxdata.Data())[0] == 3 && ((uint8_t *)sfxdata.Data())[1] == 0 && dmxlen <= size - 8)
+	{
+		int frequency = LittleShort(((uint16_t *)sfxdata.Data())[1]);
+		if (frequency == 0) frequency = 11025;
+		snd.data = std::move(sfxdata);
+		snd.data.Delete(0, 8);
+		snd.data.Resize(dmxlen);
+		snd.frequency = frequency;
+		snd.channels = 1;
+		snd.bits = 8;
+		snd.loopstart = sfx->LoopStart;
+		return true;
+	}
+	// If that fails, let the sound system try and figure it out.
+	else
+	{
+		return SoundRenderer::DecodeSound(sfxdata.Data(), size, snd, quiet, streamthreshold);
+	}
+}
+
 //==========================================================================
 //
 // S_LoadSound
@@ -703,12 +935,10 @@ void SoundEngine::RestartChannel(FSoundChan *chan)
 
 sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx)
 {
-	if (GSnd->IsNull()) return sfx;
+	if (!GSnd || GSnd->IsNull()) return sfx;
 
 	while (!sfx->data.isValid())
 	{
-		unsigned int i;
-
 		// If the sound doesn't exist, replace it with the empty sound.
 		if (sfx->lumpnum == -1)
 		{
@@ -717,50 +947,24 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx)
 		
 		// See if there is another sound already initialized with this lump. If so,
 		// then set this one up as a link, and don't load the sound again.
-		for (i = 0; i < S_sfx.Size(); i++)
+		int i = FindLoadedLump(sfx);
+		if (i >= 0)
 		{
-			if (S_sfx[i].data.isValid() && S_sfx[i].link == sfxinfo_t::NO_LINK && S_sfx[i].lumpnum == sfx->lumpnum &&
-				(!sfx->bLoadRAW || (sfx->RawRate == S_sfx[i].RawRate)))	// Raw sounds with different sample rates may not share buffers, even if they use the same source data.
-			{
-				//DPrintf (DMSG_NOTIFY, "Linked %s to %s (%d)\n", sfx->name.GetChars(), S_sfx[i].name.GetChars(), i);
-				sfx->link = i;
-				// This is necessary to avoid using the rolloff settings of the linked sound if its
-				// settings are different.
-				if (sfx->Rolloff.MinDistance == 0) sfx->Rolloff = S_Rolloff;
-				return &S_sfx[i];
-			}
+			//DPrintf (DMSG_NOTIFY, "Linked %s to %s (%d)\n", sfx->name.GetChars(), S_sfx[i].name.GetChars(), i);
+			sfx->link = i;
+			// This is necessary to avoid using the rolloff settings of the linked sound if its
+			// settings are different.
+			if (sfx->Rolloff.MinDistance == 0) sfx->Rolloff = S_Rolloff;
+			return &S_sfx[i];
 		}
 
 		//DPrintf(DMSG_NOTIFY, "Loading sound \"%s\" (%td)\n", sfx->name.GetChars(), sfx - &S_sfx[0]);
 
 		auto sfxdata = ReadSound(sfx->lumpnum);
-		int size = sfxdata.Size();
-		if (size > 8)
+		DecodedSound snd;
+		if (DecodeSfx(sfx, sfxdata, snd, false, GSnd->GetStreamThreshold()))
 		{
-			int32_t dmxlen = LittleLong(((int32_t *)sfxdata.Data())[1]);
-
-			// If the sound is voc, use the custom loader.
-			if (strncmp ((const char *)sfxdata.Data(), "Creative Voice File", 19) == 0)
-			{
-				sfx->data = GSnd->LoadSoundVoc(sfxdata.Data(), size);
-			}
-			// If the sound is raw, just load it as such.
-			else if (sfx->bLoadRAW)
-			{
-				sfx->data = GSnd->LoadSoundRaw(sfxdata.Data(), size, sfx->RawRate, 1, 8, sfx->LoopStart);
-			}
-			// Otherwise, try the sound as DMX format.
-			else if (((uint8_t *)sfxdata.Data())[0] == 3 && ((uint8_t *)sfxdata.Data())[1] == 0 && dmxlen <= size - 8)
-			{
-				int frequency = LittleShort(((uint16_t *)sfxdata.Data())[1]);
-				if (frequency == 0) frequency = 11025;
-				sfx->data = GSnd->LoadSoundRaw(sfxdata.Data()+8, dmxlen, frequency, 1, 8, sfx->LoopStart);
-			}
-			// If that fails, let the sound system try and figure it out.
-			else
-			{
-				sfx->data = GSnd->LoadSound(sfxdata.Data(), size);
-			}
+			sfx->data = GSnd->LoadSoundDecoded(snd);
 		}
 
 		if (!sfx->data.isValid())
@@ -773,9 +977,128 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx)
 		}
 		break;
 	}
+	if (sfx->data.isValid()) AddLoadedLump(sfx);
 	return sfx;
 }
 
+//==========================================================================
+//
+// SoundEngine :: LoadSounds
+//
+// Batch version of LoadSound for level start. Reading the lumps and linking
+// sounds that share one happens on this thread, as does the final upload to
+// the sound renderer, but the decoding in between, which is where nearly all
+// the time goes for compressed formats, is spread over worker threads.
+// Each sound is uploaded as soon as it is ready, so only a handful of
+// decoded buffers exist at any time. 'progress' is called every few sounds
+// to let the game keep its event loop going.
+//
+//==========================================================================
+
+void SoundEngine::LoadSounds(TArray<sfxinfo_t*>& list, void (*progress)())
+{
+	if (!GSnd || GSnd->IsNull()) return;
+
+	struct PendingSound
+	{
+		sfxinfo_t* sfx;
+		TArray<uint8_t> sfxdata;
+		DecodedSound snd;
+		bool decoded;
+	};
+
+	std::vector<PendingSound> pending;
+	TArray<sfxinfo_t*> deferred;
+	TMap<int, bool> pendingLumps;
+
+	for (auto sfx : list)
+	{
+		if (sfx->data.isValid())
+			continue;
+
+		if (sfx->lumpnum == -1)
+			sfx->lumpnum = sfx_empty;
+
+		// Sounds sharing a lump with an already loaded one get linked right away,
+		// those sharing one with a sound decoded by this batch afterwards.
+		if (FindLoadedLump(sfx) >= 0)
+			LoadSound(sfx);
+		else if (pendingLumps.CheckKey(sfx->lumpnum))
+			deferred.Push(sfx);
+		else
+		{
+			pendingLumps[sfx->lumpnum] = true;
+			pending.push_back({ sfx, ReadSound(sfx->lumpnum), {}, false });
+		}
+	}
+
+	const unsigned count = (unsigned)pending.size();
+	const unsigned numworkers = std::min<unsigned>(std::thread::hardware_concurrency(), count / 4);
+	// Workers stay at most this far ahead of the uploads.
+	const unsigned window = std::max(numworkers, 1u) * 2;
+	const int streamthreshold = GSnd->GetStreamThreshold();
+
+	std::unique_ptr<std::atomic<bool>[]> done(new std::atomic<bool>[count]);
+	for (unsigned i = 0; i < count; i++) done[i] = false;
+	std::atomic<unsigned> next = { 0 };
+	std::atomic<unsigned> uploaded = { 0 };
+
+	auto decode = [&](unsigned i)
+	{
+		auto& p = pending[i];
+		p.decoded = DecodeSfx(p.sfx, p.sfxdata, p.snd, true, streamthreshold);
+		p.sfxdata.Reset();
+		done[i].store(true, std::memory_order_release);
+	};
+	auto worker = [&]()
+	{
+		for (unsigned i; (i = next++) < count; )
+		{
+			while (i >= uploaded.load(std::memory_order_acquire) + window)
+				std::this_thread::yield();
+			decode(i);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned i = 1; i < numworkers; i++)
+		workers.emplace_back(worker);
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		// Decode on this thread as well while waiting for the next sound in line.
+		while (!done[i].load(std::memory_order_acquire))
+		{
+			unsigned j = next.load();
+			if (j < i + window && j < count && next.compare_exchange_strong(j, j + 1))
+				decode(j);
+			else
+				std::this_thread::yield();
+		}
+
+		auto& p = pending[i];
+		// The progress callback may have played, and thereby loaded, this sound already.
+		if (p.decoded && !p.sfx->data.isValid())
+		{
+			p.sfx->data = GSnd->LoadSoundDecoded(p.snd);
+			if (p.sfx->data.isValid()) AddLoadedLump(p.sfx);
+		}
+		p.snd = {};
+		// Failures go through the regular path so that they get reported and replaced by the empty sound.
+		if (!p.sfx->data.isValid())
+			LoadSound(p.sfx);
+
+		uploaded.store(i + 1, std::memory_order_release);
+		if (progress && ((i + 1) & 31) == 0)
+			progress();
+	}
+	for (auto& thread : workers)
+		thread.join();
+
+	for (auto sfx : deferred)
+		LoadSound(sfx);
+}
+
 //==========================================================================
 //
 // S_CheckSingular
@@ -786,7 +1109,7 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx)
 
 bool SoundEngine::CheckSingular(int sound_id)
 {
-	for (FSoundChan *chan = Channels; chan != NULL; chan = chan->NextChan)
+	for (FSoundChan *chan = ChannelIndex[CHANINDEX_OrgID][SoundBucket(sound_id)]; chan != NULL; chan = chan->NextIndexed[CHANINDEX_OrgID])
 	{
 		if (chan->OrgID == sound_id)
 		{
@@ -818,11 +1141,12 @@ bool SoundEngine::CheckSoundLimit(sfxinfo_t *sfx, const FVector3 &pos, int near_
 {
 	FSoundChan *chan;
 	int count;
+	int sound_id = int(sfx - S_sfx.Data());
 	
-	for (chan = Channels, count = 0; chan != NULL && count < near_limit; chan = chan->NextChan)
+	for (chan = ChannelIndex[CHANINDEX_SoundID][SoundBucket(sound_id)], count = 0; chan != NULL && count < near_limit; chan = chan->NextIndexed[CHANINDEX_SoundID])
 	{
 		if (chan->ChanFlags & CHANF_FORGETTABLE) continue;
-		if (!(chan->ChanFlags & CHANF_EVICTED) && &S_sfx[chan->SoundID] == sfx)
+		if (!(chan->ChanFlags & CHANF_EVICTED) && chan->SoundID == sound_id)
 		{
 			FVector3 chanorigin;
 
@@ -852,10 +1176,10 @@ bool SoundEngine::CheckSoundLimit(sfxinfo_t *sfx, const FVector3 &pos, int near_
 
 void SoundEngine::StopSoundID(int sound_id)
 {
-	FSoundChan* chan = Channels;
+	FSoundChan* chan = ChannelIndex[CHANINDEX_OrgID][SoundBucket(sound_id)];
 	while (chan != NULL)
 	{
-		FSoundChan* next = chan->NextChan;
+		FSoundChan* next = chan->NextIndexed[CHANINDEX_OrgID];
 		if (sound_id == chan->OrgID)
 		{
 			StopChannel(chan);
@@ -874,10 +1198,11 @@ void SoundEngine::StopSoundID(int sound_id)
 
 void SoundEngine::StopSound (int channel, int sound_id)
 {
-	FSoundChan *chan = Channels;
+	// SOURCE_None channels never have a source set.
+	FSoundChan *chan = ChannelIndex[CHANINDEX_Source][SourceBucket(nullptr)];
 	while (chan != NULL)
 	{
-		FSoundChan *next = chan->NextChan;
+		FSoundChan *next = chan->NextIndexed[CHANINDEX_Source];
 		if ((chan->SourceType == SOURCE_None && (sound_id == -1 || sound_id == chan->OrgID)) && (channel == CHAN_AUTO || channel == chan->EntChannel))
 		{
 			StopChannel(chan);
@@ -896,10 +1221,10 @@ void SoundEngine::StopSound (int channel, int sound_id)
 
 void SoundEngine::StopSound(int sourcetype, const void* actor, int channel, int sound_id)
 {
-	FSoundChan* chan = Channels;
+	FSoundChan* chan = ChannelIndex[CHANINDEX_Source][SourceBucket(actor)];
 	while (chan != NULL)
 	{
-		FSoundChan* next = chan->NextChan;
+		FSoundChan* next = chan->NextIndexed[CHANINDEX_Source];
 		if (chan->SourceType == sourcetype &&
 			chan->Source == actor &&
 			(sound_id == -1? (chan->EntChannel == channel || channel < 0) : (chan->OrgID == sound_id)))
@@ -943,15 +1268,16 @@ void SoundEngine::RelinkSound (int sourcetype, const void *from, const void *to,
 	if (from == NULL)
 		return;
 
-	FSoundChan *chan = Channels;
+	FSoundChan *chan = ChannelIndex[CHANINDEX_Source][SourceBucket(from)];
 	while (chan != NULL)
 	{
-		FSoundChan *next = chan->NextChan;
+		FSoundChan *next = chan->NextIndexed[CHANINDEX_Source];
 		if (chan->SourceType == sourcetype && chan->Source == from)
 		{
 			if (to != NULL)
 			{
 				chan->Source = to;
+				ReindexChannel(chan);
 			}
 			else if (!(chan->ChanFlags & CHANF_LOOP) && optpos)
 			{
@@ -960,6 +1286,7 @@ void SoundEngine::RelinkSound (int sourcetype, const void *from, const void *to,
 				chan->Point[0] = optpos->X;
 				chan->Point[1] = optpos->Y;
 				chan->Point[2] = optpos->Z;
+				ReindexChannel(chan);
 			}
 			else
 			{
@@ -986,7 +1313,7 @@ void SoundEngine::ChangeSoundVolume(int sourcetype, const void *source, int chan
 	else if (volume > 1.0)
 		volume = 1.0;
 
-	for (FSoundChan *chan = Channels; chan != NULL; chan = chan->NextChan)
+	for (FSoundChan *chan = ChannelIndex[CHANINDEX_Source][SourceBucket(source)]; chan != NULL; chan = chan->NextIndexed[CHANINDEX_Source])
 	{
 		if (chan->SourceType == sourcetype &&
 			chan->Source == source &&
@@ -1017,7 +1344,7 @@ void SoundEngine::SetVolume(FSoundChan* chan, float volume)
 
 void SoundEngine::ChangeSoundPitch(int sourcetype, const void *source, int channel, double pitch, int sound_id)
 {
-	for (FSoundChan *chan = Channels; chan != NULL; chan = chan->NextChan)
+	for (FSoundChan *chan = ChannelIndex[CHANINDEX_Source][SourceBucket(source)]; chan != NULL; chan = chan->NextIndexed[CHANINDEX_Source])
 	{
 		if (chan->SourceType == sourcetype &&
 			chan->Source == source &&
@@ -1048,7 +1375,7 @@ int SoundEngine::GetSoundPlayingInfo (int sourcetype, const void *source, int so
 	int count = 0;
 	if (sound_id > 0)
 	{
-		for (FSoundChan *chan = Channels; chan != NULL; chan = chan->NextChan)
+		for (FSoundChan *chan = ChannelIndex[CHANINDEX_OrgID][SoundBucket(sound_id)]; chan != NULL; chan = chan->NextIndexed[CHANINDEX_OrgID])
 		{
 			if (chan->OrgID == sound_id && (sourcetype == SOURCE_Any ||
 				(chan->SourceType == sourcetype &&
@@ -1077,7 +1404,7 @@ bool SoundEngine::IsChannelUsed(int sourcetype, const void *actor, int channel,
 	{
 		return true;
 	}
-	for (FSoundChan *chan = Channels; chan != NULL; chan = chan->NextChan)
+	for (FSoundChan *chan = ChannelIndex[CHANINDEX_Source][SourceBucket(actor)]; chan != NULL; chan = chan->NextIndexed[CHANINDEX_Source])
 	{
 		if (chan->SourceType == sourcetype && chan->Source == actor)
 		{
@@ -1099,7 +1426,25 @@ bool SoundEngine::IsChannelUsed(int sourcetype, const void *actor, int channel,
 
 bool SoundEngine::IsSourcePlayingSomething (int sourcetype, const void *actor, int channel, int sound_id)
 {
-	for (FSoundChan *chan = Channels; chan != NULL; chan = chan->NextChan)
+	// None and Unattached sounds match regardless of their source, so those can only be narrowed down by sound.
+	FSoundChan *chan;
+	int index;
+	if (sourcetype != SOURCE_None && sourcetype != SOURCE_Unattached)
+	{
+		index = CHANINDEX_Source;
+		chan = ChannelIndex[index][SourceBucket(actor)];
+	}
+	else if (sound_id > 0)
+	{
+		index = CHANINDEX_OrgID;
+		chan = ChannelIndex[index][SoundBucket(sound_id)];
+	}
+	else
+	{
+		index = -1;
+		chan = Channels;
+	}
+	for (; chan != NULL; chan = index < 0 ? chan->NextChan : chan->NextIndexed[index])
 	{
 		if (chan->SourceType == sourcetype && (sourcetype == SOURCE_None || sourcetype == SOURCE_Unattached || chan->Source == actor))
 		{
@@ -1362,6 +1707,7 @@ void SoundEngine::StopChannel(FSoundChan *chan)
 			{
 				chan->Source = NULL;
 				chan->SourceType = SOURCE_Unattached;
+				ReindexChannel(chan);
 			}
 		}
 		if (GSnd) GSnd->StopChannel(chan);
@@ -1754,6 +2100,96 @@ ADD_STAT(sounddebug)
 	return soundEngine->NoiseDebug();
 }
 
+//==========================================================================
+//
+// ChannelStress
+//
+// Adds idle channels spread over a few sounds and sources, then times the
+// per-sound and per-source lookups through the channel index against a
+// walk of the whole channel list. Both must find the same channels, so a
+// mismatch means the index is out of date.
+//
+//==========================================================================
+
+void SoundEngine::ChannelStress(int numchans, int rounds)
+{
+	enum { NumSounds = 64, NumSources = 64 };
+	static uint64_t sources[NumSources];	// only their addresses are used
+
+	TArray<FSoundChan*> added;
+	uint32_t seed = 1;
+	for (int i = 0; i < numchans; i++)
+	{
+		FSoundChan *chan = GetChannel(nullptr);
+		seed = seed * 1103515245 + 12345;
+		chan->SourceType = SOURCE_Actor;
+		chan->Source = &sources[(seed >> 16) % NumSources];
+		chan->SoundID = FSoundID(1 + int((seed >> 8) % NumSounds));
+		chan->OrgID = chan->SoundID;
+		chan->EntChannel = (seed >> 4) & 7;
+		ReindexChannel(chan);
+		added.Push(chan);
+	}
+
+	// Same conditions as CheckSingular and IsChannelUsed.
+	auto bysound = [&](int index, int id)
+	{
+		int count = 0;
+		for (FSoundChan *chan = index < 0 ? Channels : ChannelIndex[index][SoundBucket(id)]; chan != NULL; chan = index < 0 ? chan->NextChan : chan->NextIndexed[index])
+			if (chan->OrgID == id) count++;
+		return count;
+	};
+	auto bysource = [&](int index, const void *source)
+	{
+		int count = 0;
+		for (FSoundChan *chan = index < 0 ? Channels : ChannelIndex[index][SourceBucket(source)]; chan != NULL; chan = index < 0 ? chan->NextChan : chan->NextIndexed[index])
+			if (chan->SourceType == SOURCE_Actor && chan->Source == source) count++;
+		return count;
+	};
+
+	int mismatches = 0;
+	for (int i = 1; i <= NumSounds; i++)
+		if (bysound(-1, i) != bysound(CHANINDEX_OrgID, i)) mismatches++;
+	for (int i = 0; i < NumSources; i++)
+		if (bysource(-1, &sources[i]) != bysource(CHANINDEX_Source, &sources[i])) mismatches++;
+
+	double times[2];
+	int found[2] = {};
+	for (int pass = 0; pass < 2; pass++)
+	{
+		const int soundindex = pass == 0 ? -1 : CHANINDEX_OrgID;
+		const int sourceindex = pass == 0 ? -1 : CHANINDEX_Source;
+		auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < rounds; r++)
+		{
+			for (int i = 1; i <= NumSounds; i++) found[pass] += bysound(soundindex, i);
+			for (int i = 0; i < NumSources; i++) found[pass] += bysource(sourceindex, &sources[i]);
+		}
+		times[pass] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	for (auto chan : added)
+		ReturnChannel(chan);
+
+	int total = 0;
+	for (FSoundChan *chan = Channels; chan != NULL; chan = chan->NextChan) total++;
+	Printf("%d channels, %d lookups: list walk %.3f ms, index %.3f ms (%.1fx)\n", total + numchans, rounds * (NumSounds + NumSources),
+		times[0], times[1], times[1] > 0 ? times[0] / times[1] : 0.);
+	if (mismatches > 0 || found[0] != found[1])
+		Printf(TEXTCOLOR_RED "The index found different channels than the list for %d lookups.\n", mismatches);
+}
+
+CCMD(snd_channelstress)
+{
+	if (soundEngine == nullptr) return;
+	if (argv.argc() < 2)
+	{
+		Printf("Usage: snd_channelstress <channels> [rounds]\n");
+		return;
+	}
+	soundEngine->ChannelStress(std::max(atoi(argv[1]), 1), argv.argc() > 2 ? std::max(atoi(argv[2]), 1) : 1000);
+}
+
 CVAR(Bool, snd_extendedlookup, false, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 
 int S_LookupSound(const char* fn)
@@ -1856,6 +2292,7 @@ void S_SerializeSounds(FSerializer& arc)
 			{
 				chan = (FSoundChan*)soundEngine->GetChannel(nullptr);
 				arc(nullptr, *chan);
+				soundEngine->ReindexChannel(chan);
 				// Sounds always start out evicted when restored from a save.
 				chan->ChanFlags |= CHANF_EVICTED | CHANF_ABSTIME;
 			}
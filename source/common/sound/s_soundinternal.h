@@ -171,6 +171,8 @@ struct FSoundChan : public FISoundChannel
 	float		LimitRange;
 	const void *Source;
 	float Point[3];	// Sound is not attached to any source.
+	FSoundChan	*NextIndexed[3];	// Links in the engine's OrgID, SoundID and Source lookup buckets.
+	FSoundChan **PrevIndexed[3];
 };
 
 
@@ -239,17 +241,36 @@ protected:
 	FSoundChan* Channels = nullptr;
 	FSoundChan* FreeChannels = nullptr;
 
+	// Channels hashed by the sound they were started with, the sound actually playing
+	// and their source, so that the per-sound and per-source checks don't have to
+	// look at every playing channel. Lookups must still compare the real fields.
+	enum
+	{
+		CHANINDEX_OrgID,
+		CHANINDEX_SoundID,
+		CHANINDEX_Source,
+		NUM_CHANINDEX,
+		CHANINDEX_BUCKETS = 256
+	};
+	FSoundChan* ChannelIndex[NUM_CHANINDEX][CHANINDEX_BUCKETS] = {};
+
+	static unsigned SoundBucket(int id) { return unsigned(id) & (CHANINDEX_BUCKETS - 1); }
+	static unsigned SourceBucket(const void* source) { return (uint32_t(uintptr_t(source) >> 3) * 0x9E3779B1u) >> 24; }
+
 	// the complete set of sound effects
 	TArray<sfxinfo_t> S_sfx;
 	FRolloffInfo S_Rolloff;
 	TArray<uint8_t> S_SoundCurve;
 	TMap<int, int> ResIdMap;
 	TArray<FRandomSoundList> S_rnd;
+	TMap<int, unsigned> LoadedLumps;	// lump -> S_sfx entry owning the sound buffer made from it
 
 private:
 	void LinkChannel(FSoundChan* chan, FSoundChan** head);
 	void UnlinkChannel(FSoundChan* chan);
 	void ReturnChannel(FSoundChan* chan);
+	void IndexChannel(FSoundChan* chan);
+	void UnindexChannel(FSoundChan* chan);
 	void RestartChannel(FSoundChan* chan);
 	void RestoreEvictedChannel(FSoundChan* chan);
 
@@ -265,6 +286,11 @@ private:
 	bool CheckSingular(int sound_id);
 	bool CheckSoundLimit(sfxinfo_t* sfx, const FVector3& pos, int near_limit, float limit_range, int sourcetype, const void* actor, int channel);
 	virtual TArray<uint8_t> ReadSound(int lumpnum) = 0;
+	int FindLoadedLump(sfxinfo_t* sfx);
+	void AddLoadedLump(sfxinfo_t* sfx);
+	static bool DecodeSfx(sfxinfo_t* sfx, TArray<uint8_t>& sfxdata, DecodedSound& snd, bool quiet, int streamthreshold);
+	void GatherSound(sfxinfo_t* sfx, TArray<sfxinfo_t*>& list);
+	void LoadSounds(TArray<sfxinfo_t*>& list, void (*progress)() = nullptr);
 protected:
 	virtual FSoundID ResolveSound(const void *ent, int srctype, FSoundID soundid, float &attenuation);
 
@@ -296,6 +322,8 @@ public:
 	void SetVolume(FSoundChan* chan, float vol);
 
 	FSoundChan* GetChannel(void* syschan);
+	// Must be called after changing a channel's OrgID, SoundID or Source.
+	void ReindexChannel(FSoundChan* chan);
 	void RestoreEvictedChannels();
 	void CalcPosVel(FSoundChan* chan, FVector3* pos, FVector3* vel);
 
@@ -325,8 +353,10 @@ public:
 	void Reset();
 	void MarkUsed(int num);
 	void CacheMarkedSounds();
+	void CacheAllSounds(void (*progress)() = nullptr);	// progress is called every few sounds
 	FString NoiseDebug();
 	TArray<FSoundChan*> AllActiveChannels();
+	void ChannelStress(int numchans, int rounds);
 
 	void MarkAllUnused()
 	{
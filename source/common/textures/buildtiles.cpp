@@ -265,7 +265,11 @@ void BuildTiles::InvalidateTile(int num)
 	if ((unsigned) num < MAXTILES)
 	{
 		auto tex = tiles[num];
-		tex->DeleteHardwareTextures();
+		// Tiles that get written to at run time keep their hardware textures and only get their content uploaded again.
+		if (tex->GetUseType() == FTexture::Writable || tex->GetUseType() == FTexture::Restorable)
+			tex->InvalidateHardwareRows(0, tex->GetHeight());
+		else
+			tex->DeleteHardwareTextures();
 		for (auto &rep : tex->Hightiles)
 		{
 			for (auto &reptex : rep.faces)
@@ -276,6 +280,27 @@ void BuildTiles::InvalidateTile(int num)
 	}
 }
 
+//===========================================================================
+//
+// InvalidateTileRows
+//
+// For tiles that are updated every frame but only change in places.
+// Rows go from top to bottom, 'bottom' is exclusive.
+//
+//===========================================================================
+
+void BuildTiles::InvalidateTileRows(int num, int top, int bottom)
+{
+	if ((unsigned) num < MAXTILES)
+	{
+		auto tex = tiles[num];
+		if (tex->GetUseType() == FTexture::Writable || tex->GetUseType() == FTexture::Restorable)
+			tex->InvalidateHardwareRows(top, bottom);
+		else
+			InvalidateTile(num);
+	}
+}
+
 //===========================================================================
 //
 // MakeCanvas
@@ -0,0 +1,280 @@
+/*
+** proctiles.cpp
+** Tiles whose content is generated at run time
+**
+**---------------------------------------------------------------------------
+** Copyright 2020 Raze developers and contributors
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+*/
+
+#include <string.h>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "textures.h"
+#include "proctiles.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PROCTILES_SSE2
+#endif
+
+//==========================================================================
+//
+// One thread does the work for all procedural tiles.
+// It only gets started when the first frame is queued.
+//
+//==========================================================================
+
+struct FProcTileWorker
+{
+	std::thread Thread;
+	std::mutex Lock;
+	std::condition_variable Wake;		// new work or shutdown
+	std::condition_variable FrameDone;
+	TArray<FProceduralTile*> Queue;
+	bool Quit = false;
+
+	~FProcTileWorker()
+	{
+		if (Thread.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> guard(Lock);
+				Quit = true;
+			}
+			Wake.notify_one();
+			Thread.join();
+		}
+	}
+
+	void Add(FProceduralTile *tile)
+	{
+		{
+			std::lock_guard<std::mutex> guard(Lock);
+			tile->Done = false;
+			Queue.Push(tile);
+			if (!Thread.joinable()) Thread = std::thread([this]() { Work(); });
+		}
+		Wake.notify_one();
+	}
+
+	void Wait(FProceduralTile *tile)
+	{
+		std::unique_lock<std::mutex> guard(Lock);
+		FrameDone.wait(guard, [tile]() { return tile->Done; });
+	}
+
+	// A tile that goes away may not be left in the queue.
+	void Remove(FProceduralTile *tile)
+	{
+		std::unique_lock<std::mutex> guard(Lock);
+		auto index = Queue.Find(tile);
+		if (index < Queue.Size()) Queue.Delete(index);
+		else FrameDone.wait(guard, [tile]() { return tile->Done; });
+	}
+
+	void Work()
+	{
+		std::unique_lock<std::mutex> guard(Lock);
+		while (true)
+		{
+			Wake.wait(guard, [this]() { return Quit || Queue.Size() > 0; });
+			if (Quit) return;
+
+			FProceduralTile *tile = Queue[0];
+			Queue.Delete(0);
+			guard.unlock();
+			tile->Generate(tile->Frame.Data());
+			guard.lock();
+			tile->Done = true;
+			FrameDone.notify_all();
+		}
+	}
+};
+
+static FProcTileWorker Worker;
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+FProceduralTile::FProceduralTile(int tilenum, int width, int height)
+{
+	TileNum = tilenum;
+	Width = width;
+	Height = height;
+	Frame.Resize(width * height);
+	memset(Frame.Data(), 0, Frame.Size());
+}
+
+FProceduralTile::~FProceduralTile()
+{
+	if (Pending) Worker.Remove(this);
+}
+
+void FProceduralTile::Run()
+{
+	Finish();
+	Generate(Frame.Data());
+	Show();
+}
+
+void FProceduralTile::Start()
+{
+	if (Pending) return;
+	Pending = true;
+	Worker.Add(this);
+}
+
+void FProceduralTile::Finish()
+{
+	if (!Pending) return;
+	Worker.Wait(this);
+	Pending = false;
+	Show();
+}
+
+//==========================================================================
+//
+// Copies the frame to the tile and works out which rows need to be
+// uploaded again. Compares against what's in the tile right now, so
+// nothing else writing to it can get lost.
+//
+//==========================================================================
+
+void FProceduralTile::Show()
+{
+	if (TileFiles.tiles[TileNum]->GetWidth() != Width || TileFiles.tiles[TileNum]->GetHeight() != Height) return;
+	uint8_t *pixels = TileFiles.tileMakeWritable(TileNum);
+	if (!pixels) return;
+
+	int top = Height, bottom = 0;
+	for (int x = 0; x < Width; x++)
+	{
+		const uint8_t *src = Frame.Data() + x * Height;
+		uint8_t *dest = pixels + x * Height;
+		int first = 0, last = Height;
+		while (first < Height && src[first] == dest[first]) first++;
+		if (first == Height) continue;
+		while (src[last - 1] == dest[last - 1]) last--;
+		memcpy(dest + first, src + first, last - first);
+		top = std::min(top, first);
+		bottom = std::max(bottom, last);
+	}
+	if (top < bottom) TileFiles.InvalidateTileRows(TileNum, top, bottom);
+}
+
+//==========================================================================
+//
+// CellularFireFrame
+//
+// Updates in place, going forward. Every pixel only depends on pixels at
+// least one row further down, which haven't been written yet, so it can
+// be done 16 pixels at a time as long as a row is wider than that.
+//
+//==========================================================================
+
+static inline int CellularFirePixel(const uint8_t *p, int width, int damping)
+{
+	const uint8_t *below = p + width;
+	int sum = below[-1] + below[0] + below[1] + below[width];
+	if (below[width] > 96)
+	{
+		below += width;
+		sum += below[-1] + below[0] + below[1] + below[width];
+		sum >>= 1;
+	}
+	return std::max(sum - damping, 0) >> 2;
+}
+
+void CellularFireFrame(uint8_t *frame, int width, int height, int damping)
+{
+	int count = width * height;
+	int i = 0;
+
+#ifdef PROCTILES_SSE2
+	if (width > 16 && damping >= 0)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i threshold = _mm_set1_epi16(96);
+		const __m128i damp = _mm_set1_epi16((short)damping);
+
+		auto load = [&](const uint8_t *p, __m128i &lo, __m128i &hi)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)p);
+			lo = _mm_unpacklo_epi8(v, zero);
+			hi = _mm_unpackhi_epi8(v, zero);
+		};
+
+		for (; i + 16 <= count; i += 16)
+		{
+			const uint8_t *below = frame + i + width;
+			__m128i lo, hi, l1, h1, l2, h2;
+
+			load(below - 1, l1, h1);
+			load(below + 1, lo, hi);
+			l1 = _mm_add_epi16(l1, lo); h1 = _mm_add_epi16(h1, hi);
+			load(below, lo, hi);
+			l1 = _mm_add_epi16(l1, lo); h1 = _mm_add_epi16(h1, hi);
+			__m128i cl, ch;
+			load(below + width, cl, ch);
+			l1 = _mm_add_epi16(l1, cl); h1 = _mm_add_epi16(h1, ch);
+
+			// the second row only counts where the pixel two rows down is hot
+			below += width;
+			load(below - 1, l2, h2);
+			load(below + 1, lo, hi);
+			l2 = _mm_add_epi16(l2, lo); h2 = _mm_add_epi16(h2, hi);
+			l2 = _mm_add_epi16(l2, cl); h2 = _mm_add_epi16(h2, ch);
+			load(below + width, lo, hi);
+			l2 = _mm_add_epi16(l2, lo); h2 = _mm_add_epi16(h2, hi);
+			l2 = _mm_srli_epi16(_mm_add_epi16(l2, l1), 1);
+			h2 = _mm_srli_epi16(_mm_add_epi16(h2, h1), 1);
+
+			__m128i ml = _mm_cmpgt_epi16(cl, threshold);
+			__m128i mh = _mm_cmpgt_epi16(ch, threshold);
+			l1 = _mm_or_si128(_mm_and_si128(ml, l2), _mm_andnot_si128(ml, l1));
+			h1 = _mm_or_si128(_mm_and_si128(mh, h2), _mm_andnot_si128(mh, h1));
+
+			l1 = _mm_srli_epi16(_mm_subs_epu16(l1, damp), 2);
+			h1 = _mm_srli_epi16(_mm_subs_epu16(h1, damp), 2);
+			_mm_storeu_si128((__m128i*)(frame + i), _mm_packus_epi16(l1, h1));
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		frame[i] = (uint8_t)CellularFirePixel(frame + i, width, damping);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include "tarray.h"
+
+//==========================================================================
+//
+// A tile whose content gets computed at run time, like Blood's fire.
+//
+// Generate() runs on a worker thread so the game doesn't have to wait for
+// it: Start() queues the next frame, Finish() waits for it, copies it into
+// the tile and has only the rows that changed uploaded again.
+// Tiles are stored in columns, so Generate() must write them that way.
+//
+//==========================================================================
+
+class FProceduralTile
+{
+public:
+	FProceduralTile(int tilenum, int width, int height);
+	virtual ~FProceduralTile();
+
+	void Run();		// generates and shows a frame right away
+	void Start();
+	void Finish();
+	bool IsPending() const { return Pending; }
+
+protected:
+	// Only called on the worker thread while the frame is pending.
+	virtual void Generate(uint8_t *pixels) = 0;
+
+	int TileNum;
+	int Width, Height;
+
+private:
+	friend struct FProcTileWorker;
+
+	void Show();
+
+	TArray<uint8_t> Frame;
+	bool Pending = false;
+	bool Done = false;	// guarded by the worker's mutex
+};
+
+// Kernels shared by the procedural tiles.
+
+// One step of the cellular fire used by Blood: every pixel becomes the
+// damped average of the ones below it. 'frame' must have 3 more rows than
+// 'height' which act as the seed for the bottom.
+void CellularFireFrame(uint8_t *frame, int width, int height, int damping);
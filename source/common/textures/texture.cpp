@@ -436,3 +436,30 @@ void FTexture::DeleteHardwareTextures()
 	}
 	HardwareTextures.Clear();
 }
+
+void FTexture::DeleteHardwareTexture(int palid)
+{
+	auto phwtex = HardwareTextures.CheckKey(palid);
+	if (phwtex)
+	{
+		delete *phwtex;
+		HardwareTextures.Remove(palid);
+	}
+}
+
+//===========================================================================
+//
+// Only some rows of the image changed. The hardware textures are kept
+// and the backend uploads just those rows the next time they get used.
+//
+//===========================================================================
+
+void FTexture::InvalidateHardwareRows(int top, int bottom)
+{
+	decltype(HardwareTextures)::Iterator it(HardwareTextures);
+	decltype(HardwareTextures)::Pair *pair;
+	while (it.NextPair(pair))
+	{
+		pair->Value->AddDirtyRows(top, bottom);
+	}
+}
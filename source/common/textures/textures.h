@@ -239,6 +239,8 @@ public:
 	virtual void Reload() {}
 	UseType GetUseType() const { return useType; }
 	void DeleteHardwareTextures();
+	void DeleteHardwareTexture(int palid);
+	void InvalidateHardwareRows(int top, int bottom);
 	void AddReplacement(const HightileReplacement &);
 	void DeleteReplacement(int palnum);
 	void DeleteReplacements()
@@ -579,6 +581,7 @@ struct BuildTiles
 	int tileCreateRotated(int owner);
 	void ClearTextureCache(bool artonly = false);
 	void InvalidateTile(int num);
+	void InvalidateTileRows(int num, int top, int bottom);
 	void MakeCanvas(int tilenum, int width, int height);
 };
 
@@ -0,0 +1,301 @@
+/*
+** timedemo.cpp
+**
+** Plays demos back as fast as possible and reports how long that took.
+**
+**---------------------------------------------------------------------------
+** Copyright 2020 Raze developers and contributors
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+
+#include "compat.h"
+#include "baselayer.h"
+#include "m_argv.h"
+#include "files.h"
+#include "printf.h"
+#include "v_text.h"
+#include "gamecontrol.h"
+#include "timedemo.h"
+#include "softsound.h"
+
+static bool timedemo;
+static bool norender;
+static FString demofile;
+static FString jsonfile;
+static FString wavfile;
+static double windowstart, windowend;
+
+static TArray<float> tictimes;
+static TArray<float> frametimes;
+static double starttime;
+static int tictime;
+static unsigned synctics, outofsynctics;
+static int firstoutofsync;
+static TArray<FString> infokeys, infovalues;
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void TimeDemo_Init()
+{
+	if (!Args->CheckParm("-timedemo")) return;
+
+	timedemo = true;
+	norender = Args->CheckParm("-timedemo_norender");
+	jsonfile = Args->CheckValue("-timedemo_json");
+	wavfile = Args->CheckValue("-timedemo_wav");
+
+	// The demo name is optional, so only take what follows if it isn't another option.
+	auto v = Args->CheckValue("-timedemo");
+	if (v && *v != '-' && *v != '+') demofile = v;
+
+	v = Args->CheckValue("-timedemo_window");
+	if (v)
+	{
+		windowstart = windowend = 0;
+		sscanf(v, "%lf:%lf", &windowstart, &windowend);
+		if (windowend <= windowstart) windowend = 0;
+	}
+
+	// Nothing should wait for the sound hardware. Sound that goes to a file
+	// is mixed as the game runs, but music would depend on the clock.
+	userConfig.nomusic = userConfig.nologo = true;
+	if (wavfile.IsEmpty()) userConfig.nosound = true;
+}
+
+bool TimeDemo_Active()
+{
+	return timedemo;
+}
+
+bool TimeDemo_NoRender()
+{
+	return timedemo && norender;
+}
+
+const char *TimeDemo_File()
+{
+	return demofile.GetChars();
+}
+
+bool TimeDemo_GetWindow(double *start, double *end)
+{
+	if (!timedemo || (windowstart <= 0 && windowend <= 0)) return false;
+	*start = windowstart;
+	*end = windowend;
+	return true;
+}
+
+const char *TimeDemo_WavFile()
+{
+	return timedemo ? wavfile.GetChars() : "";
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void TimeDemo_Start(int ticrate)
+{
+	tictime = ticrate;
+	tictimes.Clear();
+	frametimes.Clear();
+	synctics = outofsynctics = 0;
+	firstoutofsync = -1;
+	infokeys.Clear();
+	infovalues.Clear();
+	starttime = timerGetHiTicks();
+}
+
+void TimeDemo_GameTic(double ms)
+{
+	if (!timedemo) return;
+	tictimes.Push((float)ms);
+
+	// Not part of the tic's time, so mixing doesn't skew the numbers.
+	if (wavfile.IsNotEmpty())
+	{
+		auto soft = dynamic_cast<SoftSoundRenderer*>(GSnd);
+		if (soft) soft->MixTic(tictime);
+	}
+}
+
+void TimeDemo_Frame(double ms)
+{
+	if (timedemo) frametimes.Push((float)ms);
+}
+
+void TimeDemo_SyncTic(int tic, bool insync)
+{
+	if (!timedemo) return;
+	synctics++;
+	if (!insync && outofsynctics++ == 0) firstoutofsync = tic;
+}
+
+void TimeDemo_Info(const char *key, const char *value)
+{
+	if (!timedemo) return;
+	infokeys.Push(key);
+	infovalues.Push(value);
+}
+
+//==========================================================================
+//
+// Peak resident memory of the process, in bytes
+//
+//==========================================================================
+
+static size_t GetPeakMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return counters.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+#ifdef __APPLE__
+		return (size_t)usage.ru_maxrss;
+#else
+		return (size_t)usage.ru_maxrss * 1024;
+#endif
+	}
+#endif
+	return 0;
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+struct TimeStats
+{
+	unsigned count = 0;
+	double total = 0, avg = 0, p50 = 0, p90 = 0, p99 = 0, max = 0;
+};
+
+static TimeStats GetStats(TArray<float> &times)
+{
+	TimeStats stats;
+	if (times.Size() == 0) return stats;
+
+	std::sort(times.begin(), times.end());
+
+	auto percentile = [&](double p) { return times[std::min<unsigned>(times.Size() - 1, unsigned(p * times.Size()))]; };
+
+	stats.count = times.Size();
+	for (auto t : times) stats.total += t;
+	stats.avg = stats.total / stats.count;
+	stats.p50 = percentile(0.5);
+	stats.p90 = percentile(0.9);
+	stats.p99 = percentile(0.99);
+	stats.max = times.Last();
+	return stats;
+}
+
+static void PrintStats(const char *name, const TimeStats &stats)
+{
+	Printf("timedemo: %u %s, %.3f ms average, %.3f / %.3f / %.3f ms 50th / 90th / 99th percentile, %.3f ms max\n",
+		stats.count, name, stats.avg, stats.p50, stats.p90, stats.p99, stats.max);
+}
+
+static void WriteStats(FileWriter *fw, const char *name, const TimeStats &stats, bool last)
+{
+	fw->Printf("\t\"%s\": { \"count\": %u, \"total\": %.3f, \"avg\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f }%s\n",
+		name, stats.count, stats.total, stats.avg, stats.p50, stats.p90, stats.p99, stats.max, last ? "" : ",");
+}
+
+void TimeDemo_Finish()
+{
+	if (!timedemo) return;
+
+	double const seconds = (timerGetHiTicks() - starttime) / 1000.;
+	auto tics = GetStats(tictimes);
+	auto frames = GetStats(frametimes);
+	size_t const peakmem = GetPeakMemory();
+
+	Printf("timedemo: %s finished in %.3f s\n", demofile.IsNotEmpty() ? demofile.GetChars() : "demo", seconds);
+	PrintStats("game tics", tics);
+	if (frames.count > 0) PrintStats("frames", frames);
+	Printf("timedemo: peak memory %zu KB\n", peakmem / 1024);
+	for (unsigned i = 0; i < infokeys.Size(); i++)
+		Printf("timedemo: %s %s\n", infokeys[i].GetChars(), infovalues[i].GetChars());
+	if (synctics > 0)
+	{
+		if (outofsynctics > 0)
+			Printf(TEXTCOLOR_RED "timedemo: %u of %u tics out of sync, first at tic %d\n", outofsynctics, synctics, firstoutofsync);
+		else
+			Printf("timedemo: all %u tics in sync\n", synctics);
+	}
+
+	if (jsonfile.IsNotEmpty())
+	{
+		FileWriter *fw = FileWriter::Open(jsonfile);
+		if (fw)
+		{
+			FString demoname = demofile;
+			demoname.Substitute("\\", "\\\\");
+			demoname.Substitute("\"", "\\\"");
+
+			fw->Printf("{\n");
+			fw->Printf("\t\"game\": \"%s\",\n", currentGame.GetChars());
+			fw->Printf("\t\"demo\": \"%s\",\n", demoname.GetChars());
+			fw->Printf("\t\"render\": %s,\n", norender ? "false" : "true");
+			fw->Printf("\t\"seconds\": %.3f,\n", seconds);
+			fw->Printf("\t\"peak_memory\": %zu,\n", peakmem);
+			fw->Printf("\t\"info\": {");
+			for (unsigned i = 0; i < infokeys.Size(); i++)
+				fw->Printf("%s \"%s\": \"%s\"", i > 0 ? "," : "", infokeys[i].GetChars(), infovalues[i].GetChars());
+			fw->Printf(" },\n");
+			fw->Printf("\t\"sync\": { \"checked\": %u, \"outofsync\": %u, \"first\": %d },\n", synctics, outofsynctics, firstoutofsync);
+			WriteStats(fw, "gametic_ms", tics, false);
+			WriteStats(fw, "frame_ms", frames, true);
+			fw->Printf("}\n");
+			delete fw;
+		}
+		else Printf("timedemo: Could not write %s\n", jsonfile.GetChars());
+	}
+
+	throw ExitEvent(outofsynctics > 0 ? 1 : 0);
+}
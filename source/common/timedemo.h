@@ -0,0 +1,30 @@
+#pragma once
+
+// Timedemo: plays a demo back as fast as possible and measures it.
+//
+// -timedemo [demo] selects the mode, -timedemo_norender skips drawing,
+// -timedemo_json <file> writes the results for tools to read.
+// -timedemo_window <start>[:<end>] times only that part of the demo, in
+// seconds, for games whose demos can seek.
+// -timedemo_wav <file> keeps the sound on and has the software mixer write
+// it to that file, one game tic at a time instead of in real time, so the
+// output only depends on the demo.
+// The games report how long each game tic and each frame took, and call
+// TimeDemo_Finish() when the demo is over. Games whose demos record sync
+// data also report every tic they checked; if any of them was out of sync,
+// the results say so and the program exits with code 1, which makes a
+// timedemo run usable for checking that a change leaves the game logic alone.
+
+void TimeDemo_Init();
+bool TimeDemo_Active();
+bool TimeDemo_NoRender();
+const char *TimeDemo_File();	// demo given on the command line, empty if the game should pick one
+bool TimeDemo_GetWindow(double *start, double *end);	// end is 0 if the window runs to the end of the demo
+const char *TimeDemo_WavFile();	// empty unless the sound gets written to a file
+
+void TimeDemo_Start(int ticrate);	// game tics per second, for mixing the sound
+void TimeDemo_GameTic(double ms);
+void TimeDemo_Frame(double ms);
+void TimeDemo_SyncTic(int tic, bool insync);
+void TimeDemo_Info(const char *key, const char *value);	// a setting that runs are told apart by; call after TimeDemo_Start()
+void TimeDemo_Finish();		// prints and writes the results, then exits
@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "m_argv.h"
 #include "printf.h"
 #include "c_dispatch.h"
+#include "timedemo.h"
 
 BEGIN_DUKE_NS
 
@@ -95,6 +96,13 @@ void G_CheckCommandLine()
 		}
 		Printf("Respawn on.\n");
 	}
+	if (TimeDemo_Active())
+	{
+		// -timedemo is the profiling mode of -d with either no view or one frame per gametic.
+		Demo_SetFirst(*TimeDemo_File() ? TimeDemo_File() : "1");
+		Demo_PlayFirst(TimeDemo_NoRender() ? 1 : 2, 1);
+		g_noLogo = 1;
+	}
 }
 
 END_DUKE_NS
@@ -0,0 +1,212 @@
+//-------------------------------------------------------------------------
+/*
+Copyright (C) 2016 EDuke32 developers and contributors
+
+This file is part of EDuke32.
+
+EDuke32 is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License version 2
+as published by the Free Software Foundation.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+//-------------------------------------------------------------------------
+
+// Sampling profiler for the CON VM.
+//
+// While profiling, A_Execute() and the event dispatcher keep a small stack of the
+// actors and events currently being run, and the VM publishes the position of the
+// instruction it is executing. A background thread periodically looks at both and
+// counts identical samples; the instruction word holds the source line and the
+// script offset tells which file it came from. While the profiler is off, the VM
+// only checks g_vmProfileActive once per call.
+//
+// The report uses the folded stack format ("frame;frame;frame count") that flame
+// graph tools read directly.
+
+#include "ns.h"	// Must come before everything else!
+
+#include "duke3d.h"
+#include "files.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+BEGIN_DUKE_NS
+
+std::atomic<int32_t>  g_vmProfileStack[VM_PROFILE_MAXDEPTH];
+std::atomic<int32_t>  g_vmProfileDepth;
+std::atomic<uint32_t> g_vmProfileSeq;
+std::atomic<intptr_t const *> g_vmProfilePos;
+bool g_vmProfileActive;
+
+// owns the sampling thread so that it never outlives the game, whichever way it quits
+static struct vmprofilethread_t
+{
+    std::thread       thread;
+    std::atomic<bool> running;
+
+    void stop(void)
+    {
+        running = false;
+
+        if (thread.joinable())
+            thread.join();
+    }
+
+    ~vmprofilethread_t() { stop(); }
+} vmProfileThread;
+
+static TMap<FString, uint32_t> vmProfileSamples;
+static TArray<FString>         vmProfileNames;
+static uint32_t                vmProfileSampleCnt;
+
+static FString VM_ProfileContextName(int const context)
+{
+    if (context < MAXEVENTS)
+        return EventNames[context];
+
+    int const tileNum = context - MAXEVENTS;
+
+    // same lookup as printtimes
+    for (int i = 0; i < g_labelCnt; i++)
+    {
+        if (labelcode[i] == tileNum && (labeltype[i] & LABEL_ACTOR))
+            return label + (i << 6);
+    }
+
+    return FStringf("actor %d", tileNum);
+}
+
+// Copies the context stack, retrying while the VM is in the middle of changing it.
+// Returns the depth, or -1 if no consistent copy could be made.
+static int VM_ProfileReadStack(int32_t *contexts)
+{
+    for (int tries = 0; tries < 4; tries++)
+    {
+        uint32_t const seq = g_vmProfileSeq.load(std::memory_order_acquire);
+
+        if (seq & 1)
+            continue;
+
+        int const depth = min<int>(g_vmProfileDepth.load(std::memory_order_relaxed), VM_PROFILE_MAXDEPTH);
+
+        for (int i = 0; i < depth; i++)
+            contexts[i] = g_vmProfileStack[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (g_vmProfileSeq.load(std::memory_order_relaxed) == seq)
+            return depth;
+    }
+
+    return -1;
+}
+
+static void VM_ProfileThread(int const interval)
+{
+    FString stack;
+    int32_t contexts[VM_PROFILE_MAXDEPTH];
+
+    while (vmProfileThread.running.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(interval));
+
+        int const depth = VM_ProfileReadStack(contexts);
+
+        if (depth <= 0)
+            continue;
+
+        // The position is published separately and may already be a few instructions
+        // further along than the stack; that skew is fine for a statistical profile.
+        // The script itself is not modified after compiling, so reading it is safe.
+        auto const pos    = g_vmProfilePos.load(std::memory_order_relaxed);
+        auto const offset = pos - apScript;
+
+        if (!pos || offset < 0 || offset >= g_scriptSize)
+            continue;
+
+        stack = "";
+
+        for (int i = 0; i < depth; i++)
+        {
+            int const context = contexts[i];
+
+            if ((unsigned)context >= vmProfileNames.Size())
+                break;
+
+            stack.AppendFormat("%s;", vmProfileNames[context].GetChars());
+        }
+
+        stack.AppendFormat("%s:%d", C_GetScriptFileName(offset), VM_DECODE_LINE_NUMBER(*pos));
+
+        vmProfileSamples[stack]++;
+        vmProfileSampleCnt++;
+    }
+}
+
+// interval is in microseconds
+bool VM_ProfileStart(int const interval)
+{
+    if (vmProfileThread.running)
+        return false;
+
+    // resolving names here keeps the label table lookups out of the sampling thread
+    vmProfileNames.Resize(MAXEVENTS + MAXTILES);
+
+    for (int i = 0; i < MAXEVENTS + MAXTILES; i++)
+        vmProfileNames[i] = (i < MAXEVENTS || g_tile[i - MAXEVENTS].execPtr) ? VM_ProfileContextName(i) : FString();
+
+    vmProfileSamples.Clear();
+    vmProfileSampleCnt = 0;
+    g_vmProfileDepth = 0;
+    g_vmProfilePos = nullptr;
+    g_vmProfileActive = true;
+    vmProfileThread.running = true;
+    vmProfileThread.thread  = std::thread(VM_ProfileThread, max(interval, 100));
+
+    return true;
+}
+
+// returns the number of samples taken, or -1 if the profiler wasn't running
+int VM_ProfileStop(void)
+{
+    if (!vmProfileThread.running)
+        return -1;
+
+    vmProfileThread.stop();
+    g_vmProfileActive = false;
+
+    return vmProfileSampleCnt;
+}
+
+bool VM_ProfileWrite(char const *fileName)
+{
+    if (vmProfileThread.running)
+        VM_ProfileStop();
+
+    FileWriter *fw = FileWriter::Open(fileName);
+
+    if (!fw)
+        return false;
+
+    TMap<FString, uint32_t>::Iterator it(vmProfileSamples);
+    TMap<FString, uint32_t>::Pair *pair;
+
+    while (it.NextPair(pair))
+        fw->Printf("%s %u\n", pair->Key.GetChars(), pair->Value);
+
+    delete fw;
+    return true;
+}
+
+END_DUKE_NS
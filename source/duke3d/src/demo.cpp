@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "menus.h"
 #include "savegame.h"
 #include "screens.h"
+#include "timedemo.h"
 #include "printf.h"
 #include "menu/menu.h"
 
@@ -51,6 +52,17 @@ static int32_t demo_hasdiffs, demorec_diffs=1, demorec_difftics = 2*REALGAMETICS
 int32_t demoplay_diffs=1;
 
 static int32_t demorec_seeds=1, demo_hasseeds;
+static int32_t demo_haskeyframes;
+
+// Keyframes are full snapshots written after some of the diffs. Their index
+// goes at the very end of the demo, so seeking can jump to the nearest one.
+typedef struct {
+    int32_t tic, offset;
+} demokeyframe_t;
+
+static TArray<demokeyframe_t> g_demo_keyframes;
+static int32_t demorec_keyframetics = 30*REALGAMETICSPERSEC, demorec_lastkeyframe;
+static int32_t g_demo_profileEnd;
 
 static void Demo_RestoreModes(int32_t menu)
 {
@@ -76,6 +88,44 @@ void Demo_PrepareWarp(void)
 }
 
 
+// Reads the tic count written after "EnD!" and the keyframe index that may follow it.
+static void Demo_ReadTrailer(void)
+{
+    long const pos = g_demo_recFilePtr.Tell();
+    long const len = g_demo_recFilePtr.GetLength();
+    long endofs = len - 8;
+    char tmpbuf[4];
+    int32_t num;
+
+    g_demo_keyframes.Clear();
+
+    if (len >= pos + 8)
+    {
+        g_demo_recFilePtr.Seek(len - 8, FileReader::SeekSet);
+
+        if (demo_haskeyframes && g_demo_recFilePtr.Read(&num, sizeof(int32_t)) == sizeof(int32_t) &&
+            g_demo_recFilePtr.Read(tmpbuf, 4) == 4 && !Bmemcmp(tmpbuf, "kIdX", 4) &&
+            num > 0 && (long)(num * sizeof(demokeyframe_t)) <= len - pos - 16)
+        {
+            endofs = len - 16 - num * sizeof(demokeyframe_t);
+            g_demo_recFilePtr.Seek(endofs + 8, FileReader::SeekSet);
+            g_demo_keyframes.Resize(num);
+
+            if (g_demo_recFilePtr.Read(g_demo_keyframes.Data(), num * sizeof(demokeyframe_t)) != (long)(num * sizeof(demokeyframe_t)))
+                g_demo_keyframes.Clear();
+        }
+
+        // demos don't get their header's tic count filled in, so take it from the end
+        g_demo_recFilePtr.Seek(endofs, FileReader::SeekSet);
+
+        if (g_demo_recFilePtr.Read(tmpbuf, 4) == 4 && !Bmemcmp(tmpbuf, "EnD!", 4) &&
+            g_demo_recFilePtr.Read(&num, sizeof(int32_t)) == sizeof(int32_t) && g_demo_totalCnt == 0)
+            g_demo_totalCnt = num;
+    }
+
+    g_demo_recFilePtr.Seek(pos, FileReader::SeekSet);
+}
+
 static int32_t G_OpenDemoRead(int32_t g_whichDemo) // 0 = mine
 {
     int32_t i;
@@ -106,10 +156,13 @@ static int32_t G_OpenDemoRead(int32_t g_whichDemo) // 0 = mine
         return 0;
     }
 
-    demo_hasdiffs = saveh.recdiffsp;
+    demo_hasdiffs = saveh.recdiffsp & SV_DEMO_DIFFS;
+    demo_haskeyframes = saveh.recdiffsp & SV_DEMO_KEYFRAMES;
     g_demo_totalCnt = saveh.reccnt;
     demo_hasseeds = 0;
 
+    Demo_ReadTrailer();
+
     i = g_demo_totalCnt/REALGAMETICSPERSEC;
     OSD_Printf("demo %d duration: %d min %d sec\n", g_whichDemo, i/60, i%60);
 
@@ -186,6 +239,9 @@ error_wopen_demo:
     demorec_seeds = demorec_seeds_cvar;
     demorec_diffs = demorec_diffs_cvar;
     demorec_difftics = demorec_difftics_cvar;
+    demorec_keyframetics = demorec_keyframetics_cvar;
+    demorec_lastkeyframe = 1;
+    g_demo_keyframes.Clear();
 
 	quoteMgr.InitializeQuote(QUOTE_RESERVED4, "DEMO %d RECORDING STARTED", demonum-1);
     P_DoQuote(QUOTE_RESERVED4, g_player[myconnectindex].ps);
@@ -249,6 +305,16 @@ void G_DemoRecord(void)
     {
         sv_writediff(g_demo_filePtr);
         demorec_difftics = demorec_difftics_cvar;
+
+        if (demorec_keyframetics > 0 && g_demo_cnt-demorec_lastkeyframe >= demorec_keyframetics)
+        {
+            demokeyframe_t const keyframe = { g_demo_cnt, (int32_t)g_demo_filePtr->Tell() };
+
+            if (sv_writekeyframe(g_demo_filePtr))
+                g_demo_keyframes.Push(keyframe);
+
+            demorec_lastkeyframe = g_demo_cnt;
+        }
     }
 
     if (demorec_seeds)
@@ -276,6 +342,16 @@ void G_CloseDemoWrite(void)
         // lastly, we need to write the number of written recsyncs to the demo file
 		g_demo_filePtr->Write(&g_demo_cnt, sizeof(g_demo_cnt));
 
+        if (g_demo_keyframes.Size() > 0)
+        {
+            int32_t const numkeyframes = g_demo_keyframes.Size();
+
+            g_demo_filePtr->Write(g_demo_keyframes.Data(), numkeyframes * sizeof(demokeyframe_t));
+            g_demo_filePtr->Write(&numkeyframes, sizeof(numkeyframes));
+            g_demo_filePtr->Write("kIdX", 4);
+            g_demo_keyframes.Clear();
+        }
+
         ud.recstat = m_recstat = 0;
         delete g_demo_filePtr;
 		g_demo_filePtr = nullptr;
@@ -304,6 +380,58 @@ static int32_t Demo_UpdateState(int32_t frominit)
     return k;
 }
 
+// returns the last keyframe at or before tic, or -1
+static int32_t Demo_FindKeyframe(int32_t tic)
+{
+    int32_t i = -1;
+
+    while (i+1 < (int32_t)g_demo_keyframes.Size() && g_demo_keyframes[i+1].tic <= tic)
+        i++;
+
+    return i;
+}
+
+// Jumps to a keyframe. Playback carries on with the sync chunk after it.
+static int32_t Demo_LoadKeyframe(int32_t kf)
+{
+    demokeyframe_t const &keyframe = g_demo_keyframes[kf];
+    char tmpbuf[4];
+
+    g_demo_recFilePtr.Seek(keyframe.offset, FileReader::SeekSet);
+
+    if (g_demo_recFilePtr.Read(tmpbuf, 4) != 4 || Bmemcmp(tmpbuf, "kEyF", 4))
+        return 1;
+
+    int32_t k = sv_readkeyframe(g_demo_recFilePtr);
+
+    if (k)
+    {
+        OSD_Printf("sv_readkeyframe() returned %d.\n", k);
+        return 2;
+    }
+
+    if (Demo_UpdateState(0))
+        return 3;
+
+    g_demo_cnt = keyframe.tic;
+    ud.reccnt = 0;
+
+    totalclock = ototalclock = lockclock = (keyframe.tic-1)*TICSPERFRAME;
+
+    return 0;
+}
+
+static int32_t Demo_SkipKeyframe(void)
+{
+    uint32_t keysiz;
+
+    if (g_demo_recFilePtr.Read(&keysiz, sizeof(uint32_t)) != sizeof(uint32_t))
+        return 1;
+
+    g_demo_recFilePtr.Seek(keysiz, FileReader::SeekCur);
+    return 0;
+}
+
 #define CORRUPT(code) do { corruptcode=code; goto corrupt; } while(0)
 
 static int32_t Demo_ReadSync(int32_t errcode)
@@ -353,6 +481,7 @@ static void Demo_GToc(double t)
 {
     g_prof.numtics++;
     g_prof.totalgamems += timerGetHiTicks()-t;
+    TimeDemo_GameTic(timerGetHiTicks()-t);
 }
 
 static void Demo_RToc(double t1, double t2)
@@ -360,6 +489,7 @@ static void Demo_RToc(double t1, double t2)
     g_prof.numframes++;
     g_prof.totalroomsdrawms += t2-t1;
     g_prof.totalrestdrawms += timerGetHiTicks()-t2;
+    TimeDemo_Frame(timerGetHiTicks()-t1);
 }
 
 static void Demo_DisplayProfStatus(void)
@@ -380,16 +510,49 @@ static void Demo_DisplayProfStatus(void)
     videoNextPage();
 }
 
+// -timedemo_window: start at the last keyframe before the window and stop timing at its end
+static int32_t Demo_SeekProfileWindow(void)
+{
+    double start, end;
+
+    g_demo_profileEnd = 0;
+
+    if (!TimeDemo_GetWindow(&start, &end))
+        return 0;
+
+    if (end > 0)
+        g_demo_profileEnd = (int32_t)(end*REALGAMETICSPERSEC) + 1;
+
+    int32_t const kf = Demo_FindKeyframe((int32_t)(start*REALGAMETICSPERSEC) + 1);
+
+    if (kf < 0)
+    {
+        if (start > 0)
+            OSD_Printf("Demo has no keyframe before %.1f s, timing from the start.\n", start);
+        return 0;
+    }
+
+    if (Demo_LoadKeyframe(kf))
+    {
+        OSD_Printf(OSD_ERROR "Demo keyframe at tic %d is corrupt.\n", g_demo_keyframes[kf].tic);
+        return 0;
+    }
+
+    return 1;
+}
+
 static void Demo_SetupProfile(void)
 {
     g_demo_profile *= -1;  // now >0: profile for real
 
     g_demo_soundToggle = userConfig.nosound;
-	userConfig.nosound = true;  // restored by Demo_FinishProfile()
+	userConfig.nosound = !*TimeDemo_WavFile();  // restored by Demo_FinishProfile()
 
     Bmemset(&g_prof, 0, sizeof(g_prof));
 
     g_prof.starthiticks = timerGetHiTicks();
+    TimeDemo_Start(REALGAMETICSPERSEC);
+    TimeDemo_Info("con_fusion", g_scriptFusion ? "on" : "off");
 }
 
 static void Demo_FinishProfile(void)
@@ -426,6 +589,10 @@ static void Demo_FinishProfile(void)
                 OSD_Printf("== demo %d: non-profiled time overhead: %.02f %%\n",
                            dn, 100.0*totalms/totalprofms - 100.0);
         }
+
+        // -timedemo runs exactly one demo and reports through the common code.
+        if (TimeDemo_Active())
+            TimeDemo_Finish();
     }
 
     g_demo_profile = 0;
@@ -512,6 +679,13 @@ RECHECK:
 #endif
         if (g_demo_profile < 0)
         {
+            if (Demo_SeekProfileWindow())
+            {
+                lastsyncofs = g_demo_recFilePtr.Tell();
+                lastsynctic = g_demo_cnt;
+                lastsyncclock = (int32_t) totalclock;
+            }
+
             Demo_SetupProfile();
         }
     }
@@ -546,13 +720,27 @@ RECHECK:
 
         if (foundemo && (!g_demo_paused || g_demo_goalCnt))
         {
+            int32_t kf;  // no initializer, the demo loop jumps past here
+
+            kf = g_demo_goalCnt>0 ? Demo_FindKeyframe(g_demo_goalCnt-1) : -1;
+
             if (g_demo_goalCnt>0 && g_demo_goalCnt < g_demo_cnt)
             {
                 // initialize rewind
 
                 int32_t menu = g_player[myconnectindex].ps->gm&MODE_MENU;
 
-                if (g_demo_goalCnt > lastsynctic)
+                if (kf >= 0 && (g_demo_goalCnt <= lastsynctic || g_demo_keyframes[kf].tic > lastsynctic))
+                {
+                    // a keyframe is closer than the last diff or the start
+                    if (Demo_LoadKeyframe(kf))
+                        CORRUPT(13);
+
+                    lastsyncofs = g_demo_recFilePtr.Tell();
+                    lastsynctic = g_demo_cnt;
+                    lastsyncclock = (int32_t) totalclock;
+                }
+                else if (g_demo_goalCnt > lastsynctic)
                 {
                     // we can use a previous diff
                     if (Demo_UpdateState(0)==0)
@@ -583,6 +771,21 @@ RECHECK:
 
                 Demo_RestoreModes(menu);
             }
+            else if (kf >= 0 && g_demo_keyframes[kf].tic > g_demo_cnt)
+            {
+                // fast forward: skip straight to the last keyframe before the goal
+
+                int32_t menu = g_player[myconnectindex].ps->gm&MODE_MENU;
+
+                if (Demo_LoadKeyframe(kf))
+                    CORRUPT(13);
+
+                lastsyncofs = g_demo_recFilePtr.Tell();
+                lastsynctic = g_demo_cnt;
+                lastsyncclock = (int32_t) totalclock;
+
+                Demo_RestoreModes(menu);
+            }
 
             if (g_demo_stopProfile)
                 Demo_FinishProfile();
@@ -627,12 +830,18 @@ RECHECK:
                         }
                         else
                         {
-                            lastsyncofs = g_demo_recFilePtr.Tell();
+                            if (g_demo_recFilePtr.Read(tmpbuf, 4) != 4)
+                                CORRUPT(7);
+
+                            // keyframes are only read when seeking
+                            if (demo_haskeyframes && !Bmemcmp(tmpbuf, "kEyF", 4) &&
+                                (Demo_SkipKeyframe() || g_demo_recFilePtr.Read(tmpbuf, 4) != 4))
+                                CORRUPT(7);
+
+                            lastsyncofs = g_demo_recFilePtr.Tell() - 4;
                             lastsynctic = g_demo_cnt;
                             lastsyncclock = (int32_t) totalclock;
 
-                            if (g_demo_recFilePtr.Read(tmpbuf, 4) != 4)
-                                CORRUPT(7);
                             if (Bmemcmp(tmpbuf, "sYnC", 4))
                                 CORRUPT(8);
 
@@ -677,8 +886,13 @@ nextdemo_nomenu:
                 }
 
                 if (demo_hasseeds)
+                {
                     outofsync = ((uint8_t)(randomseed>>24) != g_demo_seedbuf[bigi]);
 
+                    if (Demo_IsProfiling())
+                        TimeDemo_SyncTic(g_demo_cnt, !outofsync);
+                }
+
                 for (TRAVERSE_CONNECT(j))
                 {
                     Bmemcpy(&inputfifo[0][j], &recsync[bigi], sizeof(input_t));
@@ -693,6 +907,9 @@ nextdemo_nomenu:
                     double t = timerGetHiTicks();
                     G_DoMoveThings();
                     Demo_GToc(t);
+
+                    if (g_demo_profileEnd > 0 && g_demo_cnt >= g_demo_profileEnd)
+                        Demo_StopProfiling();
                 }
                 else if (!g_demo_paused)
                 {
@@ -46,6 +46,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "printf.h"
 #include "m_argv.h"
 #include "c_dispatch.h"
+#include "c_console.h"
 #include "filesystem/filesystem.h"
 #include "statistics.h"
 #include "menu/menu.h"
@@ -959,9 +960,9 @@ void G_DumpDebugInfo(void)
             {
                 if (aGameVars[i].flags & (GAMEVAR_PERACTOR))
                 {
-                    if (aGameVars[i].pValues[j] != aGameVars[i].defaultValue)
+                    if (aGameVars[i].pActorValues[j] != aGameVars[i].defaultValue)
                     {
-                        buildprint("gamevar ", aGameVars[i].szLabel, " ", aGameVars[i].pValues[j], " GAMEVAR_PERACTOR");
+                        buildprint("gamevar ", aGameVars[i].szLabel, " ", aGameVars[i].pActorValues[j], " GAMEVAR_PERACTOR");
                         if (aGameVars[i].flags != GAMEVAR_PERACTOR)
                         {
                             buildprint(" // ");
@@ -4105,8 +4106,13 @@ skip:
 
     if (VM_HaveEvent(EVENT_ANIMATESPRITES))
     {
+        // one rebuild of the interpolated view for all of them instead of one per event
+        SuspendInterpolatedView();
+
         for (j = spritesortcnt-1; j>=0; j--)
             G_DoEventAnimSprites(j);
+
+        ResumeInterpolatedView();
     }
 
 #ifdef LUNATIC
@@ -5072,6 +5078,9 @@ static void G_Cleanup(void)
 {
     int32_t i;
 
+    // the sampling thread reads the script, which is about to go away
+    VM_ProfileStop();
+
     for (i=(MAXLEVELS*(MAXVOLUMES+1))-1; i>=0; i--) // +1 volume for "intro", "briefing" music
     {
         G_FreeMapState(i);
@@ -5497,6 +5506,16 @@ int GameInterface::app_main()
 
     G_CheckCommandLine();
 
+#ifndef NETCODE_DISABLE
+    if (userConfig.dedicated)
+    {
+        g_networkMode = NET_DEDICATED_SERVER;
+
+        if (userConfig.netPort)
+            g_netPort = userConfig.netPort;
+    }
+#endif
+
     CONFIG_ReadSetup();
 
     hud_size.Callback();
@@ -5597,6 +5616,13 @@ int GameInterface::app_main()
         ud.m_volume_number = 0;
         ud.warp_on         = 1;
     }
+    else if (g_networkMode == NET_DEDICATED_SERVER && ud.warp_on == 0)
+    {
+        // there's no menu to start a game from, so go straight to the first level
+        m_level_number     = 0;
+        ud.m_volume_number = 0;
+        ud.warp_on         = 1;
+    }
 
     // getnames();
 
@@ -5787,8 +5813,13 @@ MAIN_LOOP_RESTART:
             if (((!GUICapture && (myplayer.gm & MODE_MENU) != MODE_MENU) || ud.recstat == 2 || (g_netServer || ud.multimode > 1))
                 && (myplayer.gm & MODE_GAME))
             {
+                double const ticStartTime = timerGetHiTicks();
+
                 Net_GetPackets();
                 G_DoMoveThings();
+
+                if (g_netServer)
+                    Net_UpdateLoadTest(timerGetHiTicks() - ticStartTime);
             }
         }
 
@@ -5814,7 +5845,13 @@ MAIN_LOOP_RESTART:
 
         if (g_networkMode == NET_DEDICATED_SERVER)
         {
-            std::this_thread::sleep_for(std::chrono::microseconds(1));
+            C_RunStdinCommands();
+
+            // nothing to draw, so sleep until the next tic is due
+            int const ticsLeft = TICSPERFRAME - (int)(totalclock - ototalclock);
+
+            if (ticsLeft > 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(ticsLeft * 1000000 / TICRATE));
         }
         else if (G_FPSLimit() || g_saveRequested)
         {
@@ -40,6 +40,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "stringtable.h"
 #include "mapinfo.h"
 #include "gamestructures.h"
+#include "i_specialpaths.h"
+#include "version.h"
 
 void C_CON_SetButtonAlias(int num, const char* text);
 void C_CON_ClearButtonAlias(int num);
@@ -56,6 +58,7 @@ char g_scriptFileName[BMAX_PATH] = "(none)";  // file we're currently compiling
 int32_t g_totalLines;
 int32_t g_lineNumber;
 uint32_t g_scriptcrc;
+bool g_scriptFusion;
 char g_szBuf[1024];
 
 #if !defined LUNATIC
@@ -810,6 +813,15 @@ static inthashtable_t h_playervar = { NULL, INTHASH_SIZE(ARRAY_SIZE(playervartab
 static inthashtable_t h_actorvar = { NULL, INTHASH_SIZE(ARRAY_SIZE(actorvartable)) };
 #endif
 
+// consecutive instructions fused into a single superinstruction by C_FuseInstructions()
+static const vec3_t fusedtable[] =
+{
+    { CON_SETVAR,    CON_ADDVAR, CON_SETVAR_ADDVAR },
+    { CON_SETVAR,    CON_SETVAR, CON_SETVAR_SETVAR },
+    { CON_SETVARVAR, CON_ADDVAR, CON_SETVARVAR_ADDVAR },
+    { CON_SETVARVAR, CON_SETVAR, CON_SETVARVAR_SETVAR },
+};
+
 static inthashtable_t *const inttables[] = {
     &h_varvar,
 #ifdef CON_DISCRETE_VAR_ACCESS
@@ -852,6 +864,11 @@ static const tokenmap_t keywords_for_private_opcodes[] =
     { "setactor", CON_SETSPRITEEXT },
     { "setactor", CON_SETACTORSTRUCT },
     { "setactor", CON_SETSPRITESTRUCT },
+
+    { "setvar",    CON_SETVAR_ADDVAR },
+    { "setvar",    CON_SETVAR_SETVAR },
+    { "setvarvar", CON_SETVARVAR_ADDVAR },
+    { "setvarvar", CON_SETVARVAR_SETVAR },
 };
 
 char const *VM_GetKeywordForID(int32_t id)
@@ -1929,6 +1946,165 @@ static int C_CountCaseStatements()
     return numCases;
 }
 
+// Compiled script cache.
+//
+// Compiling a large mod takes a noticeable amount of time on every launch, so the result of a
+// successful compile is written to disk and loaded directly on the next run as long as every CON
+// source that went into it is unchanged. Besides the script image, the labels, events and tile data,
+// the compiler has side effects on other subsystems (gamevars, sounds, quotes, level names...).
+// These are recorded in order while compiling and replayed when a cached script gets loaded.
+
+#define CON_CACHE_MAGIC "DNCC"
+#define CON_CACHE_VERSION 2
+
+enum concacheop_t
+{
+    CCOP_NEWVAR,
+    CCOP_NEWARRAY,
+    CCOP_DYNAMICTILE,
+    CCOP_DYNAMICSOUND,
+    CCOP_MUSIC,
+    CCOP_PROJECTILE,
+    CCOP_UNDEFINELEVEL,
+    CCOP_UNDEFINESKILL,
+    CCOP_UNDEFINEVOLUME,
+    CCOP_VOLUMENAME,
+    CCOP_VOLUMEFLAGS,
+    CCOP_GAMEFUNCNAME,
+    CCOP_UNDEFINEGAMEFUNC,
+    CCOP_SKILLNAME,
+    CCOP_GAMETYPE,
+    CCOP_LEVELNAME,
+    CCOP_LEVELTITLE,
+    CCOP_QUOTE,
+    CCOP_EXQUOTE,
+    CCOP_CHEATDESCRIPTION,
+    CCOP_CHEATKEYS,
+    CCOP_CHEAT,
+    CCOP_SOUND,
+    CCOP_SCRIPTVERSION,
+    CCOP_GAMESTARTUP,
+    CCOP_SCRIPTFILE,
+    CCOP_NUMOPS
+};
+
+// number of integer arguments each recorded operation carries
+static int8_t const g_conCacheOpArgs[CCOP_NUMOPS] = {
+    2, 2, 1, 1, 2, 3, 2, 1, 1, 1, 2, 1, 1, 1, 2, 4, 2, 1, 1, 1, 2, 1, 6, 1, 31, 1
+};
+
+struct concacherecord_t
+{
+    int32_t         op;
+    TArray<int32_t> args;
+    FString         text;
+};
+
+struct concachesource_t
+{
+    FString  fileName;
+    int32_t  length;
+    uint32_t crc;
+};
+
+static TArray<concacherecord_t> g_conCacheRecords;
+static TArray<concachesource_t> g_conCacheSources;
+
+static void C_CacheRecord(int32_t op, int32_t const *args, int numArgs, char const *text = nullptr)
+{
+    concacherecord_t rec;
+
+    rec.op = op;
+    rec.args.Resize(numArgs);
+    Bmemcpy(rec.args.Data(), args, numArgs * sizeof(int32_t));
+    rec.text = text;
+
+    g_conCacheRecords.Push(rec);
+}
+
+static inline void C_CacheRecord(int32_t op, std::initializer_list<int32_t> args, char const *text = nullptr)
+{
+    C_CacheRecord(op, args.begin(), (int)args.size(), text);
+}
+
+static void C_CacheAddSource(char const *fileName, char const *data, int32_t length)
+{
+    g_conCacheSources.Push({ fileName, length, Bcrc32(data, length, 0) });
+}
+
+// The file each stretch of compiled code came from, by script offset. Lets runtime
+// reports name the file that goes with a line number.
+struct scriptfilerange_t
+{
+    int32_t offset;
+    FString fileName;
+};
+
+static TArray<scriptfilerange_t> g_scriptFileRanges;
+
+static void C_SetScriptFileName(char const *fileName)
+{
+    Bstrcpy(g_scriptFileName, fileName);
+
+    int32_t const offset = g_scriptPtr - apScript;
+
+    g_scriptFileRanges.Push({ offset, fileName });
+    C_CacheRecord(CCOP_SCRIPTFILE, { offset }, fileName);
+}
+
+char const *C_GetScriptFileName(int32_t const offset)
+{
+    unsigned lo = 0, hi = g_scriptFileRanges.Size();
+
+    // find the last range starting at or before offset
+    while (lo < hi)
+    {
+        unsigned const mid = (lo + hi) >> 1;
+
+        if (g_scriptFileRanges[mid].offset <= offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo ? g_scriptFileRanges[lo - 1].fileName.GetChars() : "(none)";
+}
+
+static FString C_CacheFileName(char const *fileName)
+{
+    FStringf key("%s:%d", fileName, g_gameType);
+    return FStringf("%s/concache_%08x.bin", M_GetAppDataPath(true).GetChars(), Bcrc32(key.GetChars(), key.Len(), 0));
+}
+
+// Identifies the build that wrote a cache file. Bytecode layout is not stable across builds.
+static FString C_CacheBuildStamp(void)
+{
+    return FStringf("%s %s %s %d %d", GetGitHash(), __DATE__, __TIME__, (int)sizeof(intptr_t), (int)con_optimize);
+}
+
+static void C_CacheWriteInt(FileWriter *fw, int32_t value) { fw->Write(&value, sizeof(value)); }
+
+static void C_CacheWriteString(FileWriter *fw, char const *str)
+{
+    int32_t const len = Bstrlen(str);
+    C_CacheWriteInt(fw, len);
+    fw->Write(str, len);
+}
+
+static bool C_CacheReadString(FileReader &fr, FString &str)
+{
+    int32_t const len = fr.ReadInt32();
+
+    if ((unsigned)len > 65536)
+        return false;
+
+    char *buffer = str.LockNewBuffer(len);
+    bool const ok = fr.Read(buffer, len) == len;
+    buffer[len] = 0;
+    str.UnlockBuffer();
+    return ok;
+}
+
 static void C_Include(const char *confile)
 {
 	auto fp = fileSystem.OpenFileReader(confile,0);
@@ -1950,6 +2126,7 @@ static void C_Include(const char *confile)
 
     mptr[len] = 0;
     g_scriptcrc = Bcrc32(mptr, len, g_scriptcrc);
+    C_CacheAddSource(confile, mptr, len);
 
     if (*textptr == '"') // skip past the closing quote if it's there so we don't screw up the next line
         textptr++;
@@ -1958,7 +2135,7 @@ static void C_Include(const char *confile)
     char parentScriptFileName[BMAX_PATH];
 
     Bstrcpy(parentScriptFileName, g_scriptFileName);
-    Bstrcpy(g_scriptFileName, confile);
+    C_SetScriptFileName(confile);
 
     int const temp_ScriptLineNumber = g_lineNumber;
     g_lineNumber = 1;
@@ -1971,7 +2148,7 @@ static void C_Include(const char *confile)
     C_SkipComments();
     C_ParseCommand(true);
 
-    Bstrcpy(g_scriptFileName, parentScriptFileName);
+    C_SetScriptFileName(parentScriptFileName);
 
     g_totalLines += g_lineNumber;
     g_lineNumber = temp_ScriptLineNumber;
@@ -2062,6 +2239,28 @@ void C_DefineVolumeFlags(int32_t vol, int32_t flags)
     gVolumeFlags[vol] = flags;
 }
 
+void C_DefineVolumeName(int32_t vol, const char *name)
+{
+    Bassert((unsigned)vol < MAXVOLUMES);
+
+    gVolumeNames[vol] = name;
+    g_volumeCnt = vol+1;
+}
+
+void C_DefineSkillName(int32_t skill, const char *name)
+{
+    Bassert((unsigned)skill < MAXSKILLS);
+
+    gSkillNames[skill] = name;
+
+    int i;
+    for (i=0; i<MAXSKILLS; i++)
+        if (gSkillNames[i].IsEmpty())
+            break;
+
+    g_skillCnt = i;
+}
+
 void C_UndefineVolume(int32_t vol)
 {
     Bassert((unsigned)vol < MAXVOLUMES);
@@ -2270,13 +2469,44 @@ static void scriptUpdateOpcodeForVariableType(intptr_t *ins)
     }
 }
 
+// Fuses the two most recent instructions of a block if they form a known pair. Both have to be
+// simple three-word instructions; the second one is left untouched so that anything branching
+// to it directly still executes the same code.
+static void C_FuseInstructions(intptr_t const first, intptr_t const second)
+{
+    if (!g_scriptFusion || g_errorCnt || first < 0 || second - first != 3 || (g_scriptPtr - apScript) - second != 3)
+        return;
+
+    auto const ins = apScript + first;
+
+    for (auto &fused : fusedtable)
+    {
+        if (VM_DECODE_INST(ins[0]) != fused.x || VM_DECODE_INST(ins[3]) != fused.y)
+            continue;
+
+        if (g_scriptDebug > 1 && !g_warningCnt)
+        {
+            initprintf("%s:%d: %s + %s -> superinstruction %d\n", g_scriptFileName, VM_DECODE_LINE_NUMBER(ins[0]),
+                       VM_GetKeywordForID(fused.x), VM_GetKeywordForID(fused.y), fused.z);
+        }
+
+        scriptWriteAtOffset(fused.z | (ins[0] & ~VM_INSTMASK), ins);
+        return;
+    }
+}
+
 static bool C_ParseCommand(bool loop /*= false*/)
 {
     int32_t i, j=0, k=0, tw;
     TArray<char> buffer;
 
+    // start offsets of the last two instructions written by this invocation, for C_FuseInstructions()
+    intptr_t prevInsOffset = -1, lastInsOffset = -1;
+
     do
     {
+        C_FuseInstructions(prevInsOffset, lastInsOffset);
+
         if (EDUKE32_PREDICT_FALSE(g_errorCnt > 63 || (*textptr == '\0') || (*(textptr+1) == '\0')))
             return 1;
 
@@ -2290,6 +2520,9 @@ static bool C_ParseCommand(bool loop /*= false*/)
 
         C_SkipComments();
 
+        prevInsOffset = lastInsOffset;
+        lastInsOffset = g_scriptPtr - apScript;
+
         switch ((g_lastKeyword = tw = C_GetNextKeyword()))
         {
         default:
@@ -2464,6 +2697,7 @@ DO_DEFSTATE:
                 }
             }
 
+            C_CacheRecord(CCOP_NEWVAR, { defaultValue, varFlags }, LAST_LABEL);
             Gv_NewVar(LAST_LABEL, defaultValue, varFlags);
             continue;
         }
@@ -2506,6 +2740,7 @@ DO_DEFSTATE:
             arrayFlags = g_scriptPtr[-1];
             g_scriptPtr--;
 
+            C_CacheRecord(CCOP_NEWARRAY, { (int32_t)g_scriptPtr[-1], arrayFlags }, arrayName);
             Gv_NewArray(arrayName, NULL, g_scriptPtr[-1], arrayFlags);
 
             g_scriptPtr -= 2; // no need to save in script...
@@ -2550,7 +2785,10 @@ DO_DEFSTATE:
                     labeltype[g_labelCnt] = LABEL_DEFINE;
                     labelcode[g_labelCnt++] = g_scriptPtr[-1];
                     if (g_scriptPtr[-1] >= 0 && g_scriptPtr[-1] < MAXTILES && g_dynamicTileMapping)
+                    {
+                        C_CacheRecord(CCOP_DYNAMICTILE, { (int32_t)g_scriptPtr[-1] }, label+((g_labelCnt-1)<<6));
                         G_ProcessDynamicTileMapping(label+((g_labelCnt-1)<<6),g_scriptPtr[-1]);
+                    }
                 }
                 g_scriptPtr -= 2;
                 continue;
@@ -2671,6 +2909,7 @@ DO_DEFSTATE:
                     }
                     tempbuf[j+1] = '\0';
 
+                    C_CacheRecord(CCOP_MUSIC, { k, i }, tempbuf);
                     C_DefineMusic(k, i, tempbuf);
 
                     textptr += j;
@@ -3976,6 +4215,7 @@ setvarvar:
                     continue;
                 }
 
+                C_CacheRecord(CCOP_PROJECTILE, { j, y, z });
                 C_DefineProjectile(j, y, z);
                 continue;
             }
@@ -4896,6 +5136,7 @@ repeatcase:
                 continue;
             }
 
+            C_CacheRecord(CCOP_UNDEFINELEVEL, { j, k });
             C_UndefineLevel(j, k);
             continue;
 
@@ -4915,6 +5156,7 @@ repeatcase:
                 continue;
             }
 
+            C_CacheRecord(CCOP_UNDEFINESKILL, { j });
             C_UndefineSkill(j);
             continue;
 
@@ -4934,6 +5176,7 @@ repeatcase:
                 continue;
             }
 
+            C_CacheRecord(CCOP_UNDEFINEVOLUME, { j });
             C_UndefineVolume(j);
             continue;
 
@@ -4956,10 +5199,12 @@ repeatcase:
             }
 
 			i = strcspn(textptr, "\r\n");
-			gVolumeNames[j] = FStringTable::MakeMacro(textptr, i);
+			{
+				FString const volumeName = FStringTable::MakeMacro(textptr, i);
+				C_CacheRecord(CCOP_VOLUMENAME, { j }, volumeName);
+				C_DefineVolumeName(j, volumeName);
+			}
 			textptr += i;
-  
-            g_volumeCnt = j+1;
             continue;
 
         case CON_DEFINEVOLUMEFLAGS:
@@ -4979,6 +5224,7 @@ repeatcase:
                 continue;
             }
 
+            C_CacheRecord(CCOP_VOLUMEFLAGS, { j, k });
             C_DefineVolumeFlags(j, k);
             continue;
 
@@ -5016,6 +5262,7 @@ repeatcase:
 					}
 				}
 				buffer.Push(0);
+				C_CacheRecord(CCOP_GAMEFUNCNAME, { j }, buffer.Data());
 				C_CON_SetButtonAlias(j, buffer.Data());
 			}
             continue;
@@ -5035,6 +5282,7 @@ repeatcase:
                 continue;
             }
 
+			C_CacheRecord(CCOP_UNDEFINEGAMEFUNC, { j });
 			C_CON_ClearButtonAlias(j);
             continue;
 
@@ -5057,15 +5305,12 @@ repeatcase:
             }
 
 			i = strcspn(textptr, "\r\n");
-			gSkillNames[j] = FStringTable::MakeMacro(textptr, i);
+			{
+				FString const skillName = FStringTable::MakeMacro(textptr, i);
+				C_CacheRecord(CCOP_SKILLNAME, { j }, skillName);
+				C_DefineSkillName(j, skillName);
+			}
 			textptr+=i;
-
-            for (i=0; i<MAXSKILLS; i++)
-                if (gSkillNames[i].IsEmpty())
-                    break;
-
-            g_skillCnt = i;
-
             continue;
 
         case CON_SETGAMENAME:
@@ -5166,6 +5411,7 @@ repeatcase:
                 }
             }
             g_gametypeNames[j][i] = '\0';
+            C_CacheRecord(CCOP_GAMETYPE, { j, g_gametypeFlags[j] }, g_gametypeNames[j]);
             continue;
 
         case CON_DEFINELEVELNAME:
@@ -5256,6 +5502,9 @@ repeatcase:
 
             mapList[j * MAXLEVELS + k].SetName(tempbuf);
 
+            C_CacheRecord(CCOP_LEVELNAME, { j, k, mapList[j * MAXLEVELS + k].parTime, mapList[j * MAXLEVELS + k].designerTime },
+                          mapList[j * MAXLEVELS + k].fileName);
+            C_CacheRecord(CCOP_LEVELTITLE, { j, k }, tempbuf);
             continue;
 
         case CON_DEFINEQUOTE:
@@ -5295,9 +5544,15 @@ repeatcase:
             }
 			buffer.Push(0);
 			if (tw == CON_DEFINEQUOTE)
+			{
+				C_CacheRecord(CCOP_QUOTE, { k }, buffer.Data());
 				quoteMgr.InitializeQuote(k, buffer.Data(), true);
+			}
 			else
+			{
+				C_CacheRecord(CCOP_EXQUOTE, { g_numXStrings }, buffer.Data());
 				quoteMgr.InitializeExQuote(g_numXStrings, buffer.Data(), true);
+			}
 
 
             if (tw != CON_DEFINEQUOTE)
@@ -5341,6 +5596,7 @@ repeatcase:
             }
 
             *(CheatDescriptions[k]+i) = '\0';
+            C_CacheRecord(CCOP_CHEATDESCRIPTION, { k }, CheatDescriptions[k]);
             continue;
 
         case CON_CHEATKEYS:
@@ -5350,6 +5606,7 @@ repeatcase:
             C_GetNextValue(LABEL_DEFINE);
             CheatKeys[1] = g_scriptPtr[-1];
             g_scriptPtr -= 2;
+            C_CacheRecord(CCOP_CHEATKEYS, { CheatKeys[0], CheatKeys[1] });
             continue;
 
         case CON_UNDEFINECHEAT:
@@ -5368,6 +5625,7 @@ repeatcase:
             }
 
             CheatStrings[j][0] = '\0';
+            C_CacheRecord(CCOP_CHEAT, { j }, CheatStrings[j]);
             continue;
 
         case CON_DEFINECHEAT:
@@ -5399,6 +5657,7 @@ repeatcase:
                 }
             }
             CheatStrings[k][i] = '\0';
+            C_CacheRecord(CCOP_CHEAT, { k }, CheatStrings[k]);
             continue;
 
         case CON_DEFINESOUND:
@@ -5460,10 +5719,14 @@ repeatcase:
             vo = g_scriptPtr[-1];
             g_scriptPtr -= 5;
 
+            C_CacheRecord(CCOP_SOUND, { k, ps, pe, pr, m, vo }, buffer.Data());
             int res = S_DefineSound(k, buffer.Data(), ps, pe, pr, m, vo, 1.f);
 
             if (g_dynamicSoundMapping && j >= 0 && (labeltype[j] & LABEL_DEFINE))
+            {
+                C_CacheRecord(CCOP_DYNAMICSOUND, { k }, label + (j << 6));
                 G_ProcessDynamicSoundMapping(label + (j << 6), k);
+            }
             continue;
         }
 
@@ -5672,6 +5935,8 @@ repeatcase:
                 TRIPBOMBLASERMODE
                 */
 
+                C_CacheRecord(CCOP_SCRIPTVERSION, { g_scriptVersion });
+                C_CacheRecord(CCOP_GAMESTARTUP, params, ARRAY_SIZE(params));
                 G_DoGameStartup(params);
             }
             continue;
@@ -5918,6 +6183,362 @@ void scriptInitTables()
 #endif
 }
 
+static void C_WriteCachedScript(char const *fileName)
+{
+    if (!con_cache || g_errorCnt)
+        return;
+
+    FString const cacheName = C_CacheFileName(fileName);
+    FileWriter *fw = FileWriter::Open(cacheName);
+
+    if (!fw)
+        return;
+
+    fw->Write(CON_CACHE_MAGIC, 4);
+    C_CacheWriteInt(fw, CON_CACHE_VERSION);
+    C_CacheWriteString(fw, C_CacheBuildStamp());
+    C_CacheWriteInt(fw, g_gameType);
+
+    C_CacheWriteInt(fw, g_conCacheSources.Size());
+    for (auto &src : g_conCacheSources)
+    {
+        C_CacheWriteString(fw, src.fileName);
+        C_CacheWriteInt(fw, src.length);
+        C_CacheWriteInt(fw, src.crc);
+    }
+
+    C_CacheWriteInt(fw, g_scriptcrc);
+    C_CacheWriteInt(fw, g_scriptVersion);
+    C_CacheWriteInt(fw, g_numXStrings);
+    C_CacheWriteInt(fw, g_totalLines);
+    C_CacheWriteInt(fw, g_warningCnt);
+
+    // pointers inside the script are stored as offsets, the same way C_SetScriptSize() relocates them
+    C_CacheWriteInt(fw, g_scriptSize);
+    C_CacheWriteInt(fw, g_scriptPtr - apScript);
+
+    TArray<intptr_t> script(g_scriptSize, true);
+    Bmemcpy(script.Data(), apScript, g_scriptSize * sizeof(intptr_t));
+
+    for (int i = 0; i < g_scriptSize - 1; ++i)
+        if (BITPTR_IS_POINTER(i))
+            script[i] -= (intptr_t)apScript;
+
+    fw->Write(script.Data(), g_scriptSize * sizeof(intptr_t));
+    fw->Write(bitptr, ((g_scriptSize + 7) >> 3) + 1);
+    fw->Write(apScriptEvents, sizeof(apScriptEvents));
+
+    int32_t numTiles = 0;
+    for (auto &tile : g_tile)
+        if (tile.execPtr || tile.loadPtr || tile.flags || tile.cacherange)
+            numTiles++;
+
+    C_CacheWriteInt(fw, numTiles);
+    for (int i = 0; i < MAXTILES; i++)
+    {
+        auto const &tile = g_tile[i];
+
+        if (!(tile.execPtr || tile.loadPtr || tile.flags || tile.cacherange))
+            continue;
+
+        C_CacheWriteInt(fw, i);
+        C_CacheWriteInt(fw, tile.execPtr ? tile.execPtr - apScript : 0);
+        C_CacheWriteInt(fw, tile.loadPtr ? tile.loadPtr - apScript : 0);
+        C_CacheWriteInt(fw, tile.flags);
+        C_CacheWriteInt(fw, tile.cacherange);
+    }
+
+    C_CacheWriteInt(fw, g_labelCnt);
+    fw->Write(label, g_labelCnt << 6);
+    fw->Write(labelcode, g_labelCnt * sizeof(int32_t));
+    fw->Write(labeltype, g_labelCnt * sizeof(int32_t));
+
+    C_CacheWriteInt(fw, g_conCacheRecords.Size());
+    for (auto &rec : g_conCacheRecords)
+    {
+        C_CacheWriteInt(fw, rec.op);
+        fw->Write(rec.args.Data(), rec.args.Size() * sizeof(int32_t));
+        C_CacheWriteString(fw, rec.text);
+    }
+
+    fw->Write(CON_CACHE_MAGIC, 4);
+    delete fw;
+}
+
+static void C_CacheReplay(concacherecord_t const &rec)
+{
+    auto const args = rec.args.Data();
+    auto const text = rec.text.GetChars();
+
+    switch (rec.op)
+    {
+        case CCOP_NEWVAR:           Gv_NewVar(text, args[0], args[1]); break;
+        case CCOP_NEWARRAY:         Gv_NewArray(text, NULL, args[0], args[1]); break;
+        case CCOP_DYNAMICTILE:      G_ProcessDynamicTileMapping(text, args[0]); break;
+        case CCOP_DYNAMICSOUND:     G_ProcessDynamicSoundMapping(text, args[0]); break;
+        case CCOP_MUSIC:            C_DefineMusic(args[0], args[1], text); break;
+        case CCOP_PROJECTILE:       C_DefineProjectile(args[0], args[1], args[2]); break;
+        case CCOP_UNDEFINELEVEL:    C_UndefineLevel(args[0], args[1]); break;
+        case CCOP_UNDEFINESKILL:    C_UndefineSkill(args[0]); break;
+        case CCOP_UNDEFINEVOLUME:   C_UndefineVolume(args[0]); break;
+        case CCOP_VOLUMENAME:       C_DefineVolumeName(args[0], text); break;
+        case CCOP_VOLUMEFLAGS:      C_DefineVolumeFlags(args[0], args[1]); break;
+        case CCOP_GAMEFUNCNAME:     C_CON_SetButtonAlias(args[0], text); break;
+        case CCOP_UNDEFINEGAMEFUNC: C_CON_ClearButtonAlias(args[0]); break;
+        case CCOP_SKILLNAME:        C_DefineSkillName(args[0], text); break;
+
+        case CCOP_GAMETYPE:
+            g_gametypeFlags[args[0]] = args[1];
+            Bstrncpyz(g_gametypeNames[args[0]], text, sizeof(g_gametypeNames[args[0]]));
+            g_gametypeCnt = args[0] + 1;
+            break;
+
+        case CCOP_LEVELNAME:
+        {
+            auto &gmap = mapList[args[0] * MAXLEVELS + args[1]];
+            gmap.SetFileName(text);
+            gmap.parTime      = args[2];
+            gmap.designerTime = args[3];
+            break;
+        }
+
+        case CCOP_LEVELTITLE:       mapList[args[0] * MAXLEVELS + args[1]].SetName(text); break;
+        case CCOP_QUOTE:            quoteMgr.InitializeQuote(args[0], text, true); break;
+        case CCOP_EXQUOTE:          quoteMgr.InitializeExQuote(args[0], text, true); break;
+        case CCOP_CHEATDESCRIPTION: Bstrncpyz(CheatDescriptions[args[0]], text, MAXCHEATDESC); break;
+
+        case CCOP_CHEATKEYS:
+            CheatKeys[0] = args[0];
+            CheatKeys[1] = args[1];
+            break;
+
+        case CCOP_CHEAT:            Bstrncpyz(CheatStrings[args[0]], text, sizeof(CheatStrings[args[0]])); break;
+        case CCOP_SOUND:            S_DefineSound(args[0], text, args[1], args[2], args[3], args[4], args[5], 1.f); break;
+        case CCOP_SCRIPTVERSION:    g_scriptVersion = args[0]; break;
+        case CCOP_GAMESTARTUP:      G_DoGameStartup(args); break;
+        case CCOP_SCRIPTFILE:       g_scriptFileRanges.Push({ args[0], text }); break;
+    }
+}
+
+// Returns true if a valid cache for fileName was found and loaded. Nothing gets
+// modified unless the entire file has been read and validated.
+static bool C_LoadCachedScript(char const *fileName)
+{
+    if (!con_cache)
+        return false;
+
+    FileReader fr;
+
+    if (!fr.OpenFile(C_CacheFileName(fileName)))
+        return false;
+
+    char magic[4];
+    FString str;
+
+    if (fr.Read(magic, 4) != 4 || Bmemcmp(magic, CON_CACHE_MAGIC, 4) || fr.ReadInt32() != CON_CACHE_VERSION)
+        return false;
+
+    if (!C_CacheReadString(fr, str) || str.Compare(C_CacheBuildStamp()) || fr.ReadInt32() != (int32_t)g_gameType)
+        return false;
+
+    // Every file that went into the compile must still be exactly the same. The first
+    // entries are the main CON file and the ones added on the command line, in order.
+    TArray<FString> roots;
+    roots.Push(fileName);
+
+    if (userConfig.AddCons)
+        for (FString &m : *userConfig.AddCons.get())
+            roots.Push(m);
+
+    int32_t const numSources = fr.ReadInt32();
+
+    if ((unsigned)numSources > 65536 || (unsigned)numSources < roots.Size())
+        return false;
+
+    TArray<concachesource_t> sources;
+    unsigned nextRoot = 0;
+
+    for (int i = 0; i < numSources; i++)
+    {
+        concachesource_t src;
+
+        if (!C_CacheReadString(fr, src.fileName))
+            return false;
+
+        src.length = fr.ReadInt32();
+        src.crc    = fr.ReadUInt32();
+
+        if (nextRoot < roots.Size() && !src.fileName.CompareNoCase(roots[nextRoot]))
+            nextRoot++;
+
+        auto kFile = fileSystem.OpenFileReader(src.fileName, 0);
+
+        if (!kFile.isOpen() || kFile.GetLength() != src.length)
+            return false;
+
+        auto const data = kFile.Read();
+
+        if (Bcrc32(data.Data(), src.length, 0) != src.crc)
+            return false;
+
+        sources.Push(src);
+    }
+
+    if (nextRoot != roots.Size() || sources[0].fileName.CompareNoCase(fileName))
+        return false;
+
+    uint32_t const scriptCrc     = fr.ReadUInt32();
+    int32_t const  scriptVersion = fr.ReadInt32();
+    int32_t const  numXStrings   = fr.ReadInt32();
+    int32_t const  totalLines    = fr.ReadInt32();
+    int32_t const  numWarnings   = fr.ReadInt32();
+    int32_t const  scriptSize    = fr.ReadInt32();
+    int32_t const  scriptLength  = fr.ReadInt32();
+
+    if (scriptSize <= 0 || scriptSize > (1 << 26) || (unsigned)scriptLength > (unsigned)scriptSize)
+        return false;
+
+    size_t const bitmapSize = ((scriptSize + 7) >> 3) + 1;
+
+    TArray<intptr_t> script(scriptSize, true);
+    TArray<uint8_t>  bitmap(bitmapSize, true);
+    intptr_t         events[MAXEVENTS];
+
+    if (fr.Read(script.Data(), scriptSize * sizeof(intptr_t)) != (FileReader::Size)(scriptSize * sizeof(intptr_t))
+        || fr.Read(bitmap.Data(), bitmapSize) != (FileReader::Size)bitmapSize
+        || fr.Read(events, sizeof(events)) != sizeof(events))
+        return false;
+
+    int32_t const numTiles = fr.ReadInt32();
+
+    if ((unsigned)numTiles > MAXTILES)
+        return false;
+
+    TArray<int32_t> tiles(numTiles * 5, true);
+
+    if (fr.Read(tiles.Data(), numTiles * 5 * sizeof(int32_t)) != (FileReader::Size)(numTiles * 5 * sizeof(int32_t)))
+        return false;
+
+    for (int i = 0; i < numTiles; i++)
+    {
+        if ((unsigned)tiles[i * 5] >= MAXTILES || (unsigned)tiles[i * 5 + 1] >= (unsigned)scriptSize || (unsigned)tiles[i * 5 + 2] >= (unsigned)scriptSize)
+            return false;
+    }
+
+    int32_t const labelCnt = fr.ReadInt32();
+
+    if ((unsigned)labelCnt > MAXSPRITES * sizeof(spritetype) / 64)
+        return false;
+
+    TArray<char>    labels(labelCnt << 6, true);
+    TArray<int32_t> labelCodes(labelCnt, true);
+    TArray<int32_t> labelTypes(labelCnt, true);
+
+    if (fr.Read(labels.Data(), labelCnt << 6) != labelCnt << 6
+        || fr.Read(labelCodes.Data(), labelCnt * sizeof(int32_t)) != (FileReader::Size)(labelCnt * sizeof(int32_t))
+        || fr.Read(labelTypes.Data(), labelCnt * sizeof(int32_t)) != (FileReader::Size)(labelCnt * sizeof(int32_t)))
+        return false;
+
+    int32_t const numRecords = fr.ReadInt32();
+
+    if ((unsigned)numRecords > (1 << 24))
+        return false;
+
+    TArray<concacherecord_t> records;
+    records.Resize(numRecords);
+
+    for (auto &rec : records)
+    {
+        rec.op = fr.ReadInt32();
+
+        if ((unsigned)rec.op >= CCOP_NUMOPS)
+            return false;
+
+        int const numArgs = g_conCacheOpArgs[rec.op];
+        rec.args.Resize(numArgs);
+
+        if (fr.Read(rec.args.Data(), numArgs * sizeof(int32_t)) != (FileReader::Size)(numArgs * sizeof(int32_t)) || !C_CacheReadString(fr, rec.text))
+            return false;
+    }
+
+    if (fr.Read(magic, 4) != 4 || Bmemcmp(magic, CON_CACHE_MAGIC, 4))
+        return false;
+
+    // everything checks out, commit the cached compile
+    Xfree(apScript);
+    Xfree(bitptr);
+
+    g_scriptSize = scriptSize;
+    apScript     = (intptr_t *)Xmalloc(scriptSize * sizeof(intptr_t));
+    bitptr       = (uint8_t *)Xmalloc(bitmapSize);
+    g_scriptPtr  = apScript + scriptLength;
+
+    Bmemcpy(bitptr, bitmap.Data(), bitmapSize);
+    Bmemcpy(apScript, script.Data(), scriptSize * sizeof(intptr_t));
+
+    for (int i = 0; i < g_scriptSize - 1; ++i)
+        if (BITPTR_IS_POINTER(i))
+            apScript[i] += (intptr_t)apScript;
+
+    Bmemcpy(apScriptEvents, events, sizeof(events));
+
+    for (int i = 0; i < numTiles; i++)
+    {
+        auto &tile = g_tile[tiles[i * 5]];
+
+        tile.execPtr    = tiles[i * 5 + 1] ? apScript + tiles[i * 5 + 1] : NULL;
+        tile.loadPtr    = tiles[i * 5 + 2] ? apScript + tiles[i * 5 + 2] : NULL;
+        tile.flags      = tiles[i * 5 + 3];
+        tile.cacherange = tiles[i * 5 + 4];
+    }
+
+    g_labelCnt = labelCnt;
+    Bmemcpy(label, labels.Data(), labelCnt << 6);
+    Bmemcpy(labelcode, labelCodes.Data(), labelCnt * sizeof(int32_t));
+    Bmemcpy(labeltype, labelTypes.Data(), labelCnt * sizeof(int32_t));
+
+    for (auto &rec : records)
+        C_CacheReplay(rec);
+
+    g_scriptcrc     = scriptCrc;
+    g_scriptVersion = scriptVersion;
+    g_numXStrings   = numXStrings;
+    g_totalLines    = totalLines;
+    g_errorCnt      = 0;
+    g_warningCnt    = 0;
+
+    Bstrcpy(g_scriptFileName, fileName);
+
+    for (auto &src : sources)
+        initprintf("Using cached: %s (%d bytes)\n", src.fileName.GetChars(), src.length);
+
+    if (numWarnings)
+        initprintf("Note: %d warning(s) were found when this script was compiled. Set con_cache to 0 to see them.\n", numWarnings);
+
+    return true;
+}
+
+// Cleanup shared by fresh and cached compiles.
+static void C_FinishCompile(void)
+{
+    for (auto i : tables_free)
+        hash_free(i);
+
+    for (auto i : inttables)
+        inthash_free(i);
+
+    freehashnames();
+    freesoundhashnames();
+
+    if (g_scriptDebug)
+        C_PrintStats();
+
+    C_InitQuotes();
+
+    g_conCacheRecords.Reset();
+    g_conCacheSources.Reset();
+}
+
 void C_Compile(const char *fileName)
 {
     Bmemset(apScriptEvents, 0, sizeof(apScriptEvents));
@@ -5935,6 +6556,22 @@ void C_Compile(const char *fileName)
     Gv_Init();
     C_InitProjectiles();
 
+    g_conCacheRecords.Clear();
+    g_conCacheSources.Clear();
+    g_scriptFileRanges.Clear();
+
+    uint32_t const startcompiletime = timerGetTicks();
+
+    // the cache stamp includes con_optimize, so a cached script was fused the same way
+    g_scriptFusion = con_optimize;
+
+    if (C_LoadCachedScript(fileName))
+    {
+        initprintf("Loaded compiled script from cache in %ums%s\n", timerGetTicks() - startcompiletime, C_ScriptVersionString(g_scriptVersion));
+        C_FinishCompile();
+        return;
+    }
+
     auto kFile = fileSystem.OpenFileReader(fileName,0);
 
 	if (!kFile.isOpen())
@@ -5946,8 +6583,6 @@ void C_Compile(const char *fileName)
 
     initprintf("Compiling: %s (%d bytes)\n", fileName, kFileLen);
 
-    uint32_t const startcompiletime = timerGetTicks();
-
     char * mptr = (char *)Xmalloc(kFileLen+1);
     mptr[kFileLen] = 0;
 
@@ -5957,6 +6592,7 @@ void C_Compile(const char *fileName)
 
     g_scriptcrc = Bcrc32(NULL, 0, 0L);
     g_scriptcrc = Bcrc32(textptr, kFileLen, g_scriptcrc);
+    C_CacheAddSource(fileName, textptr, kFileLen);
 
     Xfree(apScript);
 
@@ -5970,7 +6606,7 @@ void C_Compile(const char *fileName)
     g_totalLines = 0;
     g_warningCnt = 0;
 
-    Bstrcpy(g_scriptFileName, fileName);
+    C_SetScriptFileName(fileName);
 
     C_AddDefaultDefinitions();
     C_ParseCommand(true);
@@ -6021,19 +6657,8 @@ void C_Compile(const char *fileName)
     initprintf("Compiled %d bytes in %ums%s\n", (int)((intptr_t)g_scriptPtr - (intptr_t)apScript),
                timerGetTicks() - startcompiletime, C_ScriptVersionString(g_scriptVersion));
 
-    for (auto i : tables_free)
-        hash_free(i);
-
-    for (auto i : inttables)
-        inthash_free(i);
-
-    freehashnames();
-    freesoundhashnames();
-
-    if (g_scriptDebug)
-        C_PrintStats();
-
-    C_InitQuotes();
+    C_WriteCachedScript(fileName);
+    C_FinishCompile();
 }
 
 void C_ReportError(int error)
@@ -126,6 +126,8 @@ extern intptr_t apScriptEvents[MAXEVENTS];
 
 extern char g_scriptFileName[BMAX_PATH];
 
+char const *C_GetScriptFileName(int32_t offset);
+
 extern const uint32_t CheatFunctionFlags[];
 extern const uint8_t  CheatFunctionIDs[];
 
@@ -136,6 +138,7 @@ extern int32_t g_scriptVersion;
 extern int32_t g_totalLines;
 extern int32_t g_warningCnt;
 extern uint32_t g_scriptcrc;
+extern bool g_scriptFusion;  // con_optimize as of the last C_Compile()
 extern int32_t otherp;
 extern uint8_t *bitptr;
 
@@ -176,6 +179,8 @@ void G_DoGameStartup(const int32_t *params);
 void C_DefineMusic(int volumeNum, int levelNum, const char *fileName);
 
 void C_DefineVolumeFlags(int32_t vol, int32_t flags);
+void C_DefineVolumeName(int32_t vol, const char *name);
+void C_DefineSkillName(int32_t skill, const char *name);
 void C_UndefineVolume(int32_t vol);
 void C_UndefineSkill(int32_t skill);
 void C_UndefineLevel(int32_t vol, int32_t lev);
@@ -967,6 +972,11 @@ enum IterationTypes_t
     TRANSFORM(CON_WHILEVARN) DELIMITER \
     TRANSFORM(CON_XORVAR) DELIMITER \
     \
+    TRANSFORM(CON_SETVAR_ADDVAR) DELIMITER \
+    TRANSFORM(CON_SETVAR_SETVAR) DELIMITER \
+    TRANSFORM(CON_SETVARVAR_ADDVAR) DELIMITER \
+    TRANSFORM(CON_SETVARVAR_SETVAR) DELIMITER \
+    \
     TRANSFORM(CON_ELSE) DELIMITER \
     TRANSFORM(CON_ENDA) DELIMITER \
     TRANSFORM(CON_ENDEVENT) DELIMITER \
@@ -201,11 +201,24 @@ static FORCE_INLINE int32_t VM_EventInlineInternal__(int const eventNum, int con
     if ((unsigned)playerNum >= (unsigned)g_mostConcurrentPlayers)
         vm.pPlayer = g_player[0].ps;
 
+    // display events run while the interpolated view is up; they have to change the real map
+    SuspendInterpolatedView();
+
+    bool const profiling = g_vmProfileActive;
+
+    if (profiling)
+        VM_ProfilePush(eventNum);
+
     VM_Execute(true);
 
+    if (profiling)
+        VM_ProfilePop();
+
     if (vm.flags & VM_KILL)
         VM_DeleteSprite(vm.spriteNum, vm.playerNum);
 
+    ResumeInterpolatedView();
+
     g_eventTotalMs[eventNum] += timerGetHiTicks()-t;
     g_eventCalls[eventNum]++;
 
@@ -1344,20 +1357,36 @@ static void ResizeArray(int const arrayNum, int const newSize)
 }
 
 #if !defined LUNATIC
-#if defined __GNUC__ || defined __clang__
-// # define CON_USE_COMPUTED_GOTO does not work anymore with some of the changes.
+// Threaded dispatch: every handler jumps straight to the next one through a table of label
+// addresses instead of going back through the loop and the switch. Define CON_NO_COMPUTED_GOTO
+// to build the plain switch-based interpreter, which is also used for compilers without
+// support for label addresses.
+//
+// Both builds share every handler, so keep them compiling: the switch build rejects a
+// handler that jumps over an initialization or breaks out of the switch, and the threaded
+// one fails on any opcode that has no vInstruction() label. A handler must end in
+// dispatch(), dispatch_unconditionally() or return, never by running into the next label.
+//
+// While the sampling profiler runs, the threaded build dispatches through a second table
+// that sends every opcode to VINST_PROFILE first, which publishes the position and then
+// goes on to the real handler. The table is picked when VM_Execute() is entered, so the
+// handlers pay nothing for the profiler while it is off.
+#if (defined __GNUC__ || defined __clang__) && !defined CON_NO_COMPUTED_GOTO
+# define CON_USE_COMPUTED_GOTO
 #endif
 
 #ifdef CON_USE_COMPUTED_GOTO
 # define vInstruction(KEYWORDID) VINST_ ## KEYWORDID
 # define vmErrorCase VINST_CON_OPCODE_END
-# define eval(INSTRUCTION) { goto *jumpTable[min<uint16_t>(INSTRUCTION, CON_OPCODE_END)]; }
+# define eval(INSTRUCTION) { goto *dispatchTable[min<uint16_t>(INSTRUCTION, CON_OPCODE_END)]; }
 # define dispatch_unconditionally(...) { g_tw = tw = *insptr; eval((VM_DECODE_INST(tw))) }
 # define dispatch(...) { if (vm_execution_depth && (vm.flags & (VM_RETURN|VM_KILL|VM_NOEXECUTE)) == 0) dispatch_unconditionally(__VA_ARGS__); return; }
 # define abort_after_error(...) return
 # define vInstructionPointer(KEYWORDID) &&VINST_ ## KEYWORDID
 # define COMMA ,
 # define JUMP_TABLE_ARRAY_LITERAL { TRANSFORM_SCRIPT_KEYWORDS_LIST(vInstructionPointer, COMMA) }
+# define vProfilePointer(KEYWORDID) &&VINST_PROFILE
+# define PROFILE_TABLE_ARRAY_LITERAL { TRANSFORM_SCRIPT_KEYWORDS_LIST(vProfilePointer, COMMA) }
 #else
 # define vInstruction(KEYWORDID) case KEYWORDID
 # define vmErrorCase default
@@ -1393,12 +1422,22 @@ GAMEEXEC_STATIC void VM_Execute(int const loop /*= false*/)
     int vm_execution_depth = loop;
 #ifdef CON_USE_COMPUTED_GOTO
     static void *const jumpTable[] = JUMP_TABLE_ARRAY_LITERAL;
+    // eval() clamps anything out of range to CON_OPCODE_END, the error handler
+    static_assert(ARRAY_SIZE(jumpTable) == CON_OPCODE_END + 1, "jump table is out of sync with the opcode list");
+    static void *const profileTable[] = PROFILE_TABLE_ARRAY_LITERAL;
+    void *const *const dispatchTable = g_vmProfileActive ? profileTable : jumpTable;
 #else
+    bool const profiling = g_vmProfileActive;
+
     do
     {
 #endif
         int32_t tw = *insptr;
         g_tw = tw;
+#ifndef CON_USE_COMPUTED_GOTO
+        if (profiling)
+            g_vmProfilePos.store(insptr, std::memory_order_relaxed);
+#endif
 
         eval(VM_DECODE_INST(tw))
         {
@@ -1554,123 +1593,123 @@ GAMEEXEC_STATIC void VM_Execute(int const loop /*= false*/)
 
             vInstruction(CON_IFVARE_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw == *insptr);
                 dispatch();
             vInstruction(CON_IFVARN_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw != *insptr);
                 dispatch();
             vInstruction(CON_IFVARAND_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw & *insptr);
                 dispatch();
             vInstruction(CON_IFVAROR_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw | *insptr);
                 dispatch();
             vInstruction(CON_IFVARXOR_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw ^ *insptr);
                 dispatch();
             vInstruction(CON_IFVAREITHER_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw || *insptr);
                 dispatch();
             vInstruction(CON_IFVARBOTH_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw && *insptr);
                 dispatch();
             vInstruction(CON_IFVARG_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw > *insptr);
                 dispatch();
             vInstruction(CON_IFVARGE_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw >= *insptr);
                 dispatch();
             vInstruction(CON_IFVARL_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw < *insptr);
                 dispatch();
             vInstruction(CON_IFVARLE_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL(tw <= *insptr);
                 dispatch();
             vInstruction(CON_IFVARA_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL((uint32_t)tw > (uint32_t)*insptr);
                 dispatch();
             vInstruction(CON_IFVARAE_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL((uint32_t)tw >= (uint32_t)*insptr);
                 dispatch();
             vInstruction(CON_IFVARB_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL((uint32_t)tw < (uint32_t)*insptr);
                 dispatch();
             vInstruction(CON_IFVARBE_ACTOR):
                 insptr++;
-                tw = aGameVars[*insptr++].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                tw = aGameVars[*insptr++].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 VM_CONDITIONAL((uint32_t)tw <= (uint32_t)*insptr);
                 dispatch();
 
             vInstruction(CON_SETVAR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] = insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] = insptr[1];
                 insptr += 2;
                 dispatch();
             vInstruction(CON_ADDVAR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] += insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] += insptr[1];
                 insptr += 2;
                 dispatch();
             vInstruction(CON_SUBVAR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] -= insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] -= insptr[1];
                 insptr += 2;
                 dispatch();
             vInstruction(CON_MULVAR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] *= insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] *= insptr[1];
                 insptr += 2;
                 dispatch();
             vInstruction(CON_ANDVAR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] &= insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] &= insptr[1];
                 insptr += 2;
                 dispatch();
             vInstruction(CON_XORVAR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] ^= insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] ^= insptr[1];
                 insptr += 2;
                 dispatch();
             vInstruction(CON_ORVAR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] |= insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] |= insptr[1];
                 insptr += 2;
                 dispatch();
             vInstruction(CON_SHIFTVARL_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] <<= insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] <<= insptr[1];
                 insptr += 2;
                 dispatch();
             vInstruction(CON_SHIFTVARR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] >>= insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] >>= insptr[1];
                 insptr += 2;
                 dispatch();
 
@@ -1823,7 +1862,7 @@ GAMEEXEC_STATIC void VM_Execute(int const loop /*= false*/)
             vInstruction(CON_WHILEVARN_ACTOR):
             {
                 auto const savedinsptr = &insptr[2];
-                auto &v = aGameVars[savedinsptr[-1]].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                auto &v = aGameVars[savedinsptr[-1]].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 do
                 {
                     insptr = savedinsptr;
@@ -1837,7 +1876,7 @@ GAMEEXEC_STATIC void VM_Execute(int const loop /*= false*/)
             vInstruction(CON_WHILEVARL_ACTOR):
             {
                 auto const savedinsptr = &insptr[2];
-                auto &v = aGameVars[savedinsptr[-1]].pValues[vm.spriteNum & (MAXSPRITES-1)];
+                auto &v = aGameVars[savedinsptr[-1]].pActorValues[vm.spriteNum & (MAXSPRITES-1)];
                 do
                 {
                     insptr = savedinsptr;
@@ -1883,7 +1922,7 @@ GAMEEXEC_STATIC void VM_Execute(int const loop /*= false*/)
                 dispatch();
             vInstruction(CON_MODVAR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] %= insptr[1];
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] %= insptr[1];
                 insptr += 2;
                 dispatch();
             vInstruction(CON_MODVAR_PLAYER):
@@ -2056,7 +2095,7 @@ GAMEEXEC_STATIC void VM_Execute(int const loop /*= false*/)
             vInstruction(CON_DIVVAR_ACTOR):
             {
                 insptr++;
-                auto &v = aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES - 1)];
+                auto &v = aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES - 1)];
 
                 v = tabledivide32(v, insptr[1]);
                 insptr += 2;
@@ -2271,6 +2310,30 @@ GAMEEXEC_STATIC void VM_Execute(int const loop /*= false*/)
                 insptr += 3;
                 dispatch();
 
+            vInstruction(CON_SETVAR_ADDVAR):
+                Gv_SetVar(insptr[1], insptr[2]);
+                Gv_AddVar(insptr[4], insptr[5]);
+                insptr += 6;
+                dispatch();
+
+            vInstruction(CON_SETVAR_SETVAR):
+                Gv_SetVar(insptr[1], insptr[2]);
+                Gv_SetVar(insptr[4], insptr[5]);
+                insptr += 6;
+                dispatch();
+
+            vInstruction(CON_SETVARVAR_ADDVAR):
+                Gv_SetVar(insptr[1], Gv_GetVar(insptr[2]));
+                Gv_AddVar(insptr[4], insptr[5]);
+                insptr += 6;
+                dispatch();
+
+            vInstruction(CON_SETVARVAR_SETVAR):
+                Gv_SetVar(insptr[1], Gv_GetVar(insptr[2]));
+                Gv_SetVar(insptr[4], insptr[5]);
+                insptr += 6;
+                dispatch();
+
             vInstruction(CON_SUBVAR):
                 Gv_SubVar(insptr[1], insptr[2]);
                 insptr += 3;
@@ -2350,7 +2413,7 @@ GAMEEXEC_STATIC void VM_Execute(int const loop /*= false*/)
 
             vInstruction(CON_RANDVAR_ACTOR):
                 insptr++;
-                aGameVars[*insptr].pValues[vm.spriteNum & (MAXSPRITES-1)] = mulscale16(krand(), insptr[1] + 1);
+                aGameVars[*insptr].pActorValues[vm.spriteNum & (MAXSPRITES-1)] = mulscale16(krand(), insptr[1] + 1);
                 insptr += 2;
                 dispatch();
 #endif
@@ -2400,6 +2463,9 @@ GAMEEXEC_STATIC void VM_Execute(int const loop /*= false*/)
 
                     VM_SetStruct(wallLabel.flags, (intptr_t *)((char *)&wall[wallNum] + wallLabel.offset), newValue);
 
+                    if (labelNum == WALL_X || labelNum == WALL_Y || labelNum == WALL_POINT2 || labelNum == WALL_NEXTSECTOR)
+                        pvsWallMoved(wallNum);
+
                     dispatch();
                 }
 
@@ -6276,6 +6342,12 @@ badindex:
                 Gv_SetVar(tw, (intptr_t)(insptr - apScript));
                 dispatch();
 
+#ifdef CON_USE_COMPUTED_GOTO
+            VINST_PROFILE:
+                g_vmProfilePos.store(insptr, std::memory_order_relaxed);
+                goto *jumpTable[min<uint16_t>(VM_DECODE_INST(tw), CON_OPCODE_END)];
+#endif
+
             vmErrorCase: // you're not supposed to be here
                 VM_ScriptInfo(insptr, 64);
                 debug_break();
@@ -6400,7 +6472,15 @@ void A_Execute(int const spriteNum, int const playerNum, int const playerDist)
         killit = (El_CallActor(&g_ElState, picnum, spriteNum, playerNum, playerDist)==1);
 #else
     insptr = 4 + (g_tile[vm.pSprite->picnum].execPtr);
+    bool const profiling = g_vmProfileActive;
+
+    if (profiling)
+        VM_ProfilePush(MAXEVENTS + picnum);
+
     VM_Execute(true);
+
+    if (profiling)
+        VM_ProfilePop();
     insptr = NULL;
 #endif
 
@@ -6476,6 +6556,8 @@ void G_SaveMapState(void)
     int const    levelNum = ud.volume_number * MAXLEVELS + ud.level_number;
     map_t *const pMapInfo = &g_mapInfo[levelNum];
 
+    Bassert(!DrawingInterpolatedView());
+
     if (pMapInfo->savedstate == NULL)
     {
         pMapInfo->savedstate = (mapstate_t *) Xaligned_alloc(ACTOR_VAR_ALIGNMENT, sizeof(mapstate_t));
@@ -6569,8 +6651,8 @@ void G_SaveMapState(void)
         else if (aGameVars[i].flags & GAMEVAR_PERACTOR)
         {
             if (!save->vars[i])
-                save->vars[i] = (intptr_t *)Xaligned_alloc(ACTOR_VAR_ALIGNMENT, MAXSPRITES * sizeof(intptr_t));
-            Bmemcpy(&save->vars[i][0], aGameVars[i].pValues, sizeof(intptr_t) * MAXSPRITES);
+                save->vars[i] = (intptr_t *)Xaligned_alloc(ACTOR_VAR_ALIGNMENT, MAXSPRITES * sizeof(int32_t));
+            Bmemcpy(save->vars[i], aGameVars[i].pActorValues, sizeof(int32_t) * MAXSPRITES);
         }
         else
             save->vars[i] = (intptr_t *)aGameVars[i].global;
@@ -6609,6 +6691,9 @@ void G_RestoreMapState(void)
     int const   levelNum    = ud.volume_number * MAXLEVELS + ud.level_number;
     mapstate_t *pSavedState = g_mapInfo[levelNum].savedstate;
 
+    // this is allowed from EVENT_ANIMATESPRITES, which must have switched back to the live map
+    Bassert(!DrawingInterpolatedView());
+
     if (pSavedState != NULL)
     {
         int playerHealth[MAXPLAYERS];
@@ -6627,6 +6712,7 @@ void G_RestoreMapState(void)
 #endif
         numsectors = pSavedState->numsectors;
         Bmemcpy(&sector[0],&pSavedState->sector[0],sizeof(sectortype)*MAXSECTORS);
+        pvsUpdateGeometry();
         Bmemcpy(&sprite[0],&pSavedState->sprite[0],sizeof(spritetype)*MAXSPRITES);
         Bmemcpy(&spriteext[0],&pSavedState->spriteext[0],sizeof(spriteext_t)*MAXSPRITES);
 
@@ -6702,7 +6788,7 @@ void G_RestoreMapState(void)
             {
                 if (!pSavedState->vars[i])
                     continue;
-                Bmemcpy(aGameVars[i].pValues, pSavedState->vars[i], sizeof(intptr_t) * MAXSPRITES);
+                Bmemcpy(aGameVars[i].pActorValues, pSavedState->vars[i], sizeof(int32_t) * MAXSPRITES);
             }
             else
                 aGameVars[i].global = (intptr_t)pSavedState->vars[i];
@@ -29,6 +29,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "sector.h"  // mapstate_t
 #include "zstring.h"
 
+#include <atomic>
+
 BEGIN_DUKE_NS
 
 int32_t VM_ExecuteEvent(int const nEventID, int const spriteNum, int const playerNum, int const nDist, int32_t const nReturn);
@@ -81,6 +83,53 @@ void A_LoadActor(int const spriteNum);
 extern uint32_t g_eventCalls[MAXEVENTS], g_actorCalls[MAXTILES];
 extern double g_eventTotalMs[MAXEVENTS], g_actorTotalMs[MAXTILES], g_actorMinMs[MAXTILES], g_actorMaxMs[MAXTILES];
 
+// sampling profiler, see conprofile.cpp
+// the stack holds event numbers and MAXEVENTS+picnum for actors
+#define VM_PROFILE_MAXDEPTH 16
+
+extern std::atomic<int32_t>  g_vmProfileStack[VM_PROFILE_MAXDEPTH];
+extern std::atomic<int32_t>  g_vmProfileDepth;
+extern std::atomic<uint32_t> g_vmProfileSeq;
+extern std::atomic<intptr_t const *> g_vmProfilePos;
+extern bool g_vmProfileActive; // only touched by the game thread
+
+// The VM is the only writer. The sequence count is odd while the stack is being changed,
+// which lets the sampling thread detect a torn copy and retry.
+static FORCE_INLINE void VM_ProfileBeginWrite(void)
+{
+    g_vmProfileSeq.store(g_vmProfileSeq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static FORCE_INLINE void VM_ProfileEndWrite(void)
+{
+    g_vmProfileSeq.store(g_vmProfileSeq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+static FORCE_INLINE void VM_ProfilePush(int const context)
+{
+    int const depth = g_vmProfileDepth.load(std::memory_order_relaxed);
+
+    VM_ProfileBeginWrite();
+
+    if (depth < VM_PROFILE_MAXDEPTH)
+        g_vmProfileStack[depth].store(context, std::memory_order_relaxed);
+
+    g_vmProfileDepth.store(depth + 1, std::memory_order_relaxed);
+    VM_ProfileEndWrite();
+}
+
+static FORCE_INLINE void VM_ProfilePop(void)
+{
+    VM_ProfileBeginWrite();
+    g_vmProfileDepth.store(g_vmProfileDepth.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    VM_ProfileEndWrite();
+}
+
+bool VM_ProfileStart(int interval);
+int  VM_ProfileStop(void);
+bool VM_ProfileWrite(char const *fileName);
+
 void A_Execute(int spriteNum, int playerNum, int playerDist);
 void A_Fall(int spriteNum);
 int A_GetFurthestAngle(int const spriteNum, int const angDiv);
@@ -141,8 +141,8 @@ int Gv_ReadSave(FileReader &kFile)
         }
         else if (aGameVars[i].flags & GAMEVAR_PERACTOR)
         {
-            aGameVars[i].pValues = (intptr_t*)Xaligned_alloc(ACTOR_VAR_ALIGNMENT, MAXSPRITES * sizeof(intptr_t));
-            if (kFile.Read(aGameVars[i].pValues,sizeof(intptr_t) * MAXSPRITES) != sizeof(intptr_t) * MAXSPRITES) goto corrupt;
+            aGameVars[i].pActorValues = (int32_t*)Xaligned_alloc(ACTOR_VAR_ALIGNMENT, MAXSPRITES * sizeof(int32_t));
+            if (kFile.Read(aGameVars[i].pActorValues,sizeof(int32_t) * MAXSPRITES) != sizeof(int32_t) * MAXSPRITES) goto corrupt;
         }
     }
 
@@ -205,8 +205,8 @@ int Gv_ReadSave(FileReader &kFile)
             }
             else if (aGameVars[j].flags & GAMEVAR_PERACTOR)
             {
-                sv.vars[j] = (intptr_t *) Xaligned_alloc(ACTOR_VAR_ALIGNMENT, MAXSPRITES * sizeof(intptr_t));
-                if (kFile.Read(sv.vars[j], sizeof(intptr_t) * MAXSPRITES) != sizeof(intptr_t) * MAXSPRITES) return -10;
+                sv.vars[j] = (intptr_t *) Xaligned_alloc(ACTOR_VAR_ALIGNMENT, MAXSPRITES * sizeof(int32_t));
+                if (kFile.Read(sv.vars[j], sizeof(int32_t) * MAXSPRITES) != sizeof(int32_t) * MAXSPRITES) return -10;
             }
         }
 
@@ -247,7 +247,7 @@ void Gv_WriteSave(FileWriter &fil)
         if (aGameVars[i].flags & GAMEVAR_PERPLAYER)
 			fil.Write(aGameVars[i].pValues, sizeof(intptr_t) * MAXPLAYERS);
         else if (aGameVars[i].flags & GAMEVAR_PERACTOR)
-			fil.Write(aGameVars[i].pValues, sizeof(intptr_t) * MAXSPRITES);
+			fil.Write(aGameVars[i].pActorValues, sizeof(int32_t) * MAXSPRITES);
     }
 
 	fil.Write(&g_gameArrayCount,sizeof(g_gameArrayCount));
@@ -285,7 +285,7 @@ void Gv_WriteSave(FileWriter &fil)
             if (aGameVars[j].flags & GAMEVAR_PERPLAYER)
 				fil.Write(sv.vars[j], sizeof(intptr_t) * MAXPLAYERS);
             else if (aGameVars[j].flags & GAMEVAR_PERACTOR)
-				fil.Write(sv.vars[j], sizeof(intptr_t) * MAXSPRITES);
+				fil.Write(sv.vars[j], sizeof(int32_t) * MAXSPRITES);
         }
 
 		fil.Write(sv.arraysiz, sizeof(sv.arraysiz));
@@ -525,13 +525,13 @@ void Gv_NewVar(const char *pszLabel, intptr_t lValue, uint32_t dwFlags)
     }
     else if (aGameVars[gV].flags & GAMEVAR_PERACTOR)
     {
-        if (!aGameVars[gV].pValues)
+        if (!aGameVars[gV].pActorValues)
         {
-            aGameVars[gV].pValues = (intptr_t *) Xaligned_alloc(ACTOR_VAR_ALIGNMENT, MAXSPRITES * sizeof(intptr_t));
-            Bmemset(aGameVars[gV].pValues, 0, MAXSPRITES * sizeof(intptr_t));
+            aGameVars[gV].pActorValues = (int32_t *) Xaligned_alloc(ACTOR_VAR_ALIGNMENT, MAXSPRITES * sizeof(int32_t));
+            Bmemset(aGameVars[gV].pActorValues, 0, MAXSPRITES * sizeof(int32_t));
         }
         for (bssize_t j=MAXSPRITES-1; j>=0; --j)
-            aGameVars[gV].pValues[j]=lValue;
+            aGameVars[gV].pActorValues[j]=lValue;
     }
     else aGameVars[gV].global = lValue;
 }
@@ -761,7 +761,7 @@ static FORCE_INLINE int __fastcall getvar__(int const gameVar, int const spriteN
 
         if (!varFlags) returnValue = var.global;
         else if (varFlags == GAMEVAR_PERACTOR)
-            returnValue = var.pValues[spriteNum & (MAXSPRITES-1)];
+            returnValue = var.pActorValues[spriteNum & (MAXSPRITES-1)];
         else if (varFlags == GAMEVAR_PERPLAYER)
             returnValue = var.pValues[playerNum & (MAXPLAYERS-1)];
         else switch (varFlags & GAMEVAR_PTR_MASK)
@@ -794,7 +794,7 @@ static FORCE_INLINE void __fastcall setvar__(int const gameVar, int const newVal
 
     if (!varFlags) var.global=newValue;
     else if (varFlags == GAMEVAR_PERACTOR)
-        var.pValues[spriteNum & (MAXSPRITES-1)] = newValue;
+        var.pActorValues[spriteNum & (MAXSPRITES-1)] = newValue;
     else if (varFlags == GAMEVAR_PERPLAYER)
         var.pValues[playerNum & (MAXPLAYERS-1)] = newValue;
     else switch (varFlags & GAMEVAR_PTR_MASK)
@@ -100,7 +100,8 @@ typedef struct
 {
     union {
         intptr_t  global;
-        intptr_t *pValues;  // array of values when 'per-player', or 'per-actor'
+        intptr_t *pValues;       // array of values when 'per-player'
+        int32_t  *pActorValues;  // array of values when 'per-actor', 32 bits is all the VM ever stores
     };
     intptr_t  defaultValue;
     uintptr_t flags;
@@ -149,7 +150,7 @@ static FORCE_INLINE void A_ResetVars(int const spriteNum)
     for (auto &gv : aGameVars)
     {
         if ((gv.flags & (GAMEVAR_PERACTOR|GAMEVAR_NODEFAULT)) == GAMEVAR_PERACTOR)
-            gv.pValues[spriteNum] = gv.defaultValue;
+            gv.pActorValues[spriteNum] = gv.defaultValue;
     }
 }
 void VM_InitHashTables(void);
@@ -222,7 +223,7 @@ static FORCE_INLINE void __fastcall VM_SetStruct(uint32_t const flags, intptr_t
                 var.pValues[vm.playerNum & (MAXPLAYERS-1)] operator operand;                           \
                 break;                                                                                 \
             case GAMEVAR_PERACTOR:                                                                     \
-                var.pValues[vm.spriteNum & (MAXSPRITES-1)] operator operand;                           \
+                var.pActorValues[vm.spriteNum & (MAXSPRITES-1)] operator operand;                      \
                 break;                                                                                 \
             case GAMEVAR_INT32PTR: *(int32_t *)var.pValues operator(int32_t) operand; break;           \
             case GAMEVAR_INT16PTR: *(int16_t *)var.pValues operator(int16_t) operand; break;           \
@@ -244,7 +245,6 @@ static FORCE_INLINE void __fastcall Gv_DivVar(int const id, int32_t const d)
 
     auto &var = aGameVars[id];
     auto *dptr = &sdiv;
-    auto iptr = &var.global;
 
     if ((unsigned)d < DIVTABLESIZE)
         dptr = &divtable32[d];
@@ -253,9 +253,19 @@ static FORCE_INLINE void __fastcall Gv_DivVar(int const id, int32_t const d)
     
     switch (var.flags & (GAMEVAR_USER_MASK | GAMEVAR_PTR_MASK))
     {
-        case GAMEVAR_PERACTOR: iptr = &var.pValues[vm.spriteNum & (MAXSPRITES-1)]; goto jmp;
-        case GAMEVAR_PERPLAYER: iptr = &var.pValues[vm.playerNum & (MAXPLAYERS-1)]; fallthrough__;
-        default: jmp: *iptr = libdivide_s32_do(*iptr, dptr); break;
+        case GAMEVAR_PERACTOR:
+        {
+            auto &value = var.pActorValues[vm.spriteNum & (MAXSPRITES-1)];
+            value = libdivide_s32_do(value, dptr);
+            break;
+        }
+        case GAMEVAR_PERPLAYER:
+        {
+            auto &value = var.pValues[vm.playerNum & (MAXPLAYERS-1)];
+            value = libdivide_s32_do(value, dptr);
+            break;
+        }
+        default: var.global = libdivide_s32_do(var.global, dptr); break;
 
         case GAMEVAR_INT32PTR:
         {
@@ -467,6 +467,71 @@ static TArray<netmapstate_t> g_cl_InterpolatedMapStateHistory;
 static TArray<netmapstate_t> g_mapStateHistory;
 static TArray<uint8_t> tempnetbuf;
 
+// Server side snapshot history.
+//
+// Instead of a full netmapstate_t per revision, the server keeps the latest state of everything in
+// g_netCurrentMapState, and for each of the last NET_REVISIONS revisions a log of what that revision changed,
+// holding the values from before the change. The state of something at an older revision is the old value
+// logged by the first change after that revision, or the current value if nothing changed it since, so a
+// delta from a client's acknowledged revision only has to look at what changed in between.
+//
+// Walls and sectors get compared up to numwalls / numsectors, actors only for the sprites in the stat lists
+// and the ones deleted since the previous revision.
+template<typename T>
+struct netChangeLog_t
+{
+    TArray<int16_t> index;
+    TArray<T>       oldValue;
+};
+
+typedef struct netRevisionLog_s
+{
+    netChangeLog_t<netWall_t>   walls;
+    netChangeLog_t<netSector_t> sectors;
+    netChangeLog_t<netactor_t>  actors;
+} netRevisionLog_t;
+
+template<typename T>
+struct netChange_t
+{
+    int16_t  index;
+    const T* from;
+};
+
+static netmapstate_t    g_netCurrentMapState;
+static netRevisionLog_t g_netRevisionLog[NET_REVISIONS];
+static TArray<int16_t>  g_netLiveActors;                // sprites that were in a stat list in the latest revision
+static uint32_t         g_netWallMark[MAXWALLS];
+static uint32_t         g_netSectorMark[MAXSECTORS];
+static uint32_t         g_netActorMark[MAXSPRITES];
+static uint32_t         g_netMarkValue;
+static uint32_t         g_netLogStart;                  // revision g_netCurrentMapState was first built at
+static bool             g_netLogValid = false;
+
+// Load test bots, see Net_StartLoadTest()
+typedef struct netloadbot_s
+{
+    ENetHost* host;
+    ENetPeer* peer;
+    int32_t   playerIndex;
+    int32_t   ready;
+    uint32_t  revision;                 // latest world update received, acknowledged in every client update
+
+    uint64_t  bytesReceived;
+    uint32_t  worldUpdates;
+    double    latencyTotal;             // time from Net_SendMapUpdate() to the world update arriving, in ms
+    double    latencyMax;
+} netloadbot_t;
+
+static TArray<netloadbot_t> g_netLoadBots;
+static double   g_netLoadStartTime;
+static double   g_netLoadEndTime;
+static double   g_netLoadTicTimeTotal;
+static double   g_netLoadTicTimeMax;
+static uint32_t g_netLoadTics;
+static uint32_t g_netLoadServerSentData;
+static double   g_netLoadRevisionTime[NET_REVISIONS];  // when each revision was made by Net_SendMapUpdate()
+
 // Remember that this constant needs to be one bit longer than a struct index, so it can't be mistaken for a valid wall, sprite, or sector index
 static const int32_t cSTOP_PARSING_CODE = ((1 << NETINDEX_BITS) - 1);
 
@@ -481,6 +546,8 @@ bool        g_enableClientInterpolationCheck = true;
 
 // Internal functions
 static void Net_ReadWorldUpdate(uint8_t *packetData, int32_t packetSize);
+static void Net_InitMapState(netmapstate_t* mapState);
+static void Net_StopLoadTest(void);
 
 
 //Adds a sprite with index 'spriteIndex' to the netcode's internal scratch sprite list,
@@ -1491,6 +1558,155 @@ static void Net_AddWorldToSnapshot(netmapstate_t* snapshot)
     Net_AddActorsToSnapshot(snapshot);
 }
 
+// returns a new value for marking entries in g_net*Mark, to avoid clearing them each time
+static uint32_t Net_NextMark()
+{
+    if (++g_netMarkValue == 0)
+    {
+        Bmemset(g_netWallMark, 0, sizeof(g_netWallMark));
+        Bmemset(g_netSectorMark, 0, sizeof(g_netSectorMark));
+        Bmemset(g_netActorMark, 0, sizeof(g_netActorMark));
+        g_netMarkValue = 1;
+    }
+
+    return g_netMarkValue;
+}
+
+template<typename T>
+static void Net_LogChange(netChangeLog_t<T>& log, int32_t index, T* current, const T& newValue)
+{
+    if (memcmp(current, &newValue, sizeof(T)) != 0)
+    {
+        log.index.Push(index);
+        log.oldValue.Push(*current);
+        *current = newValue;
+    }
+}
+
+static void Net_UpdateServerActor(int32_t spriteIndex, netRevisionLog_t& log)
+{
+    netactor_t netActor;
+
+    Net_CopyAllActorDataToNet(spriteIndex, &sprite[spriteIndex], &actor[spriteIndex], &spriteext[spriteIndex], &spritesmooth[spriteIndex], &netActor);
+    Net_LogChange(log.actors, spriteIndex, &g_netCurrentMapState.actor[spriteIndex], netActor);
+}
+
+// Server only: brings g_netCurrentMapState up to date and logs what changed for this revision.
+static void Net_UpdateServerMapState(uint32_t revision)
+{
+    netRevisionLog_t& log = g_netRevisionLog[revision % NET_REVISIONS];
+
+    log.walls.index.Clear();
+    log.walls.oldValue.Clear();
+    log.sectors.index.Clear();
+    log.sectors.oldValue.Clear();
+    log.actors.index.Clear();
+    log.actors.oldValue.Clear();
+
+    if (!g_netLogValid)
+    {
+        Net_InitMapState(&g_netCurrentMapState);
+        Net_AddWorldToSnapshot(&g_netCurrentMapState);
+
+        g_netLiveActors.Clear();
+
+        for (int32_t spriteIndex = 0; spriteIndex < MAXSPRITES; spriteIndex++)
+        {
+            if (sprite[spriteIndex].statnum != MAXSTATUS)
+            {
+                g_netLiveActors.Push(spriteIndex);
+            }
+        }
+
+        g_netLogStart = revision;
+        g_netLogValid = true;
+    }
+    else
+    {
+        for (int32_t index = 0; index < numwalls; index++)
+        {
+            netWall_t netWall;
+
+            Net_CopyWallToNet(&wall[index], &netWall, index);
+            Net_LogChange(log.walls, index, &g_netCurrentMapState.wall[index], netWall);
+        }
+
+        for (int32_t index = 0; index < numsectors; index++)
+        {
+            netSector_t netSector;
+
+            Net_CopySectorToNet(&sector[index], &netSector, index);
+            Net_LogChange(log.sectors, index, &g_netCurrentMapState.sector[index], netSector);
+        }
+
+        uint32_t const liveMark = Net_NextMark();
+
+        TArray<int16_t> liveActors;
+        liveActors.Reserve(g_netLiveActors.Size());
+        liveActors.Clear();
+
+        for (int32_t statIndex = 0; statIndex < MAXSTATUS; statIndex++)
+        {
+            for (int32_t spriteIndex = headspritestat[statIndex]; spriteIndex >= 0; spriteIndex = nextspritestat[spriteIndex])
+            {
+                g_netActorMark[spriteIndex] = liveMark;
+                liveActors.Push(spriteIndex);
+
+                Net_UpdateServerActor(spriteIndex, log);
+            }
+        }
+
+        // sprites deleted since the last revision aren't in any stat list anymore
+        for (int16_t spriteIndex : g_netLiveActors)
+        {
+            if (g_netActorMark[spriteIndex] != liveMark)
+            {
+                Net_UpdateServerActor(spriteIndex, log);
+            }
+        }
+
+        g_netLiveActors = std::move(liveActors);
+    }
+
+    g_netCurrentMapState.revisionNumber = revision;
+    g_netCurrentMapState.maxActorIndex  = MAXSPRITES;
+}
+
+// Server only: whether the change logs reach back to the given revision
+static bool Net_CanDeltaFromRevision(uint32_t fromRevision, uint32_t toRevision)
+{
+    return g_netLogValid && fromRevision >= g_netLogStart && toRevision >= fromRevision && (toRevision - fromRevision) < NET_REVISIONS;
+}
+
+// Server only: collects everything of one kind that changed after fromRevision, with its value at fromRevision,
+// in ascending index order.
+template<typename T>
+static void Net_GatherChanges(uint32_t fromRevision, uint32_t toRevision, netChangeLog_t<T> netRevisionLog_t::*member, uint32_t* marks, TArray<netChange_t<T>>& changes)
+{
+    uint32_t const changedMark = Net_NextMark();
+
+    changes.Clear();
+
+    // going forward in time, so the first logged change of something has its value at fromRevision
+    for (uint32_t revision = fromRevision + 1; revision <= toRevision; revision++)
+    {
+        const netChangeLog_t<T>& log = g_netRevisionLog[revision % NET_REVISIONS].*member;
+
+        for (uint32_t logIndex = 0; logIndex < log.index.Size(); logIndex++)
+        {
+            int16_t const index = log.index[logIndex];
+
+            if (marks[index] != changedMark)
+            {
+                marks[index] = changedMark;
+                changes.Push({ index, &log.oldValue[logIndex] });
+            }
+        }
+    }
+
+    std::sort(changes.begin(), changes.end(), [](const netChange_t<T>& a, const netChange_t<T>& b) { return a.index < b.index; });
+}
+
 
 
 
@@ -1675,6 +1891,8 @@ static void Net_Disconnect(void)
         int32_t peerIndex;
         ENetEvent event;
 
+        Net_StopLoadTest();
+
         for (peerIndex = 0; peerIndex < (signed)g_netServer->peerCount; peerIndex++)
         {
             enet_peer_disconnect_later(&g_netServer->peers[peerIndex], DISC_SERVER_QUIT);
@@ -3481,6 +3699,53 @@ static void Net_WriteWorldToBuffer(NetBuffer_t* netBuffer, const netmapstate_t*
 
 }
 
+// Server only: writes the same delta as Net_WriteWorldToBuffer() from the snapshot of fromRevision to
+// g_netCurrentMapState, but only visits what the change logs say changed in between.
+static void Net_WriteWorldChangesToBuffer(NetBuffer_t* netBuffer, uint32_t fromRevision, uint32_t toRevision)
+{
+    static TArray<netChange_t<netWall_t>>   changedWalls;
+    static TArray<netChange_t<netSector_t>> changedSectors;
+    static TArray<netChange_t<netactor_t>>  changedActors;
+
+    Net_GatherChanges(fromRevision, toRevision, &netRevisionLog_t::walls, g_netWallMark, changedWalls);
+    Net_GatherChanges(fromRevision, toRevision, &netRevisionLog_t::sectors, g_netSectorMark, changedSectors);
+    Net_GatherChanges(fromRevision, toRevision, &netRevisionLog_t::actors, g_netActorMark, changedActors);
+
+    for (const netChange_t<netWall_t>& change : changedWalls)
+    {
+        NetBuffer_WriteDeltaNetWall(netBuffer, change.from, &g_netCurrentMapState.wall[change.index]);
+    }
+
+    NetBuffer_WriteBits(netBuffer, cSTOP_PARSING_CODE, NETINDEX_BITS);
+
+    for (const netChange_t<netSector_t>& change : changedSectors)
+    {
+        NetBuffer_WriteDeltaNetSector(netBuffer, change.from, &g_netCurrentMapState.sector[change.index]);
+    }
+
+    NetBuffer_WriteBits(netBuffer, cSTOP_PARSING_CODE, NETINDEX_BITS);
+
+    for (const netChange_t<netactor_t>& change : changedActors)
+    {
+        const netactor_t* fromActor = change.from;
+        const netactor_t* toActor   = &g_netCurrentMapState.actor[change.index];
+
+        if (fromActor->netIndex == cSTOP_PARSING_CODE)
+        {
+            fromActor = NULL;
+        }
+
+        if (toActor->netIndex == cSTOP_PARSING_CODE)
+        {
+            toActor = NULL;
+        }
+
+        NetBuffer_WriteDeltaNetActor(netBuffer, fromActor, toActor, 0);
+    }
+
+    NetBuffer_WriteBits(netBuffer, cSTOP_PARSING_CODE, NETINDEX_BITS); // end of actors/sprites
+}
+
 
 // buffer -> net struct functions
 //----------------------------------------------------------------------------------------------------------
@@ -4234,28 +4499,26 @@ static void Net_SendWorldUpdate(uint32_t fromRevisionNumber, uint32_t toRevision
 
     uint32_t        fromRevisionNumberToSend = 0x86753090;
 
-    netmapstate_t*  toMapState = &g_mapStateHistory[toRevisionNumber % NET_REVISIONS];
-    netmapstate_t*  fromMapState = NULL;
+    Bassert(toRevisionNumber == g_netCurrentMapState.revisionNumber);
+
+    // the change logs don't reach back before the level started, or further than NET_REVISIONS
+    bool            revisionIsLogged = Net_CanDeltaFromRevision(fromRevisionNumber, toRevisionNumber);
 
     NET_75_CHECK++; // during the rollover state it might be a good idea to init the map state history?
                     // maybe not? I do init map states before using them, so it might not be needed.
 
 
-    if (playerRevisionIsTooOld || revisionInRolloverState)
+    if (playerRevisionIsTooOld || revisionInRolloverState || !revisionIsLogged)
     {
-        fromMapState = &g_mapStartState;
         fromRevisionNumberToSend = cInitialMapStateRevisionNumber;
     }
     else
     {
-        uint32_t tFromRevisionIndex = fromRevisionNumber % NET_REVISIONS;
-
-        fromMapState = &g_mapStateHistory[tFromRevisionIndex];
         fromRevisionNumberToSend = fromRevisionNumber;
     }
 
 
-    Bmemset(byteBuffer, 0, sizeof(tempnetbuf) - 1);
+    Bmemset(byteBuffer, 0, tempnetbuf.Size() - 1);
 
     tempnetbuf[0] = PACKET_WORLD_UPDATE;
 
@@ -4264,7 +4527,14 @@ static void Net_SendWorldUpdate(uint32_t fromRevisionNumber, uint32_t toRevision
     NetBuffer_WriteDword(bufferPtr, fromRevisionNumberToSend);
     NetBuffer_WriteDword(bufferPtr, toRevisionNumber);
 
-    Net_WriteWorldToBuffer(bufferPtr, fromMapState, toMapState);
+    if (fromRevisionNumberToSend == cInitialMapStateRevisionNumber)
+    {
+        Net_WriteWorldToBuffer(bufferPtr, &g_mapStartState, &g_netCurrentMapState);
+    }
+    else
+    {
+        Net_WriteWorldChangesToBuffer(bufferPtr, fromRevisionNumber, toRevisionNumber);
+    }
 
     if (sendToPlayerIndex > ((int32_t) g_netServer->peerCount))
     {
@@ -4277,7 +4547,7 @@ static void Net_SendWorldUpdate(uint32_t fromRevisionNumber, uint32_t toRevision
 
     NET_75_CHECK++; // HACK: I Really need to keep the peer with the player instead of assuming that the peer index is the same as the (player index - 1)
     ENetPeer *const tCurrentPeer = &g_netServer->peers[sendToPlayerIndex - 1];
-    enet_peer_send(tCurrentPeer, CHAN_GAMESTATE, enet_packet_create(&tempnetbuf, bufferPtr->CurSize + 1, 0));
+    enet_peer_send(tCurrentPeer, CHAN_GAMESTATE, enet_packet_create(tempnetbuf.Data(), bufferPtr->CurSize + 1, 0));
     Dbg_PacketSent(PACKET_WORLD_UPDATE);
 
 
@@ -4333,6 +4603,8 @@ static void Net_CopySnapshotToGameArrays(netmapstate_t* srv_snapshot, netmapstat
         Net_CopySectorFromNet(srvSector, gameSector);
     }
 
+    pvsUpdateGeometry();
+
     Net_CopyActorsToGameArrays(srv_snapshot, cl_snapshot);
 }
 
@@ -4356,6 +4628,13 @@ static void Net_ReadWorldUpdate(uint8_t* packetData, int32_t packetSize)
         return;
     }
 
+    // the history only exists once the level has been set up (Net_InitMapStateHistory()),
+    // an update arriving before that has nothing to apply to
+    if (g_mapStateHistory.Size() != NET_REVISIONS)
+    {
+        return;
+    }
+
     NetBuffer_Init(bufferPtr, dataStartAddr, MAX_WORLDBUFFER);
 
     bufferPtr->CurSize = packetSize - 1;
@@ -4592,7 +4871,7 @@ void Net_StoreClientState(void)
     }
 
     // don't store client revisions if we don't even have a server revision
-    if(g_netMapRevisionNumber < cStartingRevisionIndex)
+    if(g_netMapRevisionNumber < cStartingRevisionIndex || g_cl_InterpolatedMapStateHistory.Size() != NET_REVISIONS)
     {
         return;
     }
@@ -4615,14 +4894,22 @@ void Net_SendMapUpdate(void)
         return;
     }
 
+    uint32_t const previousRevisionNumber = g_netMapRevisionNumber;
+
     g_netMapRevisionNumber = Net_GetNextRevisionNumber(g_netMapRevisionNumber);
 
-    netmapstate_t* toMapState = &g_mapStateHistory[g_netMapRevisionNumber % NET_REVISIONS];
+    if (g_netMapRevisionNumber < previousRevisionNumber)
+    {
+        // the revision number rolled over, the change logs can't be used to go across that
+        g_netLogValid = false;
+    }
 
-    Net_InitMapState(toMapState);
-    Net_AddWorldToSnapshot(toMapState);
+    Net_UpdateServerMapState(g_netMapRevisionNumber);
 
-    toMapState->revisionNumber = g_netMapRevisionNumber;
+    if (g_netLoadBots.Size() > 0)
+    {
+        g_netLoadRevisionTime[g_netMapRevisionNumber % NET_REVISIONS] = timerGetHiTicks();
+    }
 
     int32_t playerIndex = 0;
 
@@ -4662,7 +4949,15 @@ void DumpMapStateHistory()
 
     fwrite(&g_mapStartState, sizeof(g_mapStartState), 1, mapStatesFile);
 
-    fwrite(&g_mapStateHistory[0], sizeof(g_mapStateHistory), 1, mapStatesFile);
+    if (g_netClient)
+    {
+        fwrite(g_mapStateHistory.Data(), sizeof(netmapstate_t), g_mapStateHistory.Size(), mapStatesFile);
+    }
+    else
+    {
+        // the server only keeps the latest state, see g_netRevisionLog
+        fwrite(&g_netCurrentMapState, sizeof(g_netCurrentMapState), 1, mapStatesFile);
+    }
 
     OSD_Printf("Dumped map states to %s.\n", fileName);
 
@@ -5136,9 +5431,21 @@ void Net_SendMessage(void)
 
 void Net_InitMapStateHistory()
 {
-    int32_t mapStateIndex = 0;
+    uint32_t mapStateIndex = 0;
+
+    // only clients need every revision in full, the server keeps change logs instead (see g_netRevisionLog)
+    if (g_netClient)
+    {
+        g_mapStateHistory.Resize(NET_REVISIONS);
+        g_cl_InterpolatedMapStateHistory.Resize(NET_REVISIONS);
+    }
+    else
+    {
+        g_mapStateHistory.Reset();
+        g_cl_InterpolatedMapStateHistory.Reset();
+    }
 
-    for (mapStateIndex = 0; mapStateIndex < NET_REVISIONS; mapStateIndex++)
+    for (mapStateIndex = 0; mapStateIndex < g_mapStateHistory.Size(); mapStateIndex++)
     {
         netmapstate_t *mapState = &g_mapStateHistory[mapStateIndex];
         netmapstate_t *clState  = &g_cl_InterpolatedMapStateHistory[mapStateIndex];
@@ -5154,12 +5461,12 @@ void Net_InitMapStateHistory()
 
     g_netMapRevisionNumber    = cInitialMapStateRevisionNumber;  // Net_InitMapStateHistory()
     g_cl_InterpolatedRevision = cInitialMapStateRevisionNumber;
+
+    g_netLogValid             = false;
 }
 
 void Net_StartNewGame()
 {
-    g_mapStateHistory.Resize(NET_REVISIONS);
-    g_cl_InterpolatedMapStateHistory.Resize(NET_REVISIONS);
     tempnetbuf.Resize(MAX_WORLDBUFFER);
     Net_ResetPlayers();
 
@@ -5263,6 +5570,273 @@ void Net_PrintLag(FString &output)
     }
 }
 
+//------------------------------------------------------------------------------------------------------------------------
+// Load test
+//
+// Connects bot clients to this server over loopback, all running in this process, each with its own ENet host.
+// The bots send the same packets a real client does: they authenticate, report ready when the new game packet
+// comes in, and send a clientupdate_t with scripted input every tic, acknowledging the latest world update they got.
+// They don't run a game of their own; their player update is whatever the server simulated for them, so the
+// server never gets corrected by them.
+//
+// When the time is up the server's time per tic, the bytes sent to each bot and the world update latency
+// get printed, and the bots disconnect.
+
+static void Net_SendLoadBotChallenge(netloadbot_t* bot)
+{
+    uint8_t challenge[10];
+
+    challenge[0] = PACKET_AUTH;
+    B_BUF16(&challenge[1], BYTEVERSION);
+    B_BUF16(&challenge[3], NETVERSION);
+    B_BUF32(&challenge[5], Bcrc32((uint8_t *)g_netPassword, Bstrlen(g_netPassword), 0));
+    challenge[9] = 0;
+
+    enet_peer_send(bot->peer, CHAN_GAMESTATE, enet_packet_create(challenge, sizeof(challenge), ENET_PACKET_FLAG_RELIABLE));
+}
+
+static void Net_ReceiveLoadBotPacket(netloadbot_t* bot, const ENetPacket* packet, double receiveTime)
+{
+    const uint8_t* pbuf = packet->data;
+
+    bot->bytesReceived += packet->dataLength;
+
+    switch (pbuf[0])
+    {
+    case PACKET_PLAYER_INDEX:
+        bot->playerIndex = pbuf[1];
+        break;
+
+    case PACKET_NEW_GAME:
+    {
+        uint8_t ready[2] = { PACKET_PLAYER_READY, (uint8_t)bot->playerIndex };
+
+        enet_peer_send(bot->peer, CHAN_GAMESTATE, enet_packet_create(ready, sizeof(ready), ENET_PACKET_FLAG_RELIABLE));
+
+        bot->ready    = 1;
+        bot->revision = cInitialMapStateRevisionNumber;
+        break;
+    }
+
+    case PACKET_WORLD_UPDATE:
+    {
+        NetBuffer_t buffer;
+
+        // from and to revision numbers
+        if (packet->dataLength < 9)
+        {
+            break;
+        }
+
+        NetBuffer_Init(&buffer, packet->data + 1, packet->dataLength - 1);
+        buffer.CurSize = packet->dataLength - 1;
+
+        NetBuffer_ReadDWord(&buffer);
+        uint32_t const toRevisionNumber = NetBuffer_ReadDWord(&buffer);
+
+        double const latency = receiveTime - g_netLoadRevisionTime[toRevisionNumber % NET_REVISIONS];
+
+        bot->revision      = toRevisionNumber;
+        bot->latencyTotal += latency;
+        bot->latencyMax    = max(bot->latencyMax, latency);
+        bot->worldUpdates++;
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+// walks forward, turns one way or the other for a while every couple of seconds and fires now and then,
+// staggered by player so the bots don't all do the same thing.
+static void Net_GetLoadBotInput(const netloadbot_t* bot, input_t* input)
+{
+    DukePlayer_t const* const pPlayer = g_player[bot->playerIndex].ps;
+
+    int32_t const tic    = g_netLoadTics + bot->playerIndex * 37;
+    int32_t const q16ang = fix16_to_int(pPlayer->q16ang);
+    int32_t const fvel   = 80;
+    int32_t const svel   = ((tic / 90) & 1) ? 20 : -20;
+
+    Bmemset(input, 0, sizeof(input_t));
+
+    input->fvel = mulscale9(fvel, sintable[(q16ang + 2560) & 2047]) + mulscale9(svel, sintable[(q16ang + 2048) & 2047]);
+    input->svel = mulscale9(fvel, sintable[(q16ang + 2048) & 2047]) + mulscale9(svel, sintable[(q16ang + 1536) & 2047]);
+
+    if ((tic % 60) < 15)
+    {
+        input->q16avel = fix16_from_int(((tic / 60) & 1) ? 16 : -16);
+    }
+
+    if ((tic % 45) < 5)
+    {
+        input->bits |= 1 << SK_FIRE;
+    }
+
+    if ((tic % 150) == 0)
+    {
+        input->bits |= 1 << SK_JUMP;
+    }
+}
+
+static void Net_SendLoadBotUpdate(netloadbot_t* bot)
+{
+    clientupdate_t update;
+
+    update.header         = PACKET_SLAVE_TO_MASTER;
+    update.RevisionNumber = bot->revision;
+
+    Net_GetLoadBotInput(bot, &update.nsyn);
+    Net_FillPlayerUpdate(&update.player, bot->playerIndex);
+
+    enet_peer_send(bot->peer, CHAN_MOVE, enet_packet_create(&update, sizeof(clientupdate_t), 0));
+}
+
+static void Net_PrintLoadTestResults(void)
+{
+    double const seconds = max(timerGetHiTicks() - g_netLoadStartTime, 1.0) / 1000.0;
+
+    OSD_Printf("netloadtest: %d bots, %u tics in %.1f s\n", g_netLoadBots.Size(), g_netLoadTics, seconds);
+    OSD_Printf("    server time per tic: %.3f ms average, %.3f ms max\n",
+        g_netLoadTics ? g_netLoadTicTimeTotal / g_netLoadTics : 0.0, g_netLoadTicTimeMax);
+    OSD_Printf("    server sent %.1f KB/s in total, including ENet overhead\n",
+        (g_netServer->totalSentData - g_netLoadServerSentData) / 1024.0 / seconds);
+
+    for (netloadbot_t const& bot : g_netLoadBots)
+    {
+        OSD_Printf("    player %d: %.1f KB/s, %u world updates, latency %.1f ms average, %.1f ms max\n",
+            bot.playerIndex, bot.bytesReceived / 1024.0 / seconds, bot.worldUpdates,
+            bot.worldUpdates ? bot.latencyTotal / bot.worldUpdates : 0.0, bot.latencyMax);
+    }
+}
+
+static void Net_StopLoadTest(void)
+{
+    if (g_netLoadBots.Size() == 0)
+    {
+        return;
+    }
+
+    for (netloadbot_t& bot : g_netLoadBots)
+    {
+        if (bot.peer)
+        {
+            enet_peer_disconnect_now(bot.peer, 0);
+        }
+
+        enet_host_destroy(bot.host);
+    }
+
+    g_netLoadBots.Reset();
+}
+
+void Net_StartLoadTest(int32_t numBots, int32_t seconds)
+{
+    if (!g_netServer)
+    {
+        OSD_Printf("netloadtest: You are not the server.\n");
+        return;
+    }
+
+    if (g_netLoadBots.Size() > 0)
+    {
+        OSD_Printf("netloadtest: A load test is already running.\n");
+        return;
+    }
+
+    numBots = clamp(numBots, 1, MAXPLAYERS - numplayers);
+
+    ENetAddress address;
+
+    enet_address_set_host(&address, "127.0.0.1");
+    address.port = g_netPort;
+
+    for (int32_t botIndex = 0; botIndex < numBots; botIndex++)
+    {
+        netloadbot_t bot = {};
+
+        bot.host = enet_host_create(NULL, 1, CHAN_MAX, 0, 0);
+
+        if (bot.host == NULL)
+        {
+            OSD_Printf("netloadtest: Could not create an ENet host for bot %d.\n", botIndex);
+            break;
+        }
+
+        bot.peer        = enet_host_connect(bot.host, &address, CHAN_MAX, 0);
+        bot.playerIndex = -1;
+
+        g_netLoadBots.Push(bot);
+    }
+
+    g_netLoadStartTime      = timerGetHiTicks();
+    g_netLoadEndTime        = g_netLoadStartTime + max(seconds, 1) * 1000.0;
+    g_netLoadTicTimeTotal   = 0.0;
+    g_netLoadTicTimeMax     = 0.0;
+    g_netLoadTics           = 0;
+    g_netLoadServerSentData = g_netServer->totalSentData;
+
+    OSD_Printf("netloadtest: Connecting %d bots for %d seconds.\n", g_netLoadBots.Size(), max(seconds, 1));
+}
+
+// ticTime is how long the server took for this tic, in ms
+void Net_UpdateLoadTest(double ticTime)
+{
+    if (g_netLoadBots.Size() == 0)
+    {
+        return;
+    }
+
+    g_netLoadTicTimeTotal += ticTime;
+    g_netLoadTicTimeMax    = max(g_netLoadTicTimeMax, ticTime);
+    g_netLoadTics++;
+
+    // get this tic's updates out to the bots now instead of at the next Net_GetPackets()
+    enet_host_flush(g_netServer);
+
+    for (netloadbot_t& bot : g_netLoadBots)
+    {
+        ENetEvent event;
+
+        while (bot.peer && enet_host_service(bot.host, &event, 0) > 0)
+        {
+            switch (event.type)
+            {
+            case ENET_EVENT_TYPE_CONNECT:
+                Net_SendLoadBotChallenge(&bot);
+                break;
+
+            case ENET_EVENT_TYPE_RECEIVE:
+                Net_ReceiveLoadBotPacket(&bot, event.packet, timerGetHiTicks());
+                enet_packet_destroy(event.packet);
+                break;
+
+            case ENET_EVENT_TYPE_DISCONNECT:
+                OSD_Printf("netloadtest: Bot for player %d was disconnected.\n", bot.playerIndex);
+                bot.peer = NULL;
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        if (bot.peer && bot.ready && bot.playerIndex > 0 && g_player[bot.playerIndex].ps)
+        {
+            Net_SendLoadBotUpdate(&bot);
+        }
+
+        enet_host_flush(bot.host);
+    }
+
+    if (timerGetHiTicks() >= g_netLoadEndTime)
+    {
+        Net_PrintLoadTestResults();
+        Net_StopLoadTest();
+    }
+}
+
 int osdcmd_listplayers(osdcmdptr_t parm)
 {
     ENetPeer* currentPeer;
@@ -303,6 +303,9 @@ void Net_SendRTS(int ridiculeNum);
 void Net_InitNetwork();
 void Net_PrintLag(FString& output);
 
+void Net_StartLoadTest(int32_t numBots, int32_t seconds);
+void Net_UpdateLoadTest(double ticTime);
+
 #else
 
 // note: don't include faketimerhandler in this
@@ -337,6 +340,8 @@ void Net_PrintLag(FString& output);
 #define Net_SendMapVoteCancel(...) ((void)0)
 
 #define Net_ResetPrediction(...) ((void)0)
+#define Net_StartLoadTest(...) ((void)0)
+#define Net_UpdateLoadTest(...) ((void)0)
 #define Net_RestoreMapState(...) ((void)0)
 #define Net_WaitForServer(...) ((void)0)
 
@@ -495,6 +495,16 @@ static int osdcmd_dumpmapstate(osdfuncparm_t const * const)
     return OSDCMD_OK;
 }
 
+static int osdcmd_netloadtest(osdcmdptr_t parm)
+{
+    if (parm->numparms < 1 || parm->numparms > 2)
+        return OSDCMD_SHOWHELP;
+
+    Net_StartLoadTest(Batol(parm->parms[0]), parm->numparms > 1 ? Batol(parm->parms[1]) : 30);
+
+    return OSDCMD_OK;
+}
+
 static int osdcmd_playerinfo(osdfuncparm_t const * const)
 {
     OSD_Printf("Your player index is %d.\n", myconnectindex);
@@ -614,6 +624,43 @@ static int osdcmd_printtimes(osdcmdptr_t UNUSED(parm))
     return OSDCMD_OK;
 }
 
+static int osdcmd_profilecon(osdcmdptr_t parm)
+{
+    if (parm->numparms < 1)
+        return OSDCMD_SHOWHELP;
+
+    if (!Bstrcasecmp(parm->parms[0], "start"))
+    {
+        int const interval = parm->numparms > 1 ? Batoi(parm->parms[1]) : 1000;
+
+        if (!VM_ProfileStart(interval))
+            OSD_Printf("profilecon: Already running.\n");
+        else
+            OSD_Printf("profilecon: Sampling every %d us.\n", max(interval, 100));
+    }
+    else if (!Bstrcasecmp(parm->parms[0], "stop"))
+    {
+        int const numSamples = VM_ProfileStop();
+
+        if (numSamples < 0)
+            OSD_Printf("profilecon: Not running.\n");
+        else
+            OSD_Printf("profilecon: Stopped after %d samples.\n", numSamples);
+    }
+    else if (!Bstrcasecmp(parm->parms[0], "write"))
+    {
+        char const *fileName = parm->numparms > 1 ? parm->parms[1] : "conprofile.folded";
+
+        if (VM_ProfileWrite(fileName))
+            OSD_Printf("profilecon: Wrote %s.\n", fileName);
+        else
+            OSD_Printf("profilecon: Could not write %s.\n", fileName);
+    }
+    else
+        return OSDCMD_SHOWHELP;
+
+    return OSDCMD_OK;
+}
 
 int32_t registerosdcommands(void)
 {
@@ -626,6 +673,7 @@ int32_t registerosdcommands(void)
     OSD_RegisterFunction("kickban","kickban <id>: kicks a multiplayer client and prevents them from reconnecting.  See listplayers.", osdcmd_kickban);
 #endif
     OSD_RegisterFunction("listplayers","listplayers: lists currently connected multiplayer clients", osdcmd_listplayers);
+    OSD_RegisterFunction("netloadtest","netloadtest <bots> [seconds]: connects bot clients to this server over loopback and reports the server's load", osdcmd_netloadtest);
     OSD_RegisterFunction("password","password: sets multiplayer game password", osdcmd_password);
     OSD_RegisterFunction("playerinfo", "Prints information about the current player", osdcmd_playerinfo);
 #endif
@@ -647,6 +695,7 @@ int32_t registerosdcommands(void)
 
 
     OSD_RegisterFunction("printtimes", "printtimes: prints VM timing statistics", osdcmd_printtimes);
+    OSD_RegisterFunction("profilecon", "profilecon <start [interval us]|stop|write [file]>: samples the CON VM by source line and writes a folded stack profile", osdcmd_profilecon);
 
     OSD_RegisterFunction("restartmap", "restartmap: restarts the current map", osdcmd_restartmap);
 	OSD_RegisterFunction("addlogvar","addlogvar <gamevar>: prints the value of a gamevar", osdcmd_addlogvar);
@@ -822,7 +822,7 @@ static void P_PrepForNewLevel(int playerNum, int gameMode)
     g_curViewscreen    = -1;
     g_cyclerCnt        = 0;
     g_earthquakeTime   = 0;
-    g_interpolationCnt = 0;
+    ClearInterpolations();
 
     randomseed  = 1996;
     screenpeek  = myconnectindex;
@@ -1867,7 +1867,6 @@ int G_EnterLevel(int gameMode)
 
     G_ClearFIFO();
 
-    for (int i=g_interpolationCnt-1; i>=0; i--) bakipos[i] = *curipos[i];
 
     G_ResetTimers(0);  // Here we go
 
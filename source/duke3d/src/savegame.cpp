@@ -35,6 +35,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "mapinfo.h"
 #include "z_music.h"
 
+#include <zlib.h>
+
 BEGIN_DUKE_NS
 
 // For storing pointers in files.
@@ -100,7 +102,7 @@ void G_ResetInterpolations(void)
 {
     int32_t k, i;
 
-    g_interpolationCnt = 0;
+    ClearInterpolations();
 
     k = headspritestat[STAT_EFFECTOR];
     while (k >= 0)
@@ -134,7 +136,6 @@ void G_ResetInterpolations(void)
         k = nextspritestat[k];
     }
 
-    for (i=g_interpolationCnt-1; i>=0; i--) bakipos[i] = *curipos[i];
     for (i = g_animateCnt-1; i>=0; i--)
         G_SetInterpolation(g_animatePtr[i]);
 }
@@ -1220,8 +1221,8 @@ static void sv_makevarspec()
         unsigned const per = aGameVars[i].flags & GAMEVAR_USER_MASK;
 
         svgm_vars[vcnt].flags = 0;
-        svgm_vars[vcnt].ptr   = (per == 0) ? &aGameVars[i].global : aGameVars[i].pValues;
-        svgm_vars[vcnt].size  = sizeof(intptr_t);
+        svgm_vars[vcnt].ptr   = (per == 0) ? &aGameVars[i].global : (per == GAMEVAR_PERPLAYER ? (void *)aGameVars[i].pValues : aGameVars[i].pActorValues);
+        svgm_vars[vcnt].size  = (per == GAMEVAR_PERACTOR) ? sizeof(int32_t) : sizeof(intptr_t);
         svgm_vars[vcnt].cnt   = (per == 0) ? 1 : (per == GAMEVAR_PERPLAYER ? MAXPLAYERS : MAXSPRITES);
 
         ++vcnt;
@@ -1303,6 +1304,7 @@ int32_t sv_saveandmakesnapshot(FileWriter &fil, int8_t spot)
     h.userbytever  = ud.userbytever;
     h.scriptcrc    = g_scriptcrc;
 
+    h.recdiffsp = ((spot < 0) && demorec_diffs_cvar) ? SV_DEMO_DIFFS | (demorec_keyframetics_cvar > 0 ? SV_DEMO_KEYFRAMES : 0) : 0;
     h.reccnt  = 0;
     h.snapsiz = svsnapsiz;
 
@@ -1387,7 +1389,7 @@ int32_t sv_loadheader(FileReader &fill, int32_t spot, savehead_t *h)
 #ifndef DEBUGGINGAIDS
         if (havedemo)
 #endif
-            OSD_Printf("Incompatible savegame. Expected version %d.%d.%d.%d.%0x, found %d.%d.%d.%d.%0x\n", SV_MAJOR_VER, SV_MINOR_VER, BYTEVERSION,
+            OSD_Printf("Incompatible %s. Expected version %d.%d.%d.%d.%0x, found %d.%d.%d.%d.%0x\n", havedemo ? "demo" : "savegame", SV_MAJOR_VER, SV_MINOR_VER, BYTEVERSION,
                        ud.userbytever, g_scriptcrc, h->majorver, h->minorver, h->bytever, h->userbytever, h->scriptcrc);
 
         if (h->majorver == SV_MAJOR_VER && h->minorver == SV_MINOR_VER)
@@ -1540,6 +1542,58 @@ int32_t sv_readdiff(FileReader &fil)
     return i;
 }
 
+// A keyframe is the whole snapshot as the diffs have brought it up to date,
+// so playback can jump straight to it instead of replaying everything before.
+uint32_t sv_writekeyframe(FileWriter *fil)
+{
+    uLongf csiz = compressBound(svsnapsiz);
+    TArray<uint8_t> cbuf(csiz, true);
+
+    if (compress2(cbuf.Data(), &csiz, svsnapshot, svsnapsiz, Z_BEST_SPEED) != Z_OK)
+    {
+        OSD_Printf("sv_writekeyframe: compression failed!\n");
+        return 0;
+    }
+
+    uint32_t const keysiz = csiz;
+
+    fil->Write("kEyF", 4);
+    fil->Write(&keysiz, sizeof(keysiz));
+    fil->Write(cbuf.Data(), keysiz);
+
+    return keysiz;
+}
+
+int32_t sv_readkeyframe(FileReader &fil)
+{
+    uint32_t keysiz;
+
+    if (fil.Read(&keysiz, sizeof(uint32_t)) != sizeof(uint32_t))
+        return -1;
+
+    // nothing compress2() wrote can be larger than this
+    if (keysiz > compressBound(svsnapsiz))
+        return -2;
+
+    TArray<uint8_t> cbuf(keysiz, true);
+
+    if (fil.Read(cbuf.Data(), keysiz) != (int32_t)keysiz)
+        return -2;
+
+    uLongf siz = svsnapsiz;
+
+    if (uncompress(svsnapshot, &siz, cbuf.Data(), keysiz) != Z_OK)
+        return -3;
+
+    if (siz != svsnapsiz)
+    {
+        OSD_Printf("sv_readkeyframe: size=%d, svsnapsiz=%d\n", (int32_t)siz, svsnapsiz);
+        return -4;
+    }
+
+    return 0;
+}
+
 // SVGM data description
 static void sv_postudload()
 {
@@ -33,7 +33,7 @@ BEGIN_DUKE_NS
 #else
 # define SV_MAJOR_VER 1
 #endif
-#define SV_MINOR_VER 7
+#define SV_MINOR_VER 8
 
 #pragma pack(push,1)
 typedef struct
@@ -46,7 +46,7 @@ typedef struct
     uint32_t userbytever;
     uint32_t scriptcrc;
 
-    uint8_t recdiffsp;
+    uint8_t recdiffsp;  // demos: SV_DEMO_* flags
     // 4 bytes
 
     int32_t reccnt, snapsiz;
@@ -59,6 +59,14 @@ typedef struct
 } savehead_t;
 #pragma pack(pop)
 
+enum
+{
+    SV_DEMO_DIFFS = 1,
+    // "kEyF" chunks after some diffs and a keyframe index after the trailer.
+    // Builds that don't know about them stop at the first one with an error.
+    SV_DEMO_KEYFRAMES = 2,
+};
+
 extern int32_t g_fakeSaveID;
 extern bool g_saveRequested;
 
@@ -66,6 +74,8 @@ extern bool g_saveRequested;
 int32_t sv_updatestate(int32_t frominit);
 int32_t sv_readdiff(FileReader& fil);
 uint32_t sv_writediff(FileWriter *fil);
+int32_t sv_readkeyframe(FileReader &fil);
+uint32_t sv_writekeyframe(FileWriter *fil);
 int32_t sv_loadheader(FileReader &fil, int32_t spot, savehead_t *h);
 int32_t sv_loadsnapshot(FileReader &fil, int32_t spot, savehead_t *h);
 int32_t sv_saveandmakesnapshot(FileWriter &fil, int8_t spot);
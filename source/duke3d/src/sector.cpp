@@ -341,6 +341,11 @@ void G_DoSectorAnimations(void)
             }
         }
 
+        // sliding doors move their walls through here
+        intptr_t const wallOfs = (char *)g_animatePtr[animNum] - (char *)wall;
+        if (wallOfs >= 0 && wallOfs < (intptr_t)(MAXWALLS * sizeof(walltype)))
+            pvsWallMoved(wallOfs / sizeof(walltype));
+
         *g_animatePtr[animNum] = animPos;
     }
 }
@@ -86,7 +86,7 @@ typedef struct {
 #ifndef NEW_MAP_FORMAT
     wallext_t wallext[MAXWALLS];
 #endif
-    intptr_t *vars[MAXGAMEVARS];
+    intptr_t *vars[MAXGAMEVARS];  // per-actor vars are saved as int32_t
     intptr_t *arrays[MAXGAMEARRAYS];
     int32_t arraysiz[MAXGAMEARRAYS];
 #ifdef YAX_ENABLE
@@ -82,14 +82,7 @@ void S_PauseSounds(bool paused)
 
 void cacheAllSounds(void)
 {
-    auto& sfx = soundEngine->GetSounds();
-    int i = 0;
-    for(auto &snd : sfx)
-    {
-        soundEngine->CacheSound(&snd);
-        if (((++i)&31) == 0)
-            gameHandleEvents();
-    }
+    soundEngine->CacheAllSounds([]() { gameHandleEvents(); });
 }
 
 //==========================================================================
@@ -76,6 +76,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "c_dispatch.h"
 #include "s_soundinternal.h"
 #include "common/menu/menu.h"
+#include "timedemo.h"
 
 BEGIN_PS_NS
 
@@ -1827,6 +1828,20 @@ void CheckCommandLine(int argc, char const* const* argv, int &doTitle)
             }
         }
     }
+
+    if (TimeDemo_Active() && !bRecord)
+    {
+        // -timedemo is /playback with the demo optionally named on the command line
+        const char *pDemo = *TimeDemo_File() ? TimeDemo_File() : "data.vcr";
+
+        vcrfp = fopen(pDemo, "rb");
+        if (vcrfp == NULL) {
+            I_Error("Can't open demo '%s' for reading\n", pDemo);
+        }
+
+        bPlayback = kTrue;
+        doTitle = kFalse;
+    }
 }
 
 
@@ -2056,6 +2071,9 @@ STARTGAME2:
         levelnew = GameStats.nMap;
         levelnum = GameStats.nMap;
         forcelevel = GameStats.nMap;
+
+        if (TimeDemo_Active())
+            TimeDemo_Start(30);  // GameMove() runs every 4 clocks of 120
     }
 
     if (forcelevel > -1)
@@ -2209,8 +2227,13 @@ GAMELOOP:
 
             if (bPlayback)
             {
+                if (TimeDemo_Active())
+                {
+                    if (!ReadPlaybackInputs())
+                        TimeDemo_Finish();
+                }
                 // YELLOW
-                if (((bInDemo && inputState.keyBufferWaiting()) || !ReadPlaybackInputs()) && inputState.keyGetChar())
+                else if (((bInDemo && inputState.keyBufferWaiting()) || !ReadPlaybackInputs()) && inputState.keyGetChar())
                 {
                     inputState.ClearAllInput();
 
@@ -2272,7 +2295,9 @@ GAMELOOP:
             tclocks += moveframes * 4;
             while (moveframes && levelnew < 0)
             {
+                double const t = timerGetHiTicks();
                 GameMove();
+                TimeDemo_GameTic(timerGetHiTicks() - t);
                 // if (nNetTime > 0)
                 // {
                 //     nNetTime--;
@@ -2296,15 +2321,31 @@ GAMELOOP:
             // END YELLOW SECTION
 
             // loc_12149:
-            if (bInDemo || bPlayback)
+            if (TimeDemo_Active())
             {
-                while (tclocks > totalclock) { HandleAsync(); }
+                // no waiting for the clock, and one frame per recorded input at most
+                HandleAsync();
                 tclocks = totalclock;
-            }
 
-            if (G_FPSLimit())
+                if (!TimeDemo_NoRender())
+                {
+                    double const t = timerGetHiTicks();
+                    GameDisplay();
+                    TimeDemo_Frame(timerGetHiTicks() - t);
+                }
+            }
+            else
             {
-                GameDisplay();
+                if (bInDemo || bPlayback)
+                {
+                    while (tclocks > totalclock) { HandleAsync(); }
+                    tclocks = totalclock;
+                }
+
+                if (G_FPSLimit())
+                {
+                    GameDisplay();
+                }
             }
         }
         else
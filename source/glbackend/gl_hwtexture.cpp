@@ -137,6 +137,30 @@ unsigned int FHardwareTexture::LoadTexturePart(const unsigned char* buffer, int
 	return glTexID;
 }
 
+//===========================================================================
+// 
+//	Records rows that have to be uploaded again before the next use.
+//	This gets called from the texture manager, so it may not touch GL state.
+//
+//===========================================================================
+
+void FHardwareTexture::AddDirtyRows(int top, int bottom)
+{
+	top = std::max(top, 0);
+	bottom = std::min(bottom, mHeight);
+	if (top >= bottom) return;
+	if (!IsDirty())
+	{
+		dirtyTop = top;
+		dirtyBottom = bottom;
+	}
+	else
+	{
+		dirtyTop = std::min(dirtyTop, top);
+		dirtyBottom = std::max(dirtyBottom, bottom);
+	}
+}
+
 //===========================================================================
 // 
 //	Destroys the texture
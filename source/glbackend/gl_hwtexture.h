@@ -26,6 +26,7 @@ private:
 	int mWidth = 0, mHeight = 0;
 	int colorId = 0;
 	uint32_t allocated = 0;
+	int dirtyTop = 0, dirtyBottom = 0;	// rows whose content changed since the last upload
 
 	int GetDepthBuffer(int w, int h);
 
@@ -44,6 +45,12 @@ public:
 	int GetSampler() { return mSampler; }
 	void SetSampler(int sampler) { mSampler = sampler;  }
 	bool isIndexed() const { return internalType == Indexed; }
+	int GetWidth() const { return mWidth; }
+	int GetHeight() const { return mHeight; }
+	void AddDirtyRows(int top, int bottom);
+	bool IsDirty() const { return dirtyBottom > dirtyTop; }
+	void GetDirtyRows(int *top, int *bottom) const { *top = dirtyTop; *bottom = dirtyBottom; }
+	void ClearDirtyRows() { dirtyTop = dirtyBottom = 0; }
 	void BindToFrameBuffer(int w, int h);
 
 	friend class FGameTexture;
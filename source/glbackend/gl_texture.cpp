@@ -122,6 +122,42 @@ FHardwareTexture* GLInstance::CreateTrueColorTexture(FTexture* tex, int palid, b
 	return glpic;
 }
 
+//===========================================================================
+// 
+//	Upload the changed rows of a texture written to at run time.
+//	Returns false if the texture must be created anew instead.
+//
+//===========================================================================
+
+static bool RefreshTexture(FTexture* tex, FHardwareTexture* hwtex, int textype, const PalEntry* palette)
+{
+	auto siz = tex->GetSize();
+	if (hwtex->GetWidth() != siz.x || hwtex->GetHeight() != siz.y) return false;
+
+	int top, bottom;
+	hwtex->GetDirtyRows(&top, &bottom);
+	hwtex->ClearDirtyRows();
+
+	if (textype == TT_INDEXED)
+	{
+		const uint8_t* p = tex->Get8BitPixels();
+		if (!p) return false;
+		// The tile is stored in columns, so the rows need to be gathered.
+		TArray<uint8_t> rows(siz.x * (bottom - top), true);
+		FlipNonSquareBlock(rows.Data(), p + top, bottom - top, siz.x, siz.y);
+		hwtex->LoadTexturePart(rows.Data(), 0, top, siz.x, bottom - top);
+		return true;
+	}
+	if (textype == TT_TRUECOLOR)
+	{
+		if (palette == nullptr) return false;
+		auto texbuffer = tex->CreateTexBuffer(palette, CTF_ProcessData);
+		hwtex->LoadTexturePart(texbuffer.mBuffer + top * siz.x * 4, 0, top, siz.x, bottom - top);
+		return true;
+	}
+	return false;
+}
+
 //===========================================================================
 // 
 //	Retrieve the texture to be used.
@@ -132,7 +168,11 @@ FHardwareTexture* GLInstance::LoadTexture(FTexture* tex, int textype, int palid)
 {
 	if (textype == TT_INDEXED) palid = -1;
 	auto phwtex = tex->GetHardwareTexture(palid);
-	if (phwtex) return *phwtex;
+	if (phwtex)
+	{
+		if (!(*phwtex)->IsDirty() || RefreshTexture(tex, *phwtex, textype, palid < 0 ? nullptr : palmanager.GetPaletteData(palid))) return *phwtex;
+		tex->DeleteHardwareTexture(palid);
+	}
 
 	FHardwareTexture *hwtex = nullptr;
 	if (textype == TT_INDEXED)
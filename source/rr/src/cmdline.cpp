@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "baselayer.h"
 #include "cmdline.h"
 #include "m_argv.h"
+#include "timedemo.h"
 
 BEGIN_RR_NS
 
@@ -93,5 +94,12 @@ void G_CheckCommandLine()
 		}
 		OSD_Printf("Respawn on.\n");
 	}
+	if (TimeDemo_Active())
+	{
+		// -timedemo is the profiling mode of -d with either no view or one frame per gametic.
+		Demo_SetFirst(*TimeDemo_File() ? TimeDemo_File() : "1");
+		Demo_PlayFirst(TimeDemo_NoRender() ? 1 : 2, 1);
+		g_noLogo = 1;
+	}
 }
 END_RR_NS
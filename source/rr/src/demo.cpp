@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "menus.h"
 #include "savegame.h"
 #include "screens.h"
+#include "timedemo.h"
 
 BEGIN_RR_NS
 
@@ -356,6 +357,7 @@ static void Demo_GToc(double t)
 {
     g_prof.numtics++;
     g_prof.totalgamems += timerGetHiTicks()-t;
+    TimeDemo_GameTic(timerGetHiTicks()-t);
 }
 
 static void Demo_RToc(double t1, double t2)
@@ -363,6 +365,7 @@ static void Demo_RToc(double t1, double t2)
     g_prof.numframes++;
     g_prof.totalroomsdrawms += t2-t1;
     g_prof.totalrestdrawms += timerGetHiTicks()-t2;
+    TimeDemo_Frame(timerGetHiTicks()-t1);
 }
 
 static void Demo_DisplayProfStatus(void)
@@ -388,11 +391,12 @@ static void Demo_SetupProfile(void)
     g_demo_profile *= -1;  // now >0: profile for real
 
     g_demo_soundToggle = userConfig.nosound;
-	userConfig.nosound = true;  // restored by Demo_FinishProfile()
+	userConfig.nosound = !*TimeDemo_WavFile();  // restored by Demo_FinishProfile()
 
     Bmemset(&g_prof, 0, sizeof(g_prof));
 
     g_prof.starthiticks = timerGetHiTicks();
+    TimeDemo_Start(REALGAMETICSPERSEC);
 }
 
 static void Demo_FinishProfile(void)
@@ -429,6 +433,10 @@ static void Demo_FinishProfile(void)
                 OSD_Printf("== demo %d: non-profiled time overhead: %.02f %%\n",
                            dn, 100.0*totalms/totalprofms - 100.0);
         }
+
+        // -timedemo runs exactly one demo and reports through the common code.
+        if (TimeDemo_Active())
+            TimeDemo_Finish();
     }
 
     g_demo_profile = 0;
@@ -38,6 +38,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "menu/menu.h"
 #include "stringtable.h"
 #include "mapinfo.h"
+#include "i_specialpaths.h"
+#include "version.h"
 
 BEGIN_RR_NS
 
@@ -953,6 +955,110 @@ static int32_t C_CheckEmptyBranch(int32_t tw, intptr_t lastScriptPtr)
     return 0;
 }
 
+// Compiled script cache.
+//
+// Compiling a large mod takes a noticeable amount of time on every launch, so the result of a
+// successful compile is written to disk and loaded directly on the next run as long as every CON
+// source that went into it is unchanged. Besides the script image, the labels, events and tile data,
+// the compiler has side effects on other subsystems (gamevars, sounds, quotes, level names...).
+// These are recorded in order while compiling and replayed when a cached script gets loaded.
+
+#define CON_CACHE_MAGIC "RRCC"
+#define CON_CACHE_VERSION 1
+
+enum concacheop_t
+{
+    CCOP_NEWVAR,
+    CCOP_MUSIC,
+    CCOP_VOLUMENAME,
+    CCOP_SKILLNAME,
+    CCOP_LEVELNAME,
+    CCOP_LEVELTITLE,
+    CCOP_QUOTE,
+    CCOP_SOUND,
+    CCOP_GAMESTARTUP,
+    CCOP_NUMOPS
+};
+
+// number of integer arguments each recorded operation carries
+static int8_t const g_conCacheOpArgs[CCOP_NUMOPS] = {
+    2, 2, 1, 1, 4, 2, 1, 6, 34
+};
+
+struct concacherecord_t
+{
+    int32_t         op;
+    TArray<int32_t> args;
+    FString         text;
+};
+
+struct concachesource_t
+{
+    FString  fileName;
+    int32_t  length;
+    uint32_t crc;
+};
+
+static TArray<concacherecord_t> g_conCacheRecords;
+static TArray<concachesource_t> g_conCacheSources;
+
+static void C_CacheRecord(int32_t op, int32_t const *args, int numArgs, char const *text = nullptr)
+{
+    concacherecord_t rec;
+
+    rec.op = op;
+    rec.args.Resize(numArgs);
+    Bmemcpy(rec.args.Data(), args, numArgs * sizeof(int32_t));
+    rec.text = text;
+
+    g_conCacheRecords.Push(rec);
+}
+
+static inline void C_CacheRecord(int32_t op, std::initializer_list<int32_t> args, char const *text = nullptr)
+{
+    C_CacheRecord(op, args.begin(), (int)args.size(), text);
+}
+
+static void C_CacheAddSource(char const *fileName, char const *data, int32_t length)
+{
+    g_conCacheSources.Push({ fileName, length, Bcrc32(data, length, 0) });
+}
+
+static FString C_CacheFileName(char const *fileName)
+{
+    FStringf key("%s:%d", fileName, g_gameType);
+    return FStringf("%s/concache_%08x.bin", M_GetAppDataPath(true).GetChars(), Bcrc32(key.GetChars(), key.Len(), 0));
+}
+
+// Identifies the build that wrote a cache file. Bytecode layout is not stable across builds.
+static FString C_CacheBuildStamp(void)
+{
+    return FStringf("%s %s %s %d", GetGitHash(), __DATE__, __TIME__, (int)sizeof(intptr_t));
+}
+
+static void C_CacheWriteInt(FileWriter *fw, int32_t value) { fw->Write(&value, sizeof(value)); }
+
+static void C_CacheWriteString(FileWriter *fw, char const *str)
+{
+    int32_t const len = Bstrlen(str);
+    C_CacheWriteInt(fw, len);
+    fw->Write(str, len);
+}
+
+static bool C_CacheReadString(FileReader &fr, FString &str)
+{
+    int32_t const len = fr.ReadInt32();
+
+    if ((unsigned)len > 65536)
+        return false;
+
+    char *buffer = str.LockNewBuffer(len);
+    bool const ok = fr.Read(buffer, len) == len;
+    buffer[len] = 0;
+    str.UnlockBuffer();
+    return ok;
+}
+
 static void C_Include(const char *confile)
 {
 	auto fp = fileSystem.OpenFileReader(confile,0);
@@ -973,6 +1079,7 @@ static void C_Include(const char *confile)
     fp.Read(mptr, j);
     fp.Close();
     g_scriptcrc = Bcrc32(mptr, j, g_scriptcrc);
+    C_CacheAddSource(confile, mptr, j);
     mptr[j] = 0;
 
     if (*textptr == '"') // skip past the closing quote if it's there so we don't screw up the next line
@@ -1071,6 +1178,28 @@ void C_DefineVolumeFlags(int32_t vol, int32_t flags)
     gVolumeFlags[vol] = flags;
 }
 
+void C_DefineVolumeName(int32_t vol, const char *name)
+{
+    Bassert((unsigned)vol < MAXVOLUMES);
+
+    gVolumeNames[vol] = name;
+    g_volumeCnt = vol+1;
+}
+
+void C_DefineSkillName(int32_t skill, const char *name)
+{
+    Bassert((unsigned)skill < MAXSKILLS);
+
+    gSkillNames[skill] = name;
+
+    int i;
+    for (i=0; i<MAXSKILLS; i++)
+        if (gSkillNames[i].IsEmpty())
+            break;
+
+    g_skillCnt = i;
+}
+
 int32_t C_AllocQuote(int32_t qnum)
 {
     Bassert((unsigned)qnum < MAXQUOTES);
@@ -1282,6 +1411,7 @@ static int32_t C_ParseCommand(int32_t loop)
                 }
             }
 
+            C_CacheRecord(CCOP_NEWVAR, { defaultValue, varFlags }, LAST_LABEL);
             Gv_NewVar(LAST_LABEL, defaultValue, varFlags);
             continue;
         }
@@ -1436,6 +1566,7 @@ static int32_t C_ParseCommand(int32_t loop)
                     }
                     tempbuf[j+1] = '\0';
 
+                    C_CacheRecord(CCOP_MUSIC, { k, i }, tempbuf);
                     C_DefineMusic(k, i, tempbuf);
 
                     textptr += j;
@@ -2216,9 +2347,12 @@ ifvar:
             }
 
 			i = strcspn(textptr, "\r\n");
-			gVolumeNames[j] = FStringTable::MakeMacro(textptr, i);
+			{
+				FString const volumeName = FStringTable::MakeMacro(textptr, i);
+				C_CacheRecord(CCOP_VOLUMENAME, { j }, volumeName);
+				C_DefineVolumeName(j, volumeName);
+			}
 			textptr+=i;
-            g_volumeCnt = j+1;
             continue;
 
         case CON_DEFINESKILLNAME:
@@ -2240,14 +2374,12 @@ ifvar:
             }
 
 			i = strcspn(textptr, "\r\n");
-			gSkillNames[j] = FStringTable::MakeMacro(textptr, i);
+			{
+				FString const skillName = FStringTable::MakeMacro(textptr, i);
+				C_CacheRecord(CCOP_SKILLNAME, { j }, skillName);
+				C_DefineSkillName(j, skillName);
+			}
 			textptr+=i;
-
-            for (i=0; i<MAXSKILLS; i++)
-                if (gSkillNames[i].IsEmpty())
-                    break;
-            g_skillCnt = i;
-
             continue;
 
         case CON_DEFINELEVELNAME:
@@ -2338,6 +2470,10 @@ ifvar:
 
 			mapList[j *MAXLEVELS+k].name = tempbuf;
 
+            C_CacheRecord(CCOP_LEVELNAME, { j, k, mapList[j * MAXLEVELS + k].parTime, mapList[j * MAXLEVELS + k].designerTime },
+                          mapList[j * MAXLEVELS + k].fileName);
+            C_CacheRecord(CCOP_LEVELTITLE, { j, k }, tempbuf);
+
             continue;
 
         case CON_DEFINEQUOTE:
@@ -2371,6 +2507,7 @@ ifvar:
 				textptr++;
 			}
 			buffer.Push(0);
+			C_CacheRecord(CCOP_QUOTE, { k }, buffer.Data());
 			quoteMgr.InitializeQuote(k, buffer.Data(), true);
 			continue;
 		}
@@ -2433,6 +2570,7 @@ ifvar:
             vo = g_scriptPtr[-1];
             g_scriptPtr -= 5;
 
+            C_CacheRecord(CCOP_SOUND, { k, ps, pe, pr, m, vo }, buffer.Data());
             int res = S_DefineSound(k, buffer.Data(), ps, pe, pr, m, vo, 1.f);
 
             continue;
@@ -2589,6 +2727,7 @@ ifvar:
                 TRIPBOMBLASERMODE
                 */
 
+                C_CacheRecord(CCOP_GAMESTARTUP, params, ARRAY_SIZE(params));
                 G_DoGameStartup(params);
             }
             continue;
@@ -2634,6 +2773,330 @@ void C_PrintStats(void)
     initprintf("\n");
 }
 
+static void C_WriteCachedScript(char const *fileName)
+{
+    if (!con_cache || g_errorCnt)
+        return;
+
+    FString const cacheName = C_CacheFileName(fileName);
+    FileWriter *fw = FileWriter::Open(cacheName);
+
+    if (!fw)
+        return;
+
+    fw->Write(CON_CACHE_MAGIC, 4);
+    C_CacheWriteInt(fw, CON_CACHE_VERSION);
+    C_CacheWriteString(fw, C_CacheBuildStamp());
+    C_CacheWriteInt(fw, g_gameType);
+
+    C_CacheWriteInt(fw, g_conCacheSources.Size());
+    for (auto &src : g_conCacheSources)
+    {
+        C_CacheWriteString(fw, src.fileName);
+        C_CacheWriteInt(fw, src.length);
+        C_CacheWriteInt(fw, src.crc);
+    }
+
+    C_CacheWriteInt(fw, g_scriptcrc);
+    C_CacheWriteInt(fw, g_scriptVersion);
+    C_CacheWriteInt(fw, g_totalLines);
+    C_CacheWriteInt(fw, g_warningCnt);
+
+    // pointers inside the script are stored as offsets, the same way C_SetScriptSize() relocates them
+    C_CacheWriteInt(fw, g_scriptSize);
+    C_CacheWriteInt(fw, g_scriptPtr - apScript);
+
+    TArray<intptr_t> script(g_scriptSize, true);
+    Bmemcpy(script.Data(), apScript, g_scriptSize * sizeof(intptr_t));
+
+    for (int i = 0; i < g_scriptSize; ++i)
+        if (BITPTR_IS_POINTER(i))
+            script[i] -= (intptr_t)apScript;
+
+    fw->Write(script.Data(), g_scriptSize * sizeof(intptr_t));
+    fw->Write(bitptr, ((g_scriptSize + 7) >> 3) + 1);
+    fw->Write(apScriptEvents, sizeof(apScriptEvents));
+
+    int32_t numTiles = 0;
+    for (auto &tile : g_tile)
+        if (tile.execPtr || tile.loadPtr || tile.flags || tile.cacherange)
+            numTiles++;
+
+    C_CacheWriteInt(fw, numTiles);
+    for (int i = 0; i < MAXTILES; i++)
+    {
+        auto const &tile = g_tile[i];
+
+        if (!(tile.execPtr || tile.loadPtr || tile.flags || tile.cacherange))
+            continue;
+
+        C_CacheWriteInt(fw, i);
+        C_CacheWriteInt(fw, tile.execPtr ? tile.execPtr - apScript : 0);
+        C_CacheWriteInt(fw, tile.loadPtr ? tile.loadPtr - apScript : 0);
+        C_CacheWriteInt(fw, tile.flags);
+        C_CacheWriteInt(fw, tile.cacherange);
+    }
+
+    C_CacheWriteInt(fw, g_labelCnt);
+    fw->Write(label, g_labelCnt << 6);
+    fw->Write(labelcode, g_labelCnt * sizeof(int32_t));
+    fw->Write(labeltype, g_labelCnt * sizeof(int32_t));
+
+    C_CacheWriteInt(fw, g_conCacheRecords.Size());
+    for (auto &rec : g_conCacheRecords)
+    {
+        C_CacheWriteInt(fw, rec.op);
+        fw->Write(rec.args.Data(), rec.args.Size() * sizeof(int32_t));
+        C_CacheWriteString(fw, rec.text);
+    }
+
+    fw->Write(CON_CACHE_MAGIC, 4);
+    delete fw;
+}
+
+static void C_CacheReplay(concacherecord_t const &rec)
+{
+    auto const args = rec.args.Data();
+    auto const text = rec.text.GetChars();
+
+    switch (rec.op)
+    {
+        case CCOP_NEWVAR:      Gv_NewVar(text, args[0], args[1]); break;
+        case CCOP_MUSIC:       C_DefineMusic(args[0], args[1], text); break;
+        case CCOP_VOLUMENAME:  C_DefineVolumeName(args[0], text); break;
+        case CCOP_SKILLNAME:   C_DefineSkillName(args[0], text); break;
+
+        case CCOP_LEVELNAME:
+        {
+            auto &gmap = mapList[args[0] * MAXLEVELS + args[1]];
+            gmap.SetFileName(text);
+            gmap.parTime      = args[2];
+            gmap.designerTime = args[3];
+            break;
+        }
+
+        case CCOP_LEVELTITLE:  mapList[args[0] * MAXLEVELS + args[1]].name = text; break;
+        case CCOP_QUOTE:       quoteMgr.InitializeQuote(args[0], text, true); break;
+        case CCOP_SOUND:       S_DefineSound(args[0], text, args[1], args[2], args[3], args[4], args[5], 1.f); break;
+        case CCOP_GAMESTARTUP: G_DoGameStartup(args); break;
+    }
+}
+
+// Returns true if a valid cache for fileName was found and loaded. Nothing gets
+// modified unless the entire file has been read and validated.
+static bool C_LoadCachedScript(char const *fileName)
+{
+    if (!con_cache)
+        return false;
+
+    FileReader fr;
+
+    if (!fr.OpenFile(C_CacheFileName(fileName)))
+        return false;
+
+    char magic[4];
+    FString str;
+
+    if (fr.Read(magic, 4) != 4 || Bmemcmp(magic, CON_CACHE_MAGIC, 4) || fr.ReadInt32() != CON_CACHE_VERSION)
+        return false;
+
+    if (!C_CacheReadString(fr, str) || str.Compare(C_CacheBuildStamp()) || fr.ReadInt32() != (int32_t)g_gameType)
+        return false;
+
+    // Every file that went into the compile must still be exactly the same. The first
+    // entries are the main CON file and the ones added on the command line, in order.
+    TArray<FString> roots;
+    roots.Push(fileName);
+
+    if (userConfig.AddCons)
+        for (FString &m : *userConfig.AddCons.get())
+            roots.Push(m);
+
+    int32_t const numSources = fr.ReadInt32();
+
+    if ((unsigned)numSources > 65536 || (unsigned)numSources < roots.Size())
+        return false;
+
+    TArray<concachesource_t> sources;
+    unsigned nextRoot = 0;
+
+    for (int i = 0; i < numSources; i++)
+    {
+        concachesource_t src;
+
+        if (!C_CacheReadString(fr, src.fileName))
+            return false;
+
+        src.length = fr.ReadInt32();
+        src.crc    = fr.ReadUInt32();
+
+        if (nextRoot < roots.Size() && !src.fileName.CompareNoCase(roots[nextRoot]))
+            nextRoot++;
+
+        auto kFile = fileSystem.OpenFileReader(src.fileName, 0);
+
+        if (!kFile.isOpen() || kFile.GetLength() != src.length)
+            return false;
+
+        auto const data = kFile.Read();
+
+        if (Bcrc32(data.Data(), src.length, 0) != src.crc)
+            return false;
+
+        sources.Push(src);
+    }
+
+    if (nextRoot != roots.Size() || sources[0].fileName.CompareNoCase(fileName))
+        return false;
+
+    userConfig.AddCons.reset();
+
+    uint32_t const scriptCrc     = fr.ReadUInt32();
+    int32_t const  scriptVersion = fr.ReadInt32();
+    int32_t const  totalLines    = fr.ReadInt32();
+    int32_t const  numWarnings   = fr.ReadInt32();
+    int32_t const  scriptSize    = fr.ReadInt32();
+    int32_t const  scriptLength  = fr.ReadInt32();
+
+    if (scriptSize <= 0 || scriptSize > (1 << 26) || (unsigned)scriptLength > (unsigned)scriptSize)
+        return false;
+
+    size_t const bitmapSize = ((scriptSize + 7) >> 3) + 1;
+
+    TArray<intptr_t> script(scriptSize, true);
+    TArray<uint8_t>  bitmap(bitmapSize, true);
+    intptr_t         events[MAXEVENTS];
+
+    if (fr.Read(script.Data(), scriptSize * sizeof(intptr_t)) != (FileReader::Size)(scriptSize * sizeof(intptr_t))
+        || fr.Read(bitmap.Data(), bitmapSize) != (FileReader::Size)bitmapSize
+        || fr.Read(events, sizeof(events)) != sizeof(events))
+        return false;
+
+    int32_t const numTiles = fr.ReadInt32();
+
+    if ((unsigned)numTiles > MAXTILES)
+        return false;
+
+    TArray<int32_t> tiles(numTiles * 5, true);
+
+    if (fr.Read(tiles.Data(), numTiles * 5 * sizeof(int32_t)) != (FileReader::Size)(numTiles * 5 * sizeof(int32_t)))
+        return false;
+
+    for (int i = 0; i < numTiles; i++)
+    {
+        if ((unsigned)tiles[i * 5] >= MAXTILES || (unsigned)tiles[i * 5 + 1] >= (unsigned)scriptSize || (unsigned)tiles[i * 5 + 2] >= (unsigned)scriptSize)
+            return false;
+    }
+
+    int32_t const labelCnt = fr.ReadInt32();
+
+    if ((unsigned)labelCnt > MAXSPRITES * sizeof(spritetype) / 64)
+        return false;
+
+    TArray<char>    labels(labelCnt << 6, true);
+    TArray<int32_t> labelCodes(labelCnt, true);
+    TArray<int32_t> labelTypes(labelCnt, true);
+
+    if (fr.Read(labels.Data(), labelCnt << 6) != labelCnt << 6
+        || fr.Read(labelCodes.Data(), labelCnt * sizeof(int32_t)) != (FileReader::Size)(labelCnt * sizeof(int32_t))
+        || fr.Read(labelTypes.Data(), labelCnt * sizeof(int32_t)) != (FileReader::Size)(labelCnt * sizeof(int32_t)))
+        return false;
+
+    int32_t const numRecords = fr.ReadInt32();
+
+    if ((unsigned)numRecords > (1 << 24))
+        return false;
+
+    TArray<concacherecord_t> records;
+    records.Resize(numRecords);
+
+    for (auto &rec : records)
+    {
+        rec.op = fr.ReadInt32();
+
+        if ((unsigned)rec.op >= CCOP_NUMOPS)
+            return false;
+
+        int const numArgs = g_conCacheOpArgs[rec.op];
+        rec.args.Resize(numArgs);
+
+        if (fr.Read(rec.args.Data(), numArgs * sizeof(int32_t)) != (FileReader::Size)(numArgs * sizeof(int32_t)) || !C_CacheReadString(fr, rec.text))
+            return false;
+    }
+
+    if (fr.Read(magic, 4) != 4 || Bmemcmp(magic, CON_CACHE_MAGIC, 4))
+        return false;
+
+    // everything checks out, commit the cached compile
+    Xfree(apScript);
+    Xfree(bitptr);
+
+    g_scriptSize = scriptSize;
+    apScript     = (intptr_t *)Xmalloc(scriptSize * sizeof(intptr_t));
+    bitptr       = (char *)Xmalloc(bitmapSize);
+    g_scriptPtr  = apScript + scriptLength;
+
+    Bmemcpy(bitptr, bitmap.Data(), bitmapSize);
+    Bmemcpy(apScript, script.Data(), scriptSize * sizeof(intptr_t));
+
+    for (int i = 0; i < g_scriptSize; ++i)
+        if (BITPTR_IS_POINTER(i))
+            apScript[i] += (intptr_t)apScript;
+
+    Bmemcpy(apScriptEvents, events, sizeof(events));
+
+    for (int i = 0; i < numTiles; i++)
+    {
+        auto &tile = g_tile[tiles[i * 5]];
+
+        tile.execPtr    = tiles[i * 5 + 1] ? apScript + tiles[i * 5 + 1] : NULL;
+        tile.loadPtr    = tiles[i * 5 + 2] ? apScript + tiles[i * 5 + 2] : NULL;
+        tile.flags      = tiles[i * 5 + 3];
+        tile.cacherange = tiles[i * 5 + 4];
+    }
+
+    g_labelCnt = labelCnt;
+    Bmemcpy(label, labels.Data(), labelCnt << 6);
+    Bmemcpy(labelcode, labelCodes.Data(), labelCnt * sizeof(int32_t));
+    Bmemcpy(labeltype, labelTypes.Data(), labelCnt * sizeof(int32_t));
+
+    for (auto &rec : records)
+        C_CacheReplay(rec);
+
+    g_scriptcrc     = scriptCrc;
+    g_scriptVersion = scriptVersion;
+    g_totalLines    = totalLines;
+    g_errorCnt      = 0;
+    g_warningCnt    = 0;
+
+    Bstrcpy(g_scriptFileName, fileName);
+
+    for (auto &src : sources)
+        initprintf("Using cached: %s (%d bytes)\n", src.fileName.GetChars(), src.length);
+
+    if (numWarnings)
+        initprintf("Note: %d warning(s) were found when this script was compiled. Set con_cache to 0 to see them.\n", numWarnings);
+
+    return true;
+}
+
+static void C_FinishCompile(void)
+{
+    for (auto *i : tables_free)
+        hash_free(i);
+
+    //freehashnames();
+    freesoundhashnames();
+
+    if (g_scriptDebug)
+        C_PrintStats();
+
+    C_InitQuotes();
+
+    g_conCacheRecords.Reset();
+    g_conCacheSources.Reset();
+}
+
 void C_Compile(const char *fileName)
 {
     Bmemset(apScriptEvents, 0, sizeof(apScriptEvents));
@@ -2648,6 +3111,18 @@ void C_Compile(const char *fileName)
     C_InitHashes();
     Gv_Init();
 
+    g_conCacheRecords.Clear();
+    g_conCacheSources.Clear();
+
+    uint32_t const startcompiletime = timerGetTicks();
+
+    if (C_LoadCachedScript(fileName))
+    {
+        initprintf("Script loaded from cache in %dms%s\n", timerGetTicks() - startcompiletime, C_ScriptVersionString(g_scriptVersion));
+        C_FinishCompile();
+        return;
+    }
+
     auto kFile = fileSystem.OpenFileReader(fileName,0);
 
 	if (!kFile.isOpen())
@@ -2662,8 +3137,6 @@ void C_Compile(const char *fileName)
 
     initprintf("Compiling: %s (%d bytes)\n", fileName, kFileLen);
 
-    uint32_t const startcompiletime = timerGetTicks();
-
     char * mptr = (char *)Xmalloc(kFileLen+1);
     mptr[kFileLen] = 0;
 
@@ -2673,6 +3146,7 @@ void C_Compile(const char *fileName)
 
     g_scriptcrc = Bcrc32(NULL, 0, 0L);
     g_scriptcrc = Bcrc32(textptr, kFileLen, g_scriptcrc);
+    C_CacheAddSource(fileName, textptr, kFileLen);
 
     Xfree(apScript);
 
@@ -2721,16 +3195,8 @@ void C_Compile(const char *fileName)
     initprintf("Script compiled in %dms, %ld bytes%s\n", timerGetTicks() - startcompiletime,
                 (unsigned long)(g_scriptPtr-apScript), C_ScriptVersionString(g_scriptVersion));
 
-    for (auto *i : tables_free)
-        hash_free(i);
-
-    //freehashnames();
-    freesoundhashnames();
-
-    if (g_scriptDebug)
-        C_PrintStats();
-
-    C_InitQuotes();
+    C_WriteCachedScript(fileName);
+    C_FinishCompile();
 }
 
 void C_ReportError(int32_t iError)
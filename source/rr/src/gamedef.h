@@ -142,6 +142,8 @@ void G_DoGameStartup(const int32_t *params);
 void C_DefineMusic(int volumeNum, int levelNum, const char *fileName);
 
 void C_DefineVolumeFlags(int32_t vol, int32_t flags);
+void C_DefineVolumeName(int32_t vol, const char *name);
+void C_DefineSkillName(int32_t skill, const char *name);
 void C_UndefineVolume(int32_t vol);
 void C_UndefineSkill(int32_t skill);
 void C_UndefineLevel(int32_t vol, int32_t lev);
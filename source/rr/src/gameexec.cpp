@@ -174,11 +174,16 @@ static FORCE_INLINE int32_t VM_EventInlineInternal__(int const eventNum, int con
     if ((unsigned)playerNum >= (unsigned)g_mostConcurrentPlayers)
         vm.pPlayer = g_player[0].ps;
 
+    // display events run while the interpolated view is up; they have to change the real map
+    SuspendInterpolatedView();
+
     VM_Execute(true);
 
     if (vm.flags & VM_KILL)
         VM_DeleteSprite(vm.spriteNum, vm.playerNum);
 
+    ResumeInterpolatedView();
+
     // restoring these needs to happen after VM_DeleteSprite() due to event recursion
     returnValue = globalReturn;
 
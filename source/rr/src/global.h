@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "build.h"
 #include "compat.h"
 #include "duke3d.h"
+#include "interpolate.h"
 #include "mmulti.h"
 #include "quotes.h"
 #include "sector.h"
@@ -45,18 +46,9 @@ BEGIN_RR_NS
     #define G_EXTERN extern
 #endif
 
-#define MAXINTERPOLATIONS MAXSPRITES
-// KEEPINSYNC lunatic/con_lang.lua
-
 // duke3d global soup :(
 
 
-G_EXTERN int32_t g_interpolationCnt;
-G_EXTERN int32_t g_interpolationLock;
-G_EXTERN int32_t oldipos[MAXINTERPOLATIONS];
-G_EXTERN int32_t *curipos[MAXINTERPOLATIONS];
-G_EXTERN int32_t bakipos[MAXINTERPOLATIONS];
-
 
 G_EXTERN int32_t duke3d_globalflags;
 
@@ -292,17 +284,12 @@ EXTERN_INLINE_HEADER void G_RestoreInterpolations(void);
 
 EXTERN_INLINE void G_UpdateInterpolations(void)  //Stick at beginning of G_DoMoveThings
 {
-    for (bssize_t i=g_interpolationCnt-1; i>=0; i--) oldipos[i] = *curipos[i];
+    UpdateInterpolations();
 }
 
 EXTERN_INLINE void G_RestoreInterpolations(void)  //Stick at end of drawscreen
 {
-    int32_t i=g_interpolationCnt-1;
-
-    if (--g_interpolationLock)
-        return;
-
-    for (; i>=0; i--) *curipos[i] = bakipos[i];
+    EndInterpolatedView();
 }
 
 #endif
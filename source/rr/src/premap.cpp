@@ -1155,7 +1155,7 @@ static void resetprestat(int playerNum, int gameMode)
     tempwallptr        = 0;
     g_curViewscreen    = -1;
     g_earthquakeTime   = 0;
-    g_interpolationCnt = 0;
+    ClearInterpolations();
 
     if (RRRA)
     {
@@ -2474,7 +2474,6 @@ int G_EnterLevel(int gameMode)
 
     G_ClearFIFO();
 
-    for (i=g_interpolationCnt-1; i>=0; i--) bakipos[i] = *curipos[i];
 
     g_player[myconnectindex].ps->over_shoulder_on = 0;
 
@@ -98,7 +98,7 @@ void G_ResetInterpolations(void)
 {
     int32_t k, i;
 
-    g_interpolationCnt = 0;
+    ClearInterpolations();
 
     k = headspritestat[STAT_EFFECTOR];
     while (k >= 0)
@@ -132,7 +132,6 @@ void G_ResetInterpolations(void)
         k = nextspritestat[k];
     }
 
-    for (i=g_interpolationCnt-1; i>=0; i--) bakipos[i] = *curipos[i];
     for (i = g_animateCnt-1; i>=0; i--)
         G_SetInterpolation(g_animatePtr[i]);
 }
@@ -38,6 +38,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 
 #include "mytypes.h"
 #include "gamecontrol.h"
+#include "timedemo.h"
 #include "demo.h"
 
 #include "player.h"
@@ -403,10 +404,15 @@ DemoPlayBack(void)
     ready2send = 0;
     DemoDone = FALSE;
 
+    // -timedemo runs one tic per pass without waiting for the clock
+    SWBOOL const TimeDemo = TimeDemo_Active();
+    if (TimeDemo)
+        TimeDemo_Start(120 / synctics);
+
     while (TRUE)
     {
         // makes code run at the same rate
-        while (totalclock > totalsynctics)
+        while (TimeDemo || totalclock > totalsynctics)
         {
             handleevents();
 
@@ -437,7 +443,9 @@ DemoPlayBack(void)
 
             CONTROL_GetInput(&info);
 
+            double const t = timerGetHiTicks();
             domovethings();
+            TimeDemo_GameTic(timerGetHiTicks() - t);
 
             // fast forward and slow mo
             if (DemoEdit)
@@ -472,6 +480,9 @@ DemoPlayBack(void)
                 demosync_record();
             if (DemoSyncTest)
                 demosync_test(cnt);
+
+            if (TimeDemo)
+                break;
         }
 
         // Put this back in later when keyboard stuff is stable
@@ -511,7 +522,11 @@ DemoPlayBack(void)
 
         // demo is over
         if (DemoDone)
+        {
+            if (TimeDemo)
+                TimeDemo_Finish();
             break;
+        }
 
         if (QuitFlag)
         {
@@ -531,7 +546,14 @@ DemoPlayBack(void)
             break;
         }
 
-        drawscreen(Player + screenpeek);
+        if (!TimeDemo)
+            drawscreen(Player + screenpeek);
+        else if (!TimeDemo_NoRender())
+        {
+            double const t = timerGetHiTicks();
+            drawscreen(Player + screenpeek);
+            TimeDemo_Frame(timerGetHiTicks() - t);
+        }
     }
 
     // only exit if conditions are write
@@ -1997,8 +1997,7 @@ drawscreen(PLAYERp pp)
 
     if (!ScreenSavePic)
     {
-        dointerpolations(smoothratio);                      // Stick at beginning of drawscreen
-        short_dointerpolations(smoothratio);                      // Stick at beginning of drawscreen
+        BeginInterpolatedView(smoothratio);                 // Stick at beginning of drawscreen
     }
 
     // TENSW: when rendering with prediction, the only thing that counts should
@@ -2268,8 +2267,7 @@ drawscreen(PLAYERp pp)
     // certain input is done here - probably shouldn't be
     DrawCheckKeys(pp);
 
-    restoreinterpolations();                 // Stick at end of drawscreen
-    short_restoreinterpolations();                 // Stick at end of drawscreen
+    EndInterpolatedView();                   // Stick at end of drawscreen
 
     PostDraw();
 
@@ -58,6 +58,7 @@ Things required to make savegames work:
 #include "weapon.h"
 #include "player.h"
 #include "lists.h"
+#include "interp.h"
 #include "network.h"
 #include "pal.h"
 
@@ -101,6 +102,7 @@ Things required to make savegames work:
 #include "secrets.h"
 
 #include "osdcmds.h"
+#include "timedemo.h"
 
 //#include "crc32.h"
 
@@ -140,7 +142,7 @@ SWBOOL Global_PLock = FALSE;
 #endif
 
 // 12 was original source release. For future releases increment by two.
-int GameVersion = 15;
+int GameVersion = 16;
 
 char DemoText[3][64];
 int DemoTextYstart = 0;
@@ -971,6 +973,7 @@ void InitLevelGlobals2(void)
     // GLOBAL RESETS NOT DONE for LOAD GAME
     // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
     InitTimingVars();
+    ClearInterpolations();
     TotalKillable = 0;
     Bunny_Count = 0;
 }
@@ -1669,6 +1672,20 @@ void MenuLevel(void)
 
     M_StartControlPanel(false);
     M_SetMenu(NAME_MainMenu);
+
+    if (TimeDemo_Active())
+    {
+        // -timedemo plays the given demo, or the first one of the demo loop, and nothing else
+        if (*TimeDemo_File())
+            strncpy(DemoName[0], TimeDemo_File(), sizeof(DemoName[0]) - 1);
+        else if (DemoName[0][0] == '\0')
+            strcpy(DemoName[0], "demo.dmo");
+        DemoName[1][0] = '\0';
+        DemoMode = TRUE;
+        DemoPlaying = TRUE;
+        return;
+    }
+
     // do demos only if not playing multi play
     if (!CommEnabled && numplayers <= 1 && !FinishAnim && !NoDemoStartup)
     {
@@ -2186,12 +2186,6 @@ void FAFgetzrangepoint(int32_t x, int32_t y, int32_t z, int16_t sectnum,
 void COVERupdatesector(int32_t x, int32_t y, int16_t* newsector);
 
 
-void short_setinterpolation(short *posptr);
-void short_stopinterpolation(short *posptr);
-void short_updateinterpolations(void);
-void short_dointerpolations(int smoothratio);
-void short_restoreinterpolations(void);
-
 enum SoundType
 {
     SOUND_OBJECT_TYPE,
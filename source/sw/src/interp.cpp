@@ -27,88 +27,18 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 #include "ns.h"
 
 #include "compat.h"
-#include "pragmas.h"
 
 #include "interp.h"
 
 BEGIN_SW_NS
 
-#define MAXINTERPOLATIONS 1024
-int numinterpolations = 0, startofdynamicinterpolations = 0;
-int oldipos[MAXINTERPOLATIONS];
-int bakipos[MAXINTERPOLATIONS];
-int *curipos[MAXINTERPOLATIONS];
-
 void setinterpolation(int *posptr)
 {
-    int i;
-
-    if (numinterpolations >= MAXINTERPOLATIONS)
-        return;
-
-    for (i = numinterpolations - 1; i >= 0; i--)
-    {
-        if (curipos[i] == posptr)
-            return;
-    }
-
-    curipos[numinterpolations] = posptr;
-    oldipos[numinterpolations] = *posptr;
-    numinterpolations++;
+    StartInterpolation(posptr);
 }
 
 void stopinterpolation(int *posptr)
 {
-    int i;
-
-    for (i = numinterpolations - 1; i >= startofdynamicinterpolations; i--)
-    {
-        if (curipos[i] == posptr)
-        {
-            numinterpolations--;
-            oldipos[i] = oldipos[numinterpolations];
-            bakipos[i] = bakipos[numinterpolations];
-            curipos[i] = curipos[numinterpolations];
-        }
-    }
-}
-
-void updateinterpolations(void)                  // Stick at beginning of domovethings
-{
-    int i;
-
-    for (i = numinterpolations - 1; i >= 0; i--)
-        oldipos[i] = *curipos[i];
-}
-
-// must call restore for every do interpolations
-// make sure you don't exit
-void dointerpolations(int smoothratio)                      // Stick at beginning of drawscreen
-{
-    int i, j, odelta, ndelta;
-
-    ndelta = 0;
-    j = 0;
-
-    for (i = numinterpolations - 1; i >= 0; i--)
-    {
-        bakipos[i] = *curipos[i];
-
-        odelta = ndelta;
-        ndelta = (*curipos[i]) - oldipos[i];
-
-        if (odelta != ndelta)
-            j = mulscale16(ndelta, smoothratio);
-
-        *curipos[i] = oldipos[i] + j;
-    }
-}
-
-void restoreinterpolations(void)                 // Stick at end of drawscreen
-{
-    int i;
-
-    for (i = numinterpolations - 1; i >= 0; i--)
-        *curipos[i] = bakipos[i];
+    StopInterpolation(posptr);
 }
 END_SW_NS
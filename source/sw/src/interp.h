@@ -23,23 +23,12 @@ Original Source: 1997 - Frank Maddin and Jim Norwood
 Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 */
 //-------------------------------------------------------------------------
-BEGIN_SW_NS
-
-#define SHORT_MAXINTERPOLATIONS 256
-extern short short_numinterpolations, short_startofdynamicinterpolations;
-extern short short_oldipos[SHORT_MAXINTERPOLATIONS];
-extern short short_bakipos[SHORT_MAXINTERPOLATIONS];
-extern short *short_curipos[SHORT_MAXINTERPOLATIONS];
+#include "interpolate.h"
 
-#define MAXINTERPOLATIONS 1024
-extern int numinterpolations, startofdynamicinterpolations;
-extern int oldipos[MAXINTERPOLATIONS];
-extern int bakipos[MAXINTERPOLATIONS];
-extern int *curipos[MAXINTERPOLATIONS];
+BEGIN_SW_NS
 
+// The moving parts of the map are drawn in between tics by the common
+// interpolation code. These take the form of the pointers the game keeps.
 void setinterpolation(int *posptr);
 void stopinterpolation(int *posptr);
-void updateinterpolations(void);
-void dointerpolations(int smoothratio);
-void restoreinterpolations(void);
 END_SW_NS
@@ -7554,8 +7554,7 @@ domovethings(void)
 
     totalsynctics += synctics;
 
-    updateinterpolations();                  // Stick at beginning of domovethings
-    short_updateinterpolations();            // Stick at beginning of domovethings
+    UpdateInterpolations();                  // Stick at beginning of domovethings
     MoveSkipSavePos();
 
 #if 0
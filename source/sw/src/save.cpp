@@ -592,27 +592,8 @@ bool GameInterface::SaveGame(FSaveGameNode *sv)
     MWRITE(&MoveSkip4,sizeof(MoveSkip4),1,fil);
     MWRITE(&MoveSkip8,sizeof(MoveSkip8),1,fil);
 
-    // long interpolations
-    MWRITE(&numinterpolations,sizeof(numinterpolations),1,fil);
-    MWRITE(&startofdynamicinterpolations,sizeof(startofdynamicinterpolations),1,fil);
-    MWRITE(oldipos,sizeof(oldipos),1,fil);
-    MWRITE(bakipos,sizeof(bakipos),1,fil);
-    for (i = numinterpolations - 1; i >= 0; i--)
-    {
-        saveisshot |= SaveSymDataInfo(fil, curipos[i]);
-        assert(!saveisshot);
-    }
-
-    // short interpolations
-    MWRITE(&short_numinterpolations,sizeof(short_numinterpolations),1,fil);
-    MWRITE(&short_startofdynamicinterpolations,sizeof(short_startofdynamicinterpolations),1,fil);
-    MWRITE(short_oldipos,sizeof(short_oldipos),1,fil);
-    MWRITE(short_bakipos,sizeof(short_bakipos),1,fil);
-    for (i = short_numinterpolations - 1; i >= 0; i--)
-    {
-        saveisshot |= SaveSymDataInfo(fil, short_curipos[i]);
-        assert(!saveisshot);
-    }
+    // interpolations
+    WriteInterpolations(fil);
 
     // parental lock
     for (i = 0; i < (int)SIZ(otlist); i++)
@@ -982,23 +963,8 @@ bool GameInterface::LoadGame(FSaveGameNode* sv)
     MREAD(&MoveSkip4,sizeof(MoveSkip4),1,fil);
     MREAD(&MoveSkip8,sizeof(MoveSkip8),1,fil);
 
-    // long interpolations
-    MREAD(&numinterpolations,sizeof(numinterpolations),1,fil);
-    MREAD(&startofdynamicinterpolations,sizeof(startofdynamicinterpolations),1,fil);
-    MREAD(oldipos,sizeof(oldipos),1,fil);
-    MREAD(bakipos,sizeof(bakipos),1,fil);
-    for (i = numinterpolations - 1; i >= 0; i--)
-        saveisshot |= LoadSymDataInfo(fil, (void **)&curipos[i]);
-    if (saveisshot) { MCLOSE_READ(fil); return false; }
-
-    // short interpolations
-    MREAD(&short_numinterpolations,sizeof(short_numinterpolations),1,fil);
-    MREAD(&short_startofdynamicinterpolations,sizeof(short_startofdynamicinterpolations),1,fil);
-    MREAD(short_oldipos,sizeof(short_oldipos),1,fil);
-    MREAD(short_bakipos,sizeof(short_bakipos),1,fil);
-    for (i = short_numinterpolations - 1; i >= 0; i--)
-        saveisshot |= LoadSymDataInfo(fil, (void **)&short_curipos[i]);
-    if (saveisshot) { MCLOSE_READ(fil); return false; }
+    // interpolations
+    ReadInterpolations(fil);
 
     // parental lock
     for (i = 0; i < (int)SIZ(otlist); i++)
@@ -405,6 +405,7 @@ int DoSlidorMoveWalls(short SpriteNum, int amt)
                 wall[pw].x -= amt;
                 wall[wall[w].point2].x -= amt;
                 wall[wall[wall[w].point2].point2].x -= amt;
+                pvsWallMoved(w);
             }
             else
             {
@@ -429,6 +430,7 @@ int DoSlidorMoveWalls(short SpriteNum, int amt)
                 wall[pw].x += amt;
                 wall[wall[w].point2].x += amt;
                 wall[wall[wall[w].point2].point2].x += amt;
+                pvsWallMoved(w);
             }
             else
             {
@@ -452,6 +454,7 @@ int DoSlidorMoveWalls(short SpriteNum, int amt)
                 wall[pw].y -= amt;
                 wall[wall[w].point2].y -= amt;
                 wall[wall[wall[w].point2].point2].y -= amt;
+                pvsWallMoved(w);
             }
             else
             {
@@ -474,6 +477,7 @@ int DoSlidorMoveWalls(short SpriteNum, int amt)
                 wall[pw].y += amt;
                 wall[wall[w].point2].y += amt;
                 wall[wall[wall[w].point2].point2].y += amt;
+                pvsWallMoved(w);
             }
             else
             {
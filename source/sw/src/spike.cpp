@@ -32,6 +32,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 #include "tags.h"
 #include "sector.h"
 #include "sprite.h"
+#include "interp.h"
 
 BEGIN_SW_NS
 
@@ -100,9 +101,9 @@ void SetSpikeActive(short SpriteNum)
     SECTORp sectp = &sector[sp->sectnum];
 
     if (TEST(sp->cstat, CSTAT_SPRITE_YFLIP))
-        short_setinterpolation(&sectp->ceilingheinum);
+        StartInterpolation(&sectp->ceilingheinum);
     else
-        short_setinterpolation(&sectp->floorheinum);
+        StartInterpolation(&sectp->floorheinum);
 
     InterpSectorSprites(sp->sectnum, ON);
 
@@ -128,9 +129,9 @@ void SetSpikeInactive(short SpriteNum)
     SECTORp sectp = &sector[sp->sectnum];
 
     if (TEST(sp->cstat, CSTAT_SPRITE_YFLIP))
-        short_stopinterpolation(&sectp->ceilingheinum);
+        StopInterpolation(&sectp->ceilingheinum);
     else
-        short_stopinterpolation(&sectp->floorheinum);
+        StopInterpolation(&sectp->floorheinum);
 
     InterpSectorSprites(sp->sectnum, OFF);
 
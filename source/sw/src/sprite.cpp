@@ -1673,6 +1673,7 @@ void PreMapCombineFloors(void)
             {
                 wall[j].x += dx;
                 wall[j].y += dy;
+                pvsWallMoved(j);
 
                 nextsector = wall[j].nextsector;
                 if (nextsector < 0) continue;
@@ -1736,6 +1736,7 @@ MovePoints(SECTOR_OBJECTp sop, short delta_ang, int nx, int ny)
             {
                 wp->x += BOUND_4PIX(nx);
                 wp->y += BOUND_4PIX(ny);
+                pvsWallMoved(k);
             }
 
             rot_ang = delta_ang;
@@ -1759,6 +1760,7 @@ MovePoints(SECTOR_OBJECTp sop, short delta_ang, int nx, int ny)
             {
                 wp->x = rxy.x;
                 wp->y = rxy.y;
+                pvsWallMoved(k);
             }
         }
 
@@ -1994,6 +1996,7 @@ void RefreshPoints(SECTOR_OBJECTp sop, int nx, int ny, SWBOOL dynamic)
                     {
                         wp->x = dx;
                         wp->y = dy;
+                        pvsWallMoved(k);
                     }
                 }
 
@@ -2159,6 +2162,7 @@ CollapseSectorObject(SECTOR_OBJECTp sop, int nx, int ny)
                 {
                     wp->x = nx;
                     wp->y = ny;
+                    pvsWallMoved(k);
                 }
             }
         }
@@ -126,6 +126,7 @@ int DoWallMove(SPRITEp sp)
             {
                 wallp->x = sp->x + nx;
                 wallp->y = sp->y + ny;
+                pvsWallMoved(wallp - wall);
             }
 
             if (shade1)